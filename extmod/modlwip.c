@@ -241,6 +241,9 @@ typedef struct _lwip_socket_obj_t {
         struct tcp_pcb *connection;
     } incoming;
     mp_obj_t callback;
+    #if MICROPY_PY_USELECT_NOTIFY
+    mp_stream_poll_notify_t *poll_notify;
+    #endif
     byte peer[4];
     mp_uint_t peer_port;
     mp_uint_t timeout;
@@ -274,6 +277,15 @@ static inline void exec_user_callback(lwip_socket_obj_t *socket) {
     }
 }
 
+// Tell a poller that the socket may have become readable or writable.
+static inline void poll_notify(lwip_socket_obj_t *socket) {
+    #if MICROPY_PY_USELECT_NOTIFY
+    mp_stream_poll_notify(socket->poll_notify);
+    #else
+    (void)socket;
+    #endif
+}
+
 // Callback for incoming UDP packets. We simply stash the packet and the source address,
 // in case we need it for recvfrom.
 STATIC void _lwip_udp_incoming(void *arg, struct udp_pcb *upcb, struct pbuf *p, ip_addr_t *addr, u16_t port) {
@@ -286,6 +298,7 @@ STATIC void _lwip_udp_incoming(void *arg, struct udp_pcb *upcb, struct pbuf *p,
         socket->incoming.pbuf = p;
         socket->peer_port = (mp_uint_t)port;
         memcpy(&socket->peer, addr, sizeof(socket->peer));
+        poll_notify(socket);
     }
 }
 
@@ -297,6 +310,7 @@ STATIC void _lwip_tcp_error(void *arg, err_t err) {
     socket->state = err;
     // If we got here, the lwIP stack either has deallocated or will deallocate the pcb.
     socket->pcb.tcp = NULL;
+    poll_notify(socket);
 }
 
 // Callback for tcp connection requests. Error code err is unused. (See tcp.h)
@@ -304,6 +318,15 @@ STATIC err_t _lwip_tcp_connected(void *arg, struct tcp_pcb *tpcb, err_t err) {
     lwip_socket_obj_t *socket = (lwip_socket_obj_t*)arg;
 
     socket->state = STATE_CONNECTED;
+    poll_notify(socket);
+    return ERR_OK;
+}
+
+// Callback for acknowledged tcp data, which frees space in the send buffer.
+STATIC err_t _lwip_tcp_sent(void *arg, struct tcp_pcb *tpcb, u16_t len) {
+    lwip_socket_obj_t *socket = (lwip_socket_obj_t*)arg;
+
+    poll_notify(socket);
     return ERR_OK;
 }
 
@@ -339,6 +362,7 @@ STATIC err_t _lwip_tcp_accept(void *arg, struct tcp_pcb *newpcb, err_t err) {
         return ERR_BUF;
     } else {
         socket->incoming.connection = newpcb;
+        poll_notify(socket);
         if (socket->callback != MP_OBJ_NULL) {
             // Schedule accept callback to be called when lwIP is done
             // with processing this incoming connection on its side and
@@ -357,6 +381,7 @@ STATIC err_t _lwip_tcp_recv(void *arg, struct tcp_pcb *tcpb, struct pbuf *p, err
         // Other side has closed connection.
         DEBUG_printf("_lwip_tcp_recv[%p]: other side closed connection\n", socket);
         socket->state = STATE_PEER_CLOSED;
+        poll_notify(socket);
         exec_user_callback(socket);
         return ERR_OK;
     }
@@ -371,6 +396,7 @@ STATIC err_t _lwip_tcp_recv(void *arg, struct tcp_pcb *tcpb, struct pbuf *p, err
         #endif
     }
 
+    poll_notify(socket);
     exec_user_callback(socket);
 
     return ERR_OK;
@@ -380,8 +406,13 @@ STATIC err_t _lwip_tcp_recv(void *arg, struct tcp_pcb *tcpb, struct pbuf *p, err
 // Functions for socket send/receive operations. Socket send/recv and friends call
 // these to do the work.
 
-// Helper function for send/sendto to handle UDP packets.
-STATIC mp_uint_t lwip_udp_send(lwip_socket_obj_t *socket, const byte *buf, mp_uint_t len, byte *ip, mp_uint_t port, int *_errno) {
+// Helper function for send/sendto/sendmsg to handle UDP packets, made of the
+// data of n_bufs buffers.
+STATIC mp_uint_t lwip_udp_send_bufs(lwip_socket_obj_t *socket, const mp_buffer_info_t *bufs, size_t n_bufs, byte *ip, mp_uint_t port, int *_errno) {
+    mp_uint_t len = 0;
+    for (size_t i = 0; i < n_bufs; i++) {
+        len += bufs[i].len;
+    }
     if (len > 0xffff) {
         // Any packet that big is probably going to fail the pbuf_alloc anyway, but may as well try
         len = 0xffff;
@@ -394,7 +425,12 @@ STATIC mp_uint_t lwip_udp_send(lwip_socket_obj_t *socket, const byte *buf, mp_ui
         return -1;
     }
 
-    memcpy(p->payload, buf, len);
+    mp_uint_t offset = 0;
+    for (size_t i = 0; i < n_bufs && offset < len; i++) {
+        mp_uint_t chunk = MIN(bufs[i].len, len - offset);
+        memcpy((byte*)p->payload + offset, bufs[i].buf, chunk);
+        offset += chunk;
+    }
 
     err_t err;
     if (ip == NULL) {
@@ -418,6 +454,11 @@ STATIC mp_uint_t lwip_udp_send(lwip_socket_obj_t *socket, const byte *buf, mp_ui
     return len;
 }
 
+STATIC mp_uint_t lwip_udp_send(lwip_socket_obj_t *socket, const byte *buf, mp_uint_t len, byte *ip, mp_uint_t port, int *_errno) {
+    mp_buffer_info_t bufinfo = { .buf = (void*)buf, .len = len };
+    return lwip_udp_send_bufs(socket, &bufinfo, 1, ip, port, _errno);
+}
+
 // Helper function for recv/recvfrom to handle UDP packets
 STATIC mp_uint_t lwip_udp_receive(lwip_socket_obj_t *socket, byte *buf, mp_uint_t len, byte *ip, mp_uint_t *port, int *_errno) {
 
@@ -629,6 +670,9 @@ STATIC mp_obj_t lwip_socket_make_new(const mp_obj_type_t *type, size_t n_args, s
     socket->timeout = -1;
     socket->state = STATE_NEW;
     socket->recv_offset = 0;
+    #if MICROPY_PY_USELECT_NOTIFY
+    socket->poll_notify = NULL;
+    #endif
     return socket;
 }
 
@@ -663,6 +707,7 @@ STATIC mp_obj_t lwip_socket_close(mp_obj_t self_in) {
         }
         socket->incoming.pbuf = NULL;
     }
+    poll_notify(socket);
 
     return mp_const_none;
 }
@@ -769,9 +814,13 @@ STATIC mp_obj_t lwip_socket_accept(mp_obj_t self_in) {
     socket2->state = STATE_CONNECTED;
     socket2->recv_offset = 0;
     socket2->callback = MP_OBJ_NULL;
+    #if MICROPY_PY_USELECT_NOTIFY
+    socket2->poll_notify = NULL;
+    #endif
     tcp_arg(socket2->pcb.tcp, (void*)socket2);
     tcp_err(socket2->pcb.tcp, _lwip_tcp_error);
     tcp_recv(socket2->pcb.tcp, _lwip_tcp_recv);
+    tcp_sent(socket2->pcb.tcp, _lwip_tcp_sent);
 
     tcp_accepted(listener);
 
@@ -811,8 +860,9 @@ STATIC mp_obj_t lwip_socket_connect(mp_obj_t self_in, mp_obj_t addr_in) {
                     mp_raise_OSError(MP_EALREADY);
                 }
             }
-            // Register our receive callback.
+            // Register our receive and sent callbacks.
             tcp_recv(socket->pcb.tcp, _lwip_tcp_recv);
+            tcp_sent(socket->pcb.tcp, _lwip_tcp_sent);
             socket->state = STATE_CONNECTING;
             err = tcp_connect(socket->pcb.tcp, &dest, port, _lwip_tcp_connected);
             if (err != ERR_OK) {
@@ -998,6 +1048,128 @@ STATIC mp_obj_t lwip_socket_recvfrom(mp_obj_t self_in, mp_obj_t len_in) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(lwip_socket_recvfrom_obj, lwip_socket_recvfrom);
 
+// Helper function for recv_into/recvfrom_into, which take (buffer[, nbytes])
+// and receive into the buffer, or its first nbytes if that's not 0.
+STATIC mp_uint_t lwip_socket_recv_into_buf(size_t n_args, const mp_obj_t *args, byte *ip, mp_uint_t *port) {
+    lwip_socket_obj_t *socket = args[0];
+    int _errno;
+
+    lwip_socket_check_connected(socket);
+
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_WRITE);
+    if (n_args > 2) {
+        mp_int_t nbytes = mp_obj_get_int(args[2]);
+        if (nbytes < 0 || (mp_uint_t)nbytes > bufinfo.len) {
+            mp_raise_ValueError("nbytes is greater than the length of the buffer");
+        }
+        if (nbytes != 0) {
+            bufinfo.len = nbytes;
+        }
+    }
+
+    mp_uint_t ret = 0;
+    switch (socket->type) {
+        case MOD_NETWORK_SOCK_STREAM: {
+            if (ip != NULL) {
+                memcpy(ip, &socket->peer, sizeof(socket->peer));
+                *port = (mp_uint_t) socket->peer_port;
+            }
+            ret = lwip_tcp_receive(socket, bufinfo.buf, bufinfo.len, &_errno);
+            break;
+        }
+        case MOD_NETWORK_SOCK_DGRAM: {
+            ret = lwip_udp_receive(socket, bufinfo.buf, bufinfo.len, ip, port, &_errno);
+            break;
+        }
+    }
+    if (ret == -1) {
+        mp_raise_OSError(_errno);
+    }
+    return ret;
+}
+
+STATIC mp_obj_t lwip_socket_recv_into(size_t n_args, const mp_obj_t *args) {
+    return mp_obj_new_int_from_uint(lwip_socket_recv_into_buf(n_args, args, NULL, NULL));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lwip_socket_recv_into_obj, 2, 3, lwip_socket_recv_into);
+
+STATIC mp_obj_t lwip_socket_recvfrom_into(size_t n_args, const mp_obj_t *args) {
+    byte ip[4];
+    mp_uint_t port;
+    mp_obj_t tuple[2];
+    tuple[0] = mp_obj_new_int_from_uint(lwip_socket_recv_into_buf(n_args, args, ip, &port));
+    tuple[1] = netutils_format_inet_addr(ip, port, NETUTILS_BIG);
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lwip_socket_recvfrom_into_obj, 2, 3, lwip_socket_recvfrom_into);
+
+// sendmsg(buffers[, ancdata[, flags[, address]]]): sends the data of all the
+// buffers, as one packet for UDP.  Ancillary data isn't supported and flags
+// are ignored.
+STATIC mp_obj_t lwip_socket_sendmsg(size_t n_args, const mp_obj_t *args) {
+    lwip_socket_obj_t *socket = args[0];
+    int _errno;
+
+    lwip_socket_check_connected(socket);
+
+    if (n_args > 2 && mp_obj_get_int(mp_obj_len(args[2])) != 0) {
+        mp_raise_NotImplementedError("ancdata");
+    }
+
+    size_t n_bufs;
+    mp_obj_t *bufs_in;
+    mp_obj_get_array(args[1], &n_bufs, &bufs_in);
+    mp_buffer_info_t bufs_stack[4];
+    mp_buffer_info_t *bufs = bufs_stack;
+    if (n_bufs > MP_ARRAY_SIZE(bufs_stack)) {
+        bufs = m_new(mp_buffer_info_t, n_bufs);
+    }
+    for (size_t i = 0; i < n_bufs; i++) {
+        mp_get_buffer_raise(bufs_in[i], &bufs[i], MP_BUFFER_READ);
+    }
+
+    mp_uint_t ret = 0;
+    switch (socket->type) {
+        case MOD_NETWORK_SOCK_STREAM: {
+            // stop at the first buffer which isn't sent in full
+            for (size_t i = 0; i < n_bufs; i++) {
+                mp_uint_t n = lwip_tcp_send(socket, bufs[i].buf, bufs[i].len, &_errno);
+                if (n == -1) {
+                    if (ret == 0) {
+                        ret = -1;
+                    }
+                    break;
+                }
+                ret += n;
+                if (n < bufs[i].len) {
+                    break;
+                }
+            }
+            break;
+        }
+        case MOD_NETWORK_SOCK_DGRAM: {
+            if (n_args > 4 && args[4] != mp_const_none) {
+                uint8_t ip[NETUTILS_IPV4ADDR_BUFSIZE];
+                mp_uint_t port = netutils_parse_inet_addr(args[4], ip, NETUTILS_BIG);
+                ret = lwip_udp_send_bufs(socket, bufs, n_bufs, ip, port, &_errno);
+            } else {
+                ret = lwip_udp_send_bufs(socket, bufs, n_bufs, NULL, 0, &_errno);
+            }
+            break;
+        }
+    }
+    if (bufs != bufs_stack) {
+        m_del(mp_buffer_info_t, bufs, n_bufs);
+    }
+    if (ret == -1) {
+        mp_raise_OSError(_errno);
+    }
+
+    return mp_obj_new_int_from_uint(ret);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(lwip_socket_sendmsg_obj, 2, 5, lwip_socket_sendmsg);
+
 STATIC mp_obj_t lwip_socket_sendall(mp_obj_t self_in, mp_obj_t buf_in) {
     lwip_socket_obj_t *socket = self_in;
     lwip_socket_check_connected(socket);
@@ -1174,6 +1346,10 @@ STATIC mp_uint_t lwip_socket_ioctl(mp_obj_t self_in, mp_uint_t request, uintptr_
             ret |= flags & (MP_STREAM_POLL_RD | MP_STREAM_POLL_WR);
         }
 
+    #if MICROPY_PY_USELECT_NOTIFY
+    } else if (request == MP_STREAM_SET_POLL_NOTIFY || request == MP_STREAM_CLR_POLL_NOTIFY) {
+        ret = mp_stream_poll_notify_ioctl(&socket->poll_notify, request, arg);
+    #endif
     } else {
         *errcode = MP_EINVAL;
         ret = MP_STREAM_ERROR;
@@ -1193,7 +1369,10 @@ STATIC const mp_rom_map_elem_t lwip_socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_recv), MP_ROM_PTR(&lwip_socket_recv_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendto), MP_ROM_PTR(&lwip_socket_sendto_obj) },
     { MP_ROM_QSTR(MP_QSTR_recvfrom), MP_ROM_PTR(&lwip_socket_recvfrom_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recv_into), MP_ROM_PTR(&lwip_socket_recv_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvfrom_into), MP_ROM_PTR(&lwip_socket_recvfrom_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendall), MP_ROM_PTR(&lwip_socket_sendall_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendmsg), MP_ROM_PTR(&lwip_socket_sendmsg_obj) },
     { MP_ROM_QSTR(MP_QSTR_settimeout), MP_ROM_PTR(&lwip_socket_settimeout_obj) },
     { MP_ROM_QSTR(MP_QSTR_setblocking), MP_ROM_PTR(&lwip_socket_setblocking_obj) },
     { MP_ROM_QSTR(MP_QSTR_setsockopt), MP_ROM_PTR(&lwip_socket_setsockopt_obj) },
@@ -0,0 +1,367 @@
+/*
+ * This file is part of the MicroPython project, http://micropython.org/
+ *
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2026 The MicroPython contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "py/runtime.h"
+#include "py/smallint.h"
+#include "py/stream.h"
+#include "py/mphal.h"
+#include "py/builtin.h"
+#include "extmod/modutimeq.h"
+
+#if MICROPY_PY_UASYNCIO
+
+// Core of an event loop, for a Python layer to build uasyncio on.  Tasks are
+// generators (or plain callables) which the loop resumes from a run queue,
+// a utimeq of sleeping tasks and a uselect.poll object for tasks waiting on
+// streams.  What a generator yields tells the loop what to do with it next:
+//  - None: run it again after the other tasks which are ready now
+//  - an int: run it again after that many milliseconds
+//  - False: nothing, something else (eg wait_io) will schedule it
+
+#define TICKS_PERIOD MICROPY_PY_UTIME_TICKS_PERIOD
+
+typedef struct _runq_entry_t {
+    mp_obj_t callback;
+    mp_obj_t arg; // MP_OBJ_NULL to call a plain callable without arguments
+} runq_entry_t;
+
+typedef struct _mp_obj_loop_t {
+    mp_obj_base_t base;
+    mp_obj_utimeq_t *waitq;
+    // bound methods of the poll object, followed by room for their arguments
+    mp_obj_t poll_register[4];
+    mp_obj_t poll_unregister[3];
+    mp_obj_t poll_ipoll[4];
+    // id of registered stream -> 2-tuple of the reader and writer waiting on it
+    mp_map_t io_map;
+    mp_uint_t io_waiting;
+    mp_obj_t cur;
+    bool stopped;
+    mp_uint_t runq_alloc;
+    mp_uint_t runq_head;
+    mp_uint_t runq_len;
+    runq_entry_t runq[];
+} mp_obj_loop_t;
+
+STATIC mp_uint_t ticks_ms(void) {
+    return mp_hal_ticks_ms() & (TICKS_PERIOD - 1);
+}
+
+STATIC mp_int_t ticks_diff(mp_uint_t end, mp_uint_t start) {
+    return ((end - start + TICKS_PERIOD / 2) & (TICKS_PERIOD - 1)) - TICKS_PERIOD / 2;
+}
+
+STATIC void runq_push(mp_obj_loop_t *self, mp_obj_t callback, mp_obj_t arg) {
+    if (self->runq_len == self->runq_alloc) {
+        mp_raise_msg(&mp_type_IndexError, "queue overflow");
+    }
+    runq_entry_t *e = &self->runq[(self->runq_head + self->runq_len++) % self->runq_alloc];
+    e->callback = callback;
+    e->arg = arg;
+}
+
+STATIC mp_obj_t loop_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 2, 2, false);
+    mp_int_t runq_alloc = mp_obj_get_int(args[0]);
+    mp_int_t waitq_alloc = mp_obj_get_int(args[1]);
+    if (runq_alloc < 1 || waitq_alloc < 1) {
+        mp_raise_ValueError(NULL);
+    }
+    mp_obj_loop_t *self = m_new_obj_var(mp_obj_loop_t, runq_entry_t, runq_alloc);
+    self->base.type = type;
+    self->waitq = mp_utimeq_new(waitq_alloc);
+    mp_obj_t poll = mp_call_function_0(mp_load_attr(MP_OBJ_FROM_PTR(&mp_module_uselect), MP_QSTR_poll));
+    mp_load_method(poll, MP_QSTR_register, self->poll_register);
+    mp_load_method(poll, MP_QSTR_unregister, self->poll_unregister);
+    mp_load_method(poll, MP_QSTR_ipoll, self->poll_ipoll);
+    mp_map_init(&self->io_map, 0);
+    self->io_waiting = 0;
+    self->cur = MP_OBJ_NULL;
+    self->stopped = false;
+    self->runq_alloc = runq_alloc;
+    self->runq_head = 0;
+    self->runq_len = 0;
+    return MP_OBJ_FROM_PTR(self);
+}
+
+STATIC mp_obj_t loop_call_soon(size_t n_args, const mp_obj_t *args) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(args[0]);
+    runq_push(self, args[1], n_args > 2 ? args[2] : MP_OBJ_NULL);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(loop_call_soon_obj, 2, 3, loop_call_soon);
+
+STATIC mp_obj_t loop_call_later_ms(size_t n_args, const mp_obj_t *args) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_uint_t time = (ticks_ms() + mp_obj_get_int(args[1])) & (TICKS_PERIOD - 1);
+    mp_utimeq_push(self->waitq, time, args[2], n_args > 3 ? args[3] : MP_OBJ_NULL);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(loop_call_later_ms_obj, 3, 4, loop_call_later_ms);
+
+STATIC void loop_register_io(mp_obj_loop_t *self, mp_obj_t obj, mp_obj_tuple_t *waiters) {
+    mp_uint_t mask = 0;
+    if (waiters->items[0] != mp_const_none) {
+        mask |= MP_STREAM_POLL_RD;
+    }
+    if (waiters->items[1] != mp_const_none) {
+        mask |= MP_STREAM_POLL_WR;
+    }
+    self->poll_register[2] = obj;
+    self->poll_register[3] = MP_OBJ_NEW_SMALL_INT(mask);
+    mp_call_method_n_kw(2, 0, self->poll_register);
+}
+
+// wait_io(obj, event[, callback]): when obj is ready for the event (POLLIN or
+// POLLOUT) or has an error, schedule callback, by default the current task,
+// with the events that happened.  Returns False, for the task to yield.
+STATIC mp_obj_t loop_wait_io(size_t n_args, const mp_obj_t *args) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_t obj = args[1];
+    mp_uint_t event = mp_obj_get_int(args[2]);
+    mp_obj_t callback = n_args > 3 ? args[3] : self->cur;
+    if (callback == MP_OBJ_NULL) {
+        mp_raise_msg(&mp_type_RuntimeError, "no running task");
+    }
+    int idx;
+    if (event == MP_STREAM_POLL_RD) {
+        idx = 0;
+    } else if (event == MP_STREAM_POLL_WR) {
+        idx = 1;
+    } else {
+        mp_raise_ValueError(NULL);
+    }
+
+    mp_map_elem_t *elem = mp_map_lookup(&self->io_map, mp_obj_id(obj), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
+    if (elem->value == MP_OBJ_NULL) {
+        elem->value = mp_obj_new_tuple(2, NULL);
+        mp_obj_tuple_t *waiters = MP_OBJ_TO_PTR(elem->value);
+        waiters->items[0] = mp_const_none;
+        waiters->items[1] = mp_const_none;
+    }
+    mp_obj_tuple_t *waiters = MP_OBJ_TO_PTR(elem->value);
+    if (waiters->items[idx] == mp_const_none) {
+        self->io_waiting++;
+    }
+    waiters->items[idx] = callback;
+    loop_register_io(self, obj, waiters);
+    return mp_const_false;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(loop_wait_io_obj, 3, 4, loop_wait_io);
+
+// remove_io(obj): forget obj and any tasks waiting on it, eg before closing it
+STATIC mp_obj_t loop_remove_io(mp_obj_t self_in, mp_obj_t obj) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_map_elem_t *elem = mp_map_lookup(&self->io_map, mp_obj_id(obj), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+    if (elem != NULL) {
+        mp_obj_tuple_t *waiters = MP_OBJ_TO_PTR(elem->value);
+        self->io_waiting -= (waiters->items[0] != mp_const_none) + (waiters->items[1] != mp_const_none);
+        self->poll_unregister[2] = obj;
+        mp_call_method_n_kw(1, 0, self->poll_unregister);
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(loop_remove_io_obj, loop_remove_io);
+
+STATIC mp_obj_t loop_cur_task(mp_obj_t self_in) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->cur == MP_OBJ_NULL) {
+        return mp_const_none;
+    }
+    return self->cur;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(loop_cur_task_obj, loop_cur_task);
+
+STATIC mp_obj_t loop_stop(mp_obj_t self_in) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(self_in);
+    self->stopped = true;
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(loop_stop_obj, loop_stop);
+
+STATIC void loop_step(mp_obj_loop_t *self, mp_obj_t callback, mp_obj_t arg) {
+    self->cur = callback;
+    if (!MP_OBJ_IS_TYPE(callback, &mp_type_gen_instance)) {
+        nlr_buf_t nlr;
+        if (nlr_push(&nlr) == 0) {
+            if (arg == MP_OBJ_NULL) {
+                mp_call_function_0(callback);
+            } else {
+                mp_call_function_1(callback, arg);
+            }
+            nlr_pop();
+        } else {
+            // don't report the callback as current once it has raised
+            self->cur = MP_OBJ_NULL;
+            nlr_jump(nlr.ret_val);
+        }
+        self->cur = MP_OBJ_NULL;
+        return;
+    }
+
+    mp_obj_t ret;
+    mp_vm_return_kind_t kind = mp_resume(callback, arg == MP_OBJ_NULL ? mp_const_none : arg, MP_OBJ_NULL, &ret);
+    self->cur = MP_OBJ_NULL;
+    if (kind == MP_VM_RETURN_NORMAL) {
+        // task finished
+        return;
+    }
+    if (kind == MP_VM_RETURN_EXCEPTION) {
+        nlr_raise(ret);
+    }
+    if (ret == mp_const_none) {
+        runq_push(self, callback, MP_OBJ_NULL);
+    } else if (MP_OBJ_IS_SMALL_INT(ret)) {
+        mp_int_t delay = MP_OBJ_SMALL_INT_VALUE(ret);
+        if (delay < 0) {
+            delay = 0;
+        }
+        mp_utimeq_push(self->waitq, (ticks_ms() + delay) & (TICKS_PERIOD - 1), callback, MP_OBJ_NULL);
+    } else if (ret != mp_const_false) {
+        mp_raise_TypeError("bad yield value");
+    }
+}
+
+STATIC void loop_poll(mp_obj_loop_t *self, mp_int_t timeout) {
+    self->poll_ipoll[2] = MP_OBJ_NEW_SMALL_INT(timeout);
+    self->poll_ipoll[3] = MP_OBJ_NEW_SMALL_INT(1); // one-shot
+    mp_obj_t iter = mp_call_method_n_kw(2, 0, self->poll_ipoll);
+    mp_obj_t item;
+    while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_tuple_get(item, &len, &items);
+        mp_map_elem_t *elem = mp_map_lookup(&self->io_map, mp_obj_id(items[0]), MP_MAP_LOOKUP);
+        if (elem == NULL) {
+            continue;
+        }
+        mp_obj_t obj = items[0];
+        mp_obj_t ev = items[1];
+        mp_uint_t events = MP_OBJ_SMALL_INT_VALUE(ev);
+        mp_obj_tuple_t *waiters = MP_OBJ_TO_PTR(elem->value);
+        // errors wake up both the reader and the writer
+        for (int idx = 0; idx < 2; idx++) {
+            mp_uint_t other = idx == 0 ? MP_STREAM_POLL_WR : MP_STREAM_POLL_RD;
+            if ((events & ~other) != 0 && waiters->items[idx] != mp_const_none) {
+                runq_push(self, waiters->items[idx], ev);
+                waiters->items[idx] = mp_const_none;
+                self->io_waiting--;
+            }
+        }
+        // the poll object cleared the event mask after this one-shot event
+        if (waiters->items[0] != mp_const_none || waiters->items[1] != mp_const_none) {
+            loop_register_io(self, obj, waiters);
+        }
+    }
+}
+
+// run(): run tasks until there are none left to run or wait for, or stop()
+// is called
+STATIC mp_obj_t loop_run(mp_obj_t self_in) {
+    mp_obj_loop_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_obj_utimeq_t *waitq = self->waitq;
+    self->stopped = false;
+    self->cur = MP_OBJ_NULL;
+    for (;;) {
+        mp_uint_t now = ticks_ms();
+        while (waitq->len != 0 && ticks_diff(waitq->items[0].time, now) <= 0) {
+            mp_obj_t callback, arg;
+            mp_utimeq_pop(waitq, &callback, &arg);
+            runq_push(self, callback, arg);
+        }
+
+        // tasks scheduled while running these wait for the next round, so
+        // that the other queues get a turn
+        for (mp_uint_t n = self->runq_len; n != 0 && !self->stopped; n--) {
+            runq_entry_t *e = &self->runq[self->runq_head];
+            mp_obj_t callback = e->callback;
+            mp_obj_t arg = e->arg;
+            e->callback = MP_OBJ_NULL; // so we don't retain a pointer
+            e->arg = MP_OBJ_NULL;
+            self->runq_head = (self->runq_head + 1) % self->runq_alloc;
+            self->runq_len--;
+            loop_step(self, callback, arg);
+        }
+        if (self->stopped) {
+            break;
+        }
+
+        mp_int_t timeout;
+        if (self->runq_len != 0) {
+            timeout = 0;
+        } else if (waitq->len != 0) {
+            timeout = ticks_diff(waitq->items[0].time, ticks_ms());
+            if (timeout < 0) {
+                timeout = 0;
+            }
+        } else if (self->io_waiting != 0) {
+            timeout = -1;
+        } else {
+            break;
+        }
+
+        if (self->io_waiting != 0) {
+            loop_poll(self, timeout);
+        } else if (timeout > 0) {
+            mp_hal_delay_ms(timeout);
+        }
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(loop_run_obj, loop_run);
+
+STATIC const mp_rom_map_elem_t loop_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_call_soon), MP_ROM_PTR(&loop_call_soon_obj) },
+    { MP_ROM_QSTR(MP_QSTR_call_later_ms), MP_ROM_PTR(&loop_call_later_ms_obj) },
+    { MP_ROM_QSTR(MP_QSTR_wait_io), MP_ROM_PTR(&loop_wait_io_obj) },
+    { MP_ROM_QSTR(MP_QSTR_remove_io), MP_ROM_PTR(&loop_remove_io_obj) },
+    { MP_ROM_QSTR(MP_QSTR_cur_task), MP_ROM_PTR(&loop_cur_task_obj) },
+    { MP_ROM_QSTR(MP_QSTR_run), MP_ROM_PTR(&loop_run_obj) },
+    { MP_ROM_QSTR(MP_QSTR_stop), MP_ROM_PTR(&loop_stop_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(loop_locals_dict, loop_locals_dict_table);
+
+STATIC const mp_obj_type_t loop_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Loop,
+    .make_new = loop_make_new,
+    .locals_dict = (void*)&loop_locals_dict,
+};
+
+STATIC const mp_rom_map_elem_t mp_module_uasyncio_globals_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__uasyncio) },
+    { MP_ROM_QSTR(MP_QSTR_Loop), MP_ROM_PTR(&loop_type) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(mp_module_uasyncio_globals, mp_module_uasyncio_globals_table);
+
+const mp_obj_module_t mp_module_uasyncio = {
+    .base = { &mp_type_module },
+    .globals = (mp_obj_dict_t*)&mp_module_uasyncio_globals,
+};
+
+#endif // MICROPY_PY_UASYNCIO
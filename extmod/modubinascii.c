@@ -32,6 +32,48 @@
 #include "py/binary.h"
 #include "extmod/modubinascii.h"
 
+STATIC size_t binascii_hexlify_len(size_t len, bool has_sep) {
+    if (len == 0) {
+        return 0;
+    }
+    // 1-char separator between hex numbers
+    return len * 2 + (has_sep ? len - 1 : 0);
+}
+
+STATIC void binascii_hexlify_buf(byte *out, const byte *in, size_t len, const char *sep) {
+    static const char hex_digits[] = "0123456789abcdef";
+    if (sep == NULL) {
+        #if MP_ENDIANNESS_LITTLE
+        // 2 bytes at a time: spread their nibbles into the bytes of a word,
+        // and add '0' to each, and 'a' - '9' - 1 more to those above 9
+        for (; len >= 2; len -= 2) {
+            uint32_t x = in[0] >> 4 | (in[0] & 0xf) << 8 | (in[1] >> 4) << 16 | (uint32_t)(in[1] & 0xf) << 24;
+            uint32_t above9 = ((x + 0x06060606) >> 4) & 0x01010101;
+            x += 0x30303030 + above9 * ('a' - '9' - 1);
+            memcpy(out, &x, 4);
+            in += 2;
+            out += 4;
+        }
+        #endif
+        for (; len; len--) {
+            byte b = *in++;
+            out[0] = hex_digits[b >> 4];
+            out[1] = hex_digits[b & 0xf];
+            out += 2;
+        }
+        return;
+    }
+    for (; len; len--) {
+        byte b = *in++;
+        out[0] = hex_digits[b >> 4];
+        out[1] = hex_digits[b & 0xf];
+        out += 2;
+        if (len != 1) {
+            *out++ = *sep;
+        }
+    }
+}
+
 mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
     // Second argument is for an extension to allow a separator to be used
     // between values.
@@ -39,102 +81,110 @@ mp_obj_t mod_binascii_hexlify(size_t n_args, const mp_obj_t *args) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
 
-    // Code below assumes non-zero buffer length when computing size with
-    // separator, so handle the zero-length case here.
     if (bufinfo.len == 0) {
         return mp_const_empty_bytes;
     }
 
-    vstr_t vstr;
-    size_t out_len = bufinfo.len * 2;
     if (n_args > 1) {
-        // 1-char separator between hex numbers
-        out_len += bufinfo.len - 1;
         sep = mp_obj_str_get_str(args[1]);
     }
-    vstr_init_len(&vstr, out_len);
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    for (mp_uint_t i = bufinfo.len; i--;) {
-        byte d = (*in >> 4);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        d = (*in++ & 0xf);
-        if (d > 9) {
-            d += 'a' - '9' - 1;
-        }
-        *out++ = d + '0';
-        if (sep != NULL && i != 0) {
-            *out++ = *sep;
-        }
-    }
+    vstr_t vstr;
+    vstr_init_len(&vstr, binascii_hexlify_len(bufinfo.len, sep != NULL));
+    binascii_hexlify_buf((byte*)vstr.buf, bufinfo.buf, bufinfo.len, sep);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_obj, 1, 2, mod_binascii_hexlify);
 
-mp_obj_t mod_binascii_unhexlify(mp_obj_t data) {
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+// The value of hex digit ch, or a value above 15 if it isn't one
+static inline uint binascii_hex_value(byte ch) {
+    uint v = ch - '0';
+    if (v > 9) {
+        v = (ch | 0x20) - 'a' + 10;
+        if (v < 10) {
+            v = 16;
+        }
+    }
+    return v;
+}
 
-    if ((bufinfo.len & 1) != 0) {
+// out may be the same buffer as in
+STATIC void binascii_unhexlify_buf(byte *out, const byte *in, size_t len) {
+    if ((len & 1) != 0) {
         mp_raise_ValueError("odd-length string");
     }
-    vstr_t vstr;
-    vstr_init_len(&vstr, bufinfo.len / 2);
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    byte hex_byte = 0;
-    for (mp_uint_t i = bufinfo.len; i--;) {
-        byte hex_ch = *in++;
-        if (unichar_isxdigit(hex_ch)) {
-            hex_byte += unichar_xdigit_value(hex_ch);
-        } else {
+    for (; len; len -= 2) {
+        uint hi = binascii_hex_value(in[0]), lo = binascii_hex_value(in[1]);
+        if ((hi | lo) > 15) {
             mp_raise_ValueError("non-hex digit found");
         }
-        if (i & 1) {
-            hex_byte <<= 4;
-        } else {
-            *out++ = hex_byte;
-            hex_byte = 0;
-        }
+        *out++ = hi << 4 | lo;
+        in += 2;
     }
-    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
-MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_unhexlify_obj, mod_binascii_unhexlify);
 
-// If ch is a character in the base64 alphabet, and is not a pad character, then
-// the corresponding integer between 0 and 63, inclusively, is returned.
-// Otherwise, -1 is returned.
-static int mod_binascii_sextet(byte ch) {
-    if (ch >= 'A' && ch <= 'Z') {
-        return ch - 'A';
-    } else if (ch >= 'a' && ch <= 'z') {
-        return ch - 'a' + 26;
-    } else if (ch >= '0' && ch <= '9') {
-        return ch - '0' + 52;
-    } else if (ch == '+') {
-        return 62;
-    } else if (ch == '/') {
-        return 63;
-    } else {
-        return -1;
-    }
-}
-
-mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
+mp_obj_t mod_binascii_unhexlify(mp_obj_t data) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
-    byte *in = bufinfo.buf;
 
     vstr_t vstr;
-    vstr_init(&vstr, (bufinfo.len / 4) * 3 + 1); // Potentially over-allocate
-    byte *out = (byte *)vstr.buf;
+    vstr_init_len(&vstr, bufinfo.len / 2);
+    binascii_unhexlify_buf((byte*)vstr.buf, bufinfo.buf, bufinfo.len);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_unhexlify_obj, mod_binascii_unhexlify);
+
+// For each byte, its value in the base64 alphabet, or 255 if it's not in it
+// (which includes the pad character)
+STATIC const byte binascii_sextet[256] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 62, 255, 255, 255, 63,
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 255, 255, 255, 255, 255, 255,
+    255, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+    15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 255, 255, 255, 255, 255,
+    255, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+    41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+};
 
+// Decodes the base64 data in to out, which has room for out_len bytes, and
+// returns the number of bytes written; out may be the same buffer as in.
+// Groups of 4 characters from the alphabet, which is most of the input, are
+// decoded as one 24-bit word.
+STATIC size_t binascii_a2b_base64_buf(byte *out, size_t out_len, const byte *in, size_t len) {
+    const byte *end = in + len;
+    size_t n = 0;
     uint shift = 0;
     int nbits = 0; // Number of meaningful bits in shift
     bool hadpad = false; // Had a pad character since last valid character
-    for (size_t i = 0; i < bufinfo.len; i++) {
-        if (in[i] == '=') {
+    while (in < end) {
+        if (nbits == 0 && end - in >= 4) {
+            uint32_t a = binascii_sextet[in[0]], b = binascii_sextet[in[1]];
+            uint32_t c = binascii_sextet[in[2]], d = binascii_sextet[in[3]];
+            if (((a | b | c | d) & 0x80) == 0) {
+                if (out_len - n < 3) {
+                    mp_raise_ValueError("buffer too small");
+                }
+                uint32_t w = a << 18 | b << 12 | c << 6 | d;
+                out[n] = w >> 16;
+                out[n + 1] = w >> 8;
+                out[n + 2] = w;
+                n += 3;
+                in += 4;
+                hadpad = false;
+                continue;
+            }
+        }
+
+        byte ch = *in++;
+        if (ch == '=') {
             if ((nbits == 2) || ((nbits == 4) && hadpad)) {
                 nbits = 0;
                 break;
@@ -142,8 +192,8 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
             hadpad = true;
         }
 
-        int sextet = mod_binascii_sextet(in[i]);
-        if (sextet == -1) {
+        uint sextet = binascii_sextet[ch];
+        if (sextet & 0x80) {
             continue;
         }
         hadpad = false;
@@ -152,7 +202,10 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
 
         if (nbits >= 8) {
             nbits -= 8;
-            out[vstr.len++] = (shift >> nbits) & 0xFF;
+            if (n == out_len) {
+                mp_raise_ValueError("buffer too small");
+            }
+            out[n++] = (shift >> nbits) & 0xFF;
         }
     }
 
@@ -160,63 +213,115 @@ mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
         mp_raise_ValueError("incorrect padding");
     }
 
-    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+    return n;
 }
-MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj, mod_binascii_a2b_base64);
 
-mp_obj_t mod_binascii_b2a_base64(mp_obj_t data) {
+mp_obj_t mod_binascii_a2b_base64(mp_obj_t data) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
 
+    // Each character gives at most 6 bits
     vstr_t vstr;
-    vstr_init_len(&vstr, ((bufinfo.len != 0) ? (((bufinfo.len - 1) / 3) + 1) * 4 : 0) + 1);
-
-    // First pass, we convert input buffer to numeric base 64 values
-    byte *in = bufinfo.buf, *out = (byte*)vstr.buf;
-    mp_uint_t i;
-    for (i = bufinfo.len; i >= 3; i -= 3) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-        *out++ = (in[1] & 0x0F) << 2 | (in[2] & 0xC0) >> 6;
-        *out++ = in[2] & 0x3F;
+    vstr_init_len(&vstr, bufinfo.len / 4 * 3 + bufinfo.len % 4 * 3 / 4);
+    vstr.len = binascii_a2b_base64_buf((byte*)vstr.buf, vstr.len, bufinfo.buf, bufinfo.len);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_a2b_base64_obj, mod_binascii_a2b_base64);
+
+STATIC size_t binascii_b2a_base64_len(size_t len) {
+    // Padded groups of 4 characters, and a newline
+    return (len + 2) / 3 * 4 + 1;
+}
+
+// Encodes in to out, 3 bytes at a time as one 24-bit word
+STATIC void binascii_b2a_base64_buf(byte *out, const byte *in, size_t len) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    for (; len >= 3; len -= 3) {
+        uint32_t w = in[0] << 16 | in[1] << 8 | in[2];
+        out[0] = alphabet[w >> 18];
+        out[1] = alphabet[(w >> 12) & 0x3f];
+        out[2] = alphabet[(w >> 6) & 0x3f];
+        out[3] = alphabet[w & 0x3f];
         in += 3;
+        out += 4;
     }
-    if (i != 0) {
-        *out++ = (in[0] & 0xFC) >> 2;
-        if (i == 2) {
-            *out++ = (in[0] & 0x03) << 4 | (in[1] & 0xF0) >> 4;
-            *out++ = (in[1] & 0x0F) << 2;
-        }
-        else {
-            *out++ = (in[0] & 0x03) << 4;
-            *out++ = 64;
-        }
-        *out = 64;
-    }
-
-    // Second pass, we convert number base 64 values to actual base64 ascii encoding
-    out = (byte*)vstr.buf;
-    for (mp_uint_t j = vstr.len - 1; j--;) {
-        if (*out < 26) {
-            *out += 'A';
-        } else if (*out < 52) {
-            *out += 'a' - 26;
-        } else if (*out < 62) {
-            *out += '0' - 52;
-        } else if (*out == 62) {
-            *out ='+';
-        } else if (*out == 63) {
-            *out = '/';
-        } else {
-            *out = '=';
-        }
-        out++;
+    if (len != 0) {
+        uint32_t w = in[0] << 16 | (len == 2 ? in[1] << 8 : 0);
+        out[0] = alphabet[w >> 18];
+        out[1] = alphabet[(w >> 12) & 0x3f];
+        out[2] = len == 2 ? alphabet[(w >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        out += 4;
     }
     *out = '\n';
+}
+
+mp_obj_t mod_binascii_b2a_base64(mp_obj_t data) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+
+    vstr_t vstr;
+    vstr_init_len(&vstr, binascii_b2a_base64_len(bufinfo.len));
+    binascii_b2a_base64_buf((byte*)vstr.buf, bufinfo.buf, bufinfo.len);
     return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 MP_DEFINE_CONST_FUN_OBJ_1(mod_binascii_b2a_base64_obj, mod_binascii_b2a_base64);
 
+#if MICROPY_PY_UBINASCII_INTO
+// The _into variants write to the buffer given as the second argument and
+// return the number of bytes written, so that they don't allocate
+
+// Raises if the buffer out can't take len bytes, and returns where they go
+STATIC byte *binascii_get_out(mp_obj_t out, size_t len) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(out, &bufinfo, MP_BUFFER_WRITE);
+    if (bufinfo.len < len) {
+        mp_raise_ValueError("buffer too small");
+    }
+    return bufinfo.buf;
+}
+
+STATIC mp_obj_t mod_binascii_hexlify_into(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    const char *sep = NULL;
+    if (n_args > 2) {
+        sep = mp_obj_str_get_str(args[2]);
+    }
+    size_t len = binascii_hexlify_len(bufinfo.len, sep != NULL);
+    binascii_hexlify_buf(binascii_get_out(args[1], len), bufinfo.buf, bufinfo.len, sep);
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_binascii_hexlify_into_obj, 2, 3, mod_binascii_hexlify_into);
+
+STATIC mp_obj_t mod_binascii_unhexlify_into(mp_obj_t data, mp_obj_t out) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    binascii_unhexlify_buf(binascii_get_out(out, bufinfo.len / 2), bufinfo.buf, bufinfo.len);
+    return MP_OBJ_NEW_SMALL_INT(bufinfo.len / 2);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_unhexlify_into_obj, mod_binascii_unhexlify_into);
+
+STATIC mp_obj_t mod_binascii_a2b_base64_into(mp_obj_t data, mp_obj_t out) {
+    mp_buffer_info_t bufinfo, outinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    mp_get_buffer_raise(out, &outinfo, MP_BUFFER_WRITE);
+    size_t len = binascii_a2b_base64_buf(outinfo.buf, outinfo.len, bufinfo.buf, bufinfo.len);
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_a2b_base64_into_obj, mod_binascii_a2b_base64_into);
+
+STATIC mp_obj_t mod_binascii_b2a_base64_into(mp_obj_t data, mp_obj_t out) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data, &bufinfo, MP_BUFFER_READ);
+    size_t len = binascii_b2a_base64_len(bufinfo.len);
+    binascii_b2a_base64_buf(binascii_get_out(out, len), bufinfo.buf, bufinfo.len);
+    return MP_OBJ_NEW_SMALL_INT(len);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_binascii_b2a_base64_into_obj, mod_binascii_b2a_base64_into);
+#endif
+
 #if MICROPY_PY_UBINASCII_CRC32
 #include "uzlib/tinf.h"
 
@@ -238,6 +343,12 @@ STATIC const mp_rom_map_elem_t mp_module_binascii_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_unhexlify), MP_ROM_PTR(&mod_binascii_unhexlify_obj) },
     { MP_ROM_QSTR(MP_QSTR_a2b_base64), MP_ROM_PTR(&mod_binascii_a2b_base64_obj) },
     { MP_ROM_QSTR(MP_QSTR_b2a_base64), MP_ROM_PTR(&mod_binascii_b2a_base64_obj) },
+    #if MICROPY_PY_UBINASCII_INTO
+    { MP_ROM_QSTR(MP_QSTR_hexlify_into), MP_ROM_PTR(&mod_binascii_hexlify_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unhexlify_into), MP_ROM_PTR(&mod_binascii_unhexlify_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_a2b_base64_into), MP_ROM_PTR(&mod_binascii_a2b_base64_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_b2a_base64_into), MP_ROM_PTR(&mod_binascii_b2a_base64_into_obj) },
+    #endif
     #if MICROPY_PY_UBINASCII_CRC32
     { MP_ROM_QSTR(MP_QSTR_crc32), MP_ROM_PTR(&mod_binascii_crc32_obj) },
     #endif
@@ -114,30 +114,82 @@ typedef struct _mp_obj_uctypes_struct_t {
     mp_obj_t desc;
     byte *addr;
     uint32_t flags;
+    #if MICROPY_PY_UCTYPES_COMPILE
+    // objects already created for the aggregate fields of a compiled descriptor
+    mp_obj_t *agg_cache;
+    #endif
 } mp_obj_uctypes_struct_t;
 
+#if MICROPY_PY_UCTYPES_COMPILE
+
+// A compiled descriptor is a dict descriptor decoded once into a table of
+// fields sorted by name, so attribute access needn't look up the dict and
+// unpack the offset/type encoding.
+
+enum {
+    FIELD_SCALAR, FIELD_BITFIELD, FIELD_STRUCT, FIELD_AGG, FIELD_BYTEARRAY,
+};
+
+typedef struct _uctypes_field_t {
+    qstr name;
+    uint32_t offset;
+    uint8_t kind;
+    uint8_t val_type;
+    uint8_t bit_offset;
+    uint8_t bit_len;
+    uint16_t agg_index; // index in agg_cache, for aggregate fields
+    mp_obj_t sub; // descriptor of aggregate, or size of bytearray
+} uctypes_field_t;
+
+typedef struct _uctypes_compiled_t {
+    mp_obj_base_t base;
+    mp_obj_t desc; // original dict
+    size_t num_agg;
+    size_t num_fields;
+    uctypes_field_t fields[];
+} uctypes_compiled_t;
+
+STATIC const mp_obj_type_t uctypes_compiled_type;
+
+#define IS_COMPILED(desc) MP_OBJ_IS_TYPE((desc), &uctypes_compiled_type)
+
+#endif
+
 STATIC NORETURN void syntax_error(void) {
     mp_raise_TypeError("syntax error in uctypes descriptor");
 }
 
+STATIC mp_obj_t uctypes_struct_new(mp_obj_t desc, byte *addr, uint32_t flags) {
+    mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
+    o->base.type = &uctypes_struct_type;
+    o->desc = desc;
+    o->addr = addr;
+    o->flags = flags;
+    #if MICROPY_PY_UCTYPES_COMPILE
+    o->agg_cache = NULL;
+    #endif
+    return MP_OBJ_FROM_PTR(o);
+}
+
 STATIC mp_obj_t uctypes_struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)type;
     mp_arg_check_num(n_args, n_kw, 2, 3, false);
-    mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
-    o->base.type = type;
-    o->addr = (void*)(uintptr_t)mp_obj_int_get_truncated(args[0]);
-    o->desc = args[1];
-    o->flags = LAYOUT_NATIVE;
+    uint32_t flags = LAYOUT_NATIVE;
     if (n_args == 3) {
-        o->flags = mp_obj_get_int(args[2]);
+        flags = mp_obj_get_int(args[2]);
     }
-    return MP_OBJ_FROM_PTR(o);
+    return uctypes_struct_new(args[1], (void*)(uintptr_t)mp_obj_int_get_truncated(args[0]), flags);
 }
 
 STATIC void uctypes_struct_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
     mp_obj_uctypes_struct_t *self = MP_OBJ_TO_PTR(self_in);
     const char *typen = "unk";
-    if (MP_OBJ_IS_TYPE(self->desc, &mp_type_dict)) {
+    if (MP_OBJ_IS_TYPE(self->desc, &mp_type_dict)
+        #if MICROPY_PY_UCTYPES_COMPILE
+        || IS_COMPILED(self->desc)
+        #endif
+        ) {
         typen = "STRUCT";
     } else if (MP_OBJ_IS_TYPE(self->desc, &mp_type_tuple)) {
         mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->desc);
@@ -206,6 +258,11 @@ STATIC mp_uint_t uctypes_struct_agg_size(mp_obj_tuple_t *t, int layout_type, mp_
 }
 
 STATIC mp_uint_t uctypes_struct_size(mp_obj_t desc_in, int layout_type, mp_uint_t *max_field_size) {
+    #if MICROPY_PY_UCTYPES_COMPILE
+    if (IS_COMPILED(desc_in)) {
+        desc_in = ((uctypes_compiled_t*)MP_OBJ_TO_PTR(desc_in))->desc;
+    }
+    #endif
     if (!MP_OBJ_IS_TYPE(desc_in, &mp_type_dict)) {
         if (MP_OBJ_IS_TYPE(desc_in, &mp_type_tuple)) {
             return uctypes_struct_agg_size((mp_obj_tuple_t*)MP_OBJ_TO_PTR(desc_in), layout_type, max_field_size);
@@ -387,9 +444,121 @@ STATIC void set_aligned(uint val_type, void *p, mp_int_t index, mp_obj_t val) {
     }
 }
 
+// Load (if set_val is MP_OBJ_NULL) or store a scalar field at the given offset
+STATIC mp_obj_t uctypes_struct_scalar_op(mp_obj_uctypes_struct_t *self, uint val_type, mp_uint_t offset, mp_obj_t set_val) {
+    if (self->flags == LAYOUT_NATIVE) {
+        if (set_val == MP_OBJ_NULL) {
+            return get_aligned(val_type, self->addr + offset, 0);
+        } else {
+            set_aligned(val_type, self->addr + offset, 0, set_val);
+            return set_val; // just !MP_OBJ_NULL
+        }
+    } else {
+        if (set_val == MP_OBJ_NULL) {
+            return get_unaligned(val_type, self->addr + offset, self->flags);
+        } else {
+            set_unaligned(val_type, self->addr + offset, self->flags, set_val);
+            return set_val; // just !MP_OBJ_NULL
+        }
+    }
+}
+
+// Load (if set_val is MP_OBJ_NULL) or store a bitfield in the word at the given offset
+STATIC mp_obj_t uctypes_struct_bitfield_op(mp_obj_uctypes_struct_t *self, uint val_type, mp_uint_t offset,
+    uint bit_offset, uint bit_len, mp_obj_t set_val) {
+    mp_uint_t val;
+    if (self->flags == LAYOUT_NATIVE) {
+        val = get_aligned_basic(val_type & 6, self->addr + offset);
+    } else {
+        val = mp_binary_get_int(GET_SCALAR_SIZE(val_type & 7), val_type & 1, self->flags, self->addr + offset);
+    }
+    if (set_val == MP_OBJ_NULL) {
+        val >>= bit_offset;
+        val &= (1 << bit_len) - 1;
+        // TODO: signed
+        assert((val_type & 1) == 0);
+        return mp_obj_new_int(val);
+    } else {
+        mp_uint_t set_val_int = (mp_uint_t)mp_obj_get_int(set_val);
+        mp_uint_t mask = (1 << bit_len) - 1;
+        set_val_int &= mask;
+        set_val_int <<= bit_offset;
+        mask <<= bit_offset;
+        val = (val & ~mask) | set_val_int;
+
+        if (self->flags == LAYOUT_NATIVE) {
+            set_aligned_basic(val_type & 6, self->addr + offset, val);
+        } else {
+            mp_binary_set_int(GET_SCALAR_SIZE(val_type & 7), self->flags == LAYOUT_BIG_ENDIAN,
+                self->addr + offset, val);
+        }
+        return set_val; // just !MP_OBJ_NULL
+    }
+}
+
+#if MICROPY_PY_UCTYPES_COMPILE
+
+STATIC mp_obj_t uctypes_compiled_attr_op(mp_obj_uctypes_struct_t *self, qstr attr, mp_obj_t set_val) {
+    uctypes_compiled_t *desc = MP_OBJ_TO_PTR(self->desc);
+
+    // binary search for the field, the table is sorted by qstr
+    const uctypes_field_t *field = NULL;
+    size_t lo = 0, hi = desc->num_fields;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        if (desc->fields[mid].name == attr) {
+            field = &desc->fields[mid];
+            break;
+        } else if (desc->fields[mid].name < attr) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (field == NULL) {
+        nlr_raise(mp_obj_new_exception_arg1(&mp_type_KeyError, MP_OBJ_NEW_QSTR(attr)));
+    }
+
+    switch (field->kind) {
+        case FIELD_SCALAR:
+            return uctypes_struct_scalar_op(self, field->val_type, field->offset, set_val);
+        case FIELD_BITFIELD:
+            return uctypes_struct_bitfield_op(self, field->val_type, field->offset,
+                field->bit_offset, field->bit_len, set_val);
+    }
+
+    if (set_val != MP_OBJ_NULL) {
+        // Cannot assign to aggregate
+        syntax_error();
+    }
+
+    // Objects for aggregate fields are views which only depend on the address
+    // and layout of this struct, so they are created once and then reused
+    if (self->agg_cache == NULL) {
+        self->agg_cache = m_new0(mp_obj_t, desc->num_agg);
+    }
+    mp_obj_t *cached = &self->agg_cache[field->agg_index];
+    if (*cached == MP_OBJ_NULL) {
+        if (field->kind == FIELD_BYTEARRAY) {
+            *cached = mp_obj_new_bytearray_by_ref(MP_OBJ_SMALL_INT_VALUE(field->sub), self->addr + field->offset);
+        } else {
+            *cached = uctypes_struct_new(field->sub, self->addr + field->offset, self->flags);
+        }
+    }
+    return *cached;
+}
+
+#endif
+
 STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set_val) {
     mp_obj_uctypes_struct_t *self = MP_OBJ_TO_PTR(self_in);
 
+    #if MICROPY_PY_UCTYPES_COMPILE
+    if (IS_COMPILED(self->desc)) {
+        return uctypes_compiled_attr_op(self, attr, set_val);
+    }
+    #endif
+
     // TODO: Support at least OrderedDict in addition
     if (!MP_OBJ_IS_TYPE(self->desc, &mp_type_dict)) {
             mp_raise_TypeError("struct: no fields");
@@ -404,53 +573,12 @@ STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set
 
         if (val_type <= INT64 || val_type == FLOAT32 || val_type == FLOAT64) {
 //            printf("size=%d\n", GET_SCALAR_SIZE(val_type));
-            if (self->flags == LAYOUT_NATIVE) {
-                if (set_val == MP_OBJ_NULL) {
-                    return get_aligned(val_type, self->addr + offset, 0);
-                } else {
-                    set_aligned(val_type, self->addr + offset, 0, set_val);
-                    return set_val; // just !MP_OBJ_NULL
-                }
-            } else {
-                if (set_val == MP_OBJ_NULL) {
-                    return get_unaligned(val_type, self->addr + offset, self->flags);
-                } else {
-                    set_unaligned(val_type, self->addr + offset, self->flags, set_val);
-                    return set_val; // just !MP_OBJ_NULL
-                }
-            }
+            return uctypes_struct_scalar_op(self, val_type, offset, set_val);
         } else if (val_type >= BFUINT8 && val_type <= BFINT32) {
             uint bit_offset = (offset >> 17) & 31;
             uint bit_len = (offset >> 22) & 31;
             offset &= (1 << 17) - 1;
-            mp_uint_t val;
-            if (self->flags == LAYOUT_NATIVE) {
-                val = get_aligned_basic(val_type & 6, self->addr + offset);
-            } else {
-                val = mp_binary_get_int(GET_SCALAR_SIZE(val_type & 7), val_type & 1, self->flags, self->addr + offset);
-            }
-            if (set_val == MP_OBJ_NULL) {
-                val >>= bit_offset;
-                val &= (1 << bit_len) - 1;
-                // TODO: signed
-                assert((val_type & 1) == 0);
-                return mp_obj_new_int(val);
-            } else {
-                mp_uint_t set_val_int = (mp_uint_t)mp_obj_get_int(set_val);
-                mp_uint_t mask = (1 << bit_len) - 1;
-                set_val_int &= mask;
-                set_val_int <<= bit_offset;
-                mask <<= bit_offset;
-                val = (val & ~mask) | set_val_int;
-
-                if (self->flags == LAYOUT_NATIVE) {
-                    set_aligned_basic(val_type & 6, self->addr + offset, val);
-                } else {
-                    mp_binary_set_int(GET_SCALAR_SIZE(val_type & 7), self->flags == LAYOUT_BIG_ENDIAN,
-                        self->addr + offset, val);
-                }
-                return set_val; // just !MP_OBJ_NULL
-            }
+            return uctypes_struct_bitfield_op(self, val_type, offset, bit_offset, bit_len, set_val);
         }
 
         assert(0);
@@ -473,14 +601,8 @@ STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set
 //printf("agg type=%d offset=%x\n", agg_type, offset);
 
     switch (agg_type) {
-        case STRUCT: {
-            mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
-            o->base.type = &uctypes_struct_type;
-            o->desc = sub->items[1];
-            o->addr = self->addr + offset;
-            o->flags = self->flags;
-            return MP_OBJ_FROM_PTR(o);
-        }
+        case STRUCT:
+            return uctypes_struct_new(sub->items[1], self->addr + offset, self->flags);
         case ARRAY: {
             mp_uint_t dummy;
             if (IS_SCALAR_ARRAY(sub) && IS_SCALAR_ARRAY_OF_BYTES(sub)) {
@@ -488,15 +610,9 @@ STATIC mp_obj_t uctypes_struct_attr_op(mp_obj_t self_in, qstr attr, mp_obj_t set
             }
             // Fall thru to return uctypes struct object
         }
-        case PTR: {
-            mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
-            o->base.type = &uctypes_struct_type;
-            o->desc = MP_OBJ_FROM_PTR(sub);
-            o->addr = self->addr + offset;
-            o->flags = self->flags;
-//printf("PTR/ARR base addr=%p\n", o->addr);
-            return MP_OBJ_FROM_PTR(o);
-        }
+        case PTR:
+//printf("PTR/ARR base addr=%p\n", self->addr + offset);
+            return uctypes_struct_new(MP_OBJ_FROM_PTR(sub), self->addr + offset, self->flags);
     }
 
     // Should be unreachable once all cases are handled
@@ -563,12 +679,7 @@ STATIC mp_obj_t uctypes_struct_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_ob
             } else if (value == MP_OBJ_SENTINEL) {
                 mp_uint_t dummy = 0;
                 mp_uint_t size = uctypes_struct_size(t->items[2], self->flags, &dummy);
-                mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
-                o->base.type = &uctypes_struct_type;
-                o->desc = t->items[2];
-                o->addr = self->addr + size * index;
-                o->flags = self->flags;
-                return MP_OBJ_FROM_PTR(o);
+                return uctypes_struct_new(t->items[2], self->addr + size * index, self->flags);
             } else {
                 return MP_OBJ_NULL; // op not supported
             }
@@ -581,12 +692,7 @@ STATIC mp_obj_t uctypes_struct_subscr(mp_obj_t self_in, mp_obj_t index_in, mp_ob
             } else {
                 mp_uint_t dummy = 0;
                 mp_uint_t size = uctypes_struct_size(t->items[1], self->flags, &dummy);
-                mp_obj_uctypes_struct_t *o = m_new_obj(mp_obj_uctypes_struct_t);
-                o->base.type = &uctypes_struct_type;
-                o->desc = t->items[1];
-                o->addr = p + size * index;
-                o->flags = self->flags;
-                return MP_OBJ_FROM_PTR(o);
+                return uctypes_struct_new(t->items[1], p + size * index, self->flags);
             }
         }
 
@@ -635,6 +741,103 @@ STATIC mp_obj_t uctypes_struct_bytes_at(mp_obj_t ptr, mp_obj_t size) {
 }
 MP_DEFINE_CONST_FUN_OBJ_2(uctypes_struct_bytes_at_obj, uctypes_struct_bytes_at);
 
+#if MICROPY_PY_UCTYPES_COMPILE
+
+/// \function compile()
+/// Decode a structure descriptor (a dict) into a form which is faster to
+/// access fields through. The result can be passed to struct() in place of
+/// the descriptor. Nested structure descriptors are compiled as well.
+STATIC mp_obj_t uctypes_compile(mp_obj_t desc_in) {
+    if (IS_COMPILED(desc_in)) {
+        return desc_in;
+    }
+    if (!MP_OBJ_IS_TYPE(desc_in, &mp_type_dict)) {
+        syntax_error();
+    }
+    mp_map_t *map = &((mp_obj_dict_t*)MP_OBJ_TO_PTR(desc_in))->map;
+
+    uctypes_compiled_t *o = m_new_obj_var(uctypes_compiled_t, uctypes_field_t, map->used);
+    o->base.type = &uctypes_compiled_type;
+    o->desc = desc_in;
+    o->num_agg = 0;
+    o->num_fields = 0;
+
+    for (size_t i = 0; i < map->alloc; i++) {
+        if (!MP_MAP_SLOT_IS_FILLED(map, i)) {
+            continue;
+        }
+        if (!MP_OBJ_IS_QSTR(map->table[i].key)) {
+            syntax_error();
+        }
+        uctypes_field_t *field = &o->fields[o->num_fields++];
+        field->name = MP_OBJ_QSTR_VALUE(map->table[i].key);
+        mp_obj_t v = map->table[i].value;
+
+        if (MP_OBJ_IS_SMALL_INT(v)) {
+            mp_uint_t offset = MP_OBJ_SMALL_INT_VALUE(v);
+            mp_uint_t val_type = GET_TYPE(offset, VAL_TYPE_BITS);
+            offset &= VALUE_MASK(VAL_TYPE_BITS);
+            field->val_type = val_type;
+            if (val_type >= BFUINT8 && val_type <= BFINT32) {
+                field->kind = FIELD_BITFIELD;
+                field->bit_offset = (offset >> 17) & 31;
+                field->bit_len = (offset >> 22) & 31;
+                offset &= (1 << 17) - 1;
+            } else {
+                field->kind = FIELD_SCALAR;
+            }
+            field->offset = offset;
+            continue;
+        }
+
+        if (!MP_OBJ_IS_TYPE(v, &mp_type_tuple)) {
+            syntax_error();
+        }
+        mp_obj_tuple_t *sub = MP_OBJ_TO_PTR(v);
+        mp_int_t offset = MP_OBJ_SMALL_INT_VALUE(sub->items[0]);
+        mp_uint_t agg_type = GET_TYPE(offset, AGG_TYPE_BITS);
+        field->offset = offset & VALUE_MASK(AGG_TYPE_BITS);
+        field->agg_index = o->num_agg++;
+        if (agg_type == STRUCT) {
+            field->kind = FIELD_STRUCT;
+            field->sub = uctypes_compile(sub->items[1]);
+        } else if (agg_type == ARRAY && IS_SCALAR_ARRAY(sub) && IS_SCALAR_ARRAY_OF_BYTES(sub)) {
+            mp_uint_t dummy = 0;
+            field->kind = FIELD_BYTEARRAY;
+            field->sub = MP_OBJ_NEW_SMALL_INT(uctypes_struct_agg_size(sub, LAYOUT_NATIVE, &dummy));
+        } else {
+            field->kind = FIELD_AGG;
+            field->sub = v;
+        }
+    }
+
+    // sort the fields by name, for lookup by binary search
+    for (size_t i = 1; i < o->num_fields; i++) {
+        uctypes_field_t f = o->fields[i];
+        size_t j = i;
+        for (; j > 0 && o->fields[j - 1].name > f.name; j--) {
+            o->fields[j] = o->fields[j - 1];
+        }
+        o->fields[j] = f;
+    }
+
+    return MP_OBJ_FROM_PTR(o);
+}
+MP_DEFINE_CONST_FUN_OBJ_1(uctypes_compile_obj, uctypes_compile);
+
+STATIC void uctypes_compiled_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
+    (void)kind;
+    uctypes_compiled_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_printf(print, "<compiled descriptor with %u fields>", (uint)self->num_fields);
+}
+
+STATIC const mp_obj_type_t uctypes_compiled_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_descriptor,
+    .print = uctypes_compiled_print,
+};
+
+#endif // MICROPY_PY_UCTYPES_COMPILE
 
 STATIC const mp_obj_type_t uctypes_struct_type = {
     { &mp_type_type },
@@ -653,6 +856,9 @@ STATIC const mp_rom_map_elem_t mp_module_uctypes_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_addressof), MP_ROM_PTR(&uctypes_struct_addressof_obj) },
     { MP_ROM_QSTR(MP_QSTR_bytes_at), MP_ROM_PTR(&uctypes_struct_bytes_at_obj) },
     { MP_ROM_QSTR(MP_QSTR_bytearray_at), MP_ROM_PTR(&uctypes_struct_bytearray_at_obj) },
+    #if MICROPY_PY_UCTYPES_COMPILE
+    { MP_ROM_QSTR(MP_QSTR_compile), MP_ROM_PTR(&uctypes_compile_obj) },
+    #endif
 
     /// \moduleref uctypes
 
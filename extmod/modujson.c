@@ -25,79 +25,237 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 
 #include "py/objlist.h"
-#include "py/objstringio.h"
+#include "py/objstr.h"
 #include "py/parsenum.h"
 #include "py/runtime.h"
+#include "py/stackctrl.h"
 #include "py/stream.h"
 
 #if MICROPY_PY_UJSON
 
-STATIC mp_obj_t mod_ujson_dumps(mp_obj_t obj) {
+// Prints obj as JSON.  Exact lists, tuples and dicts, and the primitive values
+// in them, are handled here directly; anything else is printed by its type.
+STATIC void ujson_print(const mp_print_t *print, mp_obj_t obj) {
+    MP_STACK_CHECK();
+    if (MP_OBJ_IS_SMALL_INT(obj)) {
+        char buf[sizeof(mp_int_t) * 3 + 2];
+        char *end = buf + sizeof(buf);
+        char *b = end;
+        mp_int_t val = MP_OBJ_SMALL_INT_VALUE(obj);
+        mp_uint_t u = val < 0 ? -(mp_uint_t)val : (mp_uint_t)val;
+        do {
+            *--b = '0' + u % 10;
+            u /= 10;
+        } while (u != 0);
+        if (val < 0) {
+            *--b = '-';
+        }
+        print->print_strn(print->data, b, end - b);
+    } else if (MP_OBJ_IS_STR(obj)) {
+        GET_STR_DATA_LEN(obj, str_data, str_len);
+        mp_str_print_json(print, str_data, str_len);
+    } else if (obj == mp_const_none) {
+        mp_print_str(print, "null");
+    } else if (obj == mp_const_true) {
+        mp_print_str(print, "true");
+    } else if (obj == mp_const_false) {
+        mp_print_str(print, "false");
+    } else if (MP_OBJ_IS_TYPE(obj, &mp_type_list) || MP_OBJ_IS_TYPE(obj, &mp_type_tuple)) {
+        size_t len;
+        mp_obj_t *items;
+        mp_obj_get_array(obj, &len, &items);
+        mp_print_str(print, "[");
+        for (size_t i = 0; i < len; i++) {
+            if (i > 0) {
+                mp_print_str(print, ", ");
+            }
+            ujson_print(print, items[i]);
+        }
+        mp_print_str(print, "]");
+    } else if (MP_OBJ_IS_TYPE(obj, &mp_type_dict)) {
+        mp_map_t *map = mp_obj_dict_get_map(obj);
+        bool first = true;
+        mp_print_str(print, "{");
+        for (size_t i = 0; i < map->alloc; i++) {
+            if (MP_MAP_SLOT_IS_FILLED(map, i)) {
+                if (!first) {
+                    mp_print_str(print, ", ");
+                }
+                first = false;
+                ujson_print(print, map->table[i].key);
+                mp_print_str(print, ": ");
+                ujson_print(print, map->table[i].value);
+            }
+        }
+        mp_print_str(print, "}");
+    } else {
+        mp_obj_print_helper(print, obj, PRINT_JSON);
+    }
+}
+
+typedef struct _ujson_dump_t {
+    mp_obj_t stream_obj;
+    size_t len;
+    byte buf[MICROPY_PY_UJSON_WRITE_BUF_SIZE];
+} ujson_dump_t;
+
+STATIC void ujson_dump_write(mp_obj_t stream_obj, const void *buf, size_t len) {
+    int errcode;
+    mp_stream_write_exactly(stream_obj, buf, len, &errcode);
+    if (errcode != 0) {
+        mp_raise_OSError(errcode);
+    }
+}
+
+// Collects output in the write buffer, so the stream is written in chunks
+// rather than a call per token.  Output that doesn't fit is written directly.
+STATIC void ujson_dump_strn(void *data, const char *str, size_t len) {
+    ujson_dump_t *d = data;
+    if (d->len + len > sizeof(d->buf)) {
+        ujson_dump_write(d->stream_obj, d->buf, d->len);
+        d->len = 0;
+        if (len >= sizeof(d->buf)) {
+            ujson_dump_write(d->stream_obj, str, len);
+            return;
+        }
+    }
+    memcpy(d->buf + d->len, str, len);
+    d->len += len;
+}
+
+STATIC mp_obj_t mod_ujson_dump(mp_obj_t obj, mp_obj_t stream_obj) {
+    mp_get_stream_raise(stream_obj, MP_STREAM_OP_WRITE);
+    ujson_dump_t d;
+    d.stream_obj = stream_obj;
+    d.len = 0;
+    mp_print_t print = {&d, ujson_dump_strn};
+    ujson_print(&print, obj);
+    ujson_dump_write(stream_obj, d.buf, d.len);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_ujson_dump_obj, mod_ujson_dump);
+
+typedef struct _ujson_dumps_t {
     vstr_t vstr;
-    mp_print_t print;
-    vstr_init_print(&vstr, 8, &print);
-    mp_obj_print_helper(&print, obj, PRINT_JSON);
-    return mp_obj_new_str_from_vstr(&mp_type_str, &vstr);
+    bool grow_exact;
+} ujson_dumps_t;
+
+// Grows the vstr geometrically, rather than by just what is needed, so a
+// large document isn't reallocated (and possibly copied) for every token.
+// Once the heap can't spare that much, the vstr grows by what is needed.
+STATIC void ujson_dumps_strn(void *data, const char *str, size_t len) {
+    ujson_dumps_t *d = data;
+    vstr_t *vstr = &d->vstr;
+    if (vstr->len + len > vstr->alloc && !d->grow_exact) {
+        size_t new_alloc = vstr->alloc * 2 + len;
+        char *new_buf = m_renew_maybe(char, vstr->buf, vstr->alloc, new_alloc, true);
+        if (new_buf != NULL) {
+            vstr->buf = new_buf;
+            vstr->alloc = new_alloc;
+        } else {
+            d->grow_exact = true;
+        }
+    }
+    vstr_add_strn(vstr, str, len);
 }
-STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
 
-// The function below implements a simple non-recursive JSON parser.
-//
-// The JSON specification is at http://www.ietf.org/rfc/rfc4627.txt
-// The parser here will parse any valid JSON and return the correct
-// corresponding Python object.  It allows through a superset of JSON, since
-// it treats commas and colons as "whitespace", and doesn't care if
-// brackets/braces are correctly paired.  It will raise a ValueError if the
-// input is outside it's specs.
-//
-// Most of the work is parsing the primitives (null, false, true, numbers,
-// strings).  It does 1 pass over the input stream.  It tries to be fast and
-// small in code size, while not using more RAM than necessary.
+STATIC mp_obj_t mod_ujson_dumps(mp_obj_t obj) {
+    ujson_dumps_t d;
+    vstr_init(&d.vstr, 16);
+    d.grow_exact = false;
+    mp_print_t print = {&d, ujson_dumps_strn};
+    ujson_print(&print, obj);
+    return mp_obj_new_str_from_vstr(&mp_type_str, &d.vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_dumps_obj, mod_ujson_dumps);
 
 typedef struct _ujson_stream_t {
     mp_obj_t stream_obj;
     mp_uint_t (*read)(mp_obj_t obj, void *buf, mp_uint_t size, int *errcode);
-    int errcode;
+    const byte *pos;
+    const byte *end;
     byte cur;
+    byte buf[MICROPY_PY_UJSON_READ_BUF_SIZE];
 } ujson_stream_t;
 
 #define S_EOF (0) // null is not allowed in json stream so is ok as EOF marker
-#define S_END(s) ((s).cur == S_EOF)
-#define S_CUR(s) ((s).cur)
-#define S_NEXT(s) (ujson_stream_next(&(s)))
+#define S_END(s) ((s)->cur == S_EOF)
+#define S_CUR(s) ((s)->cur)
+#define S_NEXT(s) ((s)->pos < (s)->end ? ((s)->cur = *(s)->pos++) : ujson_stream_next(s))
 
+// Refills the read buffer, so the stream is read in chunks rather than a call
+// per character.  A stream without a read function is just the bytes in pos..end.
 STATIC byte ujson_stream_next(ujson_stream_t *s) {
-    mp_uint_t ret = s->read(s->stream_obj, &s->cur, 1, &s->errcode);
-    if (s->errcode != 0) {
-        mp_raise_OSError(s->errcode);
+    if (s->read == NULL) {
+        s->cur = S_EOF;
+        return S_EOF;
+    }
+    int errcode;
+    mp_uint_t ret = s->read(s->stream_obj, s->buf, sizeof(s->buf), &errcode);
+    if (ret == MP_STREAM_ERROR) {
+        mp_raise_OSError(errcode);
     }
     if (ret == 0) {
+        s->read = NULL;
         s->cur = S_EOF;
+        return S_EOF;
     }
+    s->pos = s->buf + 1;
+    s->end = s->buf + ret;
+    s->cur = s->buf[0];
     return s->cur;
 }
 
-STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
-    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream_obj, MP_STREAM_OP_READ);
-    ujson_stream_t s = {stream_obj, stream_p->read, 0, 0};
-    vstr_t vstr;
-    vstr_init(&vstr, 8);
-    mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
-    stack.len = 0;
-    stack.items = NULL;
-    mp_obj_t stack_top = MP_OBJ_NULL;
-    mp_obj_type_t *stack_top_type = NULL;
-    mp_obj_t stack_key = MP_OBJ_NULL;
+// obj is a stream, or also a str or bytes object if allow_str is true
+STATIC void ujson_stream_init(ujson_stream_t *s, mp_obj_t obj, bool allow_str) {
+    s->stream_obj = obj;
+    if (allow_str && MP_OBJ_IS_STR_OR_BYTES(obj)) {
+        size_t len;
+        s->pos = (const byte*)mp_obj_str_get_data(obj, &len);
+        s->end = s->pos + len;
+        s->read = NULL;
+    } else {
+        s->pos = s->end = NULL;
+        s->read = mp_get_stream_raise(obj, MP_STREAM_OP_READ)->read;
+    }
     S_NEXT(s);
+}
+
+STATIC NORETURN void ujson_syntax_error(void) {
+    mp_raise_ValueError("syntax error in JSON");
+}
+
+// The functions below implement a simple non-recursive JSON parser.
+//
+// The JSON specification is at http://www.ietf.org/rfc/rfc4627.txt
+// The parser here will parse any valid JSON and return the correct
+// corresponding Python object.  It allows through a superset of JSON, since
+// it treats commas and colons as "whitespace", and doesn't care if
+// brackets/braces are correctly paired.  It will raise a ValueError if the
+// input is outside it's specs.
+//
+// Most of the work is parsing the primitives (null, false, true, numbers,
+// strings).  It does 1 pass over the input stream.  It tries to be fast and
+// small in code size, while not using more RAM than necessary.
+
+enum {
+    UJSON_TOK_EOF,
+    UJSON_TOK_VALUE,
+    UJSON_TOK_LIST,
+    UJSON_TOK_DICT,
+    UJSON_TOK_END,
+};
+
+// Reads the next token.  For a primitive it returns UJSON_TOK_VALUE, with the
+// value in *value if build is true; otherwise the primitive is only checked.
+STATIC int ujson_next_token(ujson_stream_t *s, vstr_t *vstr, bool build, mp_obj_t *value) {
     for (;;) {
-        cont:
         if (S_END(s)) {
-            break;
+            return UJSON_TOK_EOF;
         }
-        mp_obj_t next = MP_OBJ_NULL;
-        bool enter = false;
         byte cur = S_CUR(s);
         S_NEXT(s);
         switch (cur) {
@@ -107,33 +265,30 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
             case '\t':
             case '\n':
             case '\r':
-                goto cont;
+                continue;
             case 'n':
                 if (S_CUR(s) == 'u' && S_NEXT(s) == 'l' && S_NEXT(s) == 'l') {
                     S_NEXT(s);
-                    next = mp_const_none;
-                } else {
-                    goto fail;
+                    *value = mp_const_none;
+                    return UJSON_TOK_VALUE;
                 }
-                break;
+                ujson_syntax_error();
             case 'f':
                 if (S_CUR(s) == 'a' && S_NEXT(s) == 'l' && S_NEXT(s) == 's' && S_NEXT(s) == 'e') {
                     S_NEXT(s);
-                    next = mp_const_false;
-                } else {
-                    goto fail;
+                    *value = mp_const_false;
+                    return UJSON_TOK_VALUE;
                 }
-                break;
+                ujson_syntax_error();
             case 't':
                 if (S_CUR(s) == 'r' && S_NEXT(s) == 'u' && S_NEXT(s) == 'e') {
                     S_NEXT(s);
-                    next = mp_const_true;
-                } else {
-                    goto fail;
+                    *value = mp_const_true;
+                    return UJSON_TOK_VALUE;
                 }
-                break;
+                ujson_syntax_error();
             case '"':
-                vstr_reset(&vstr);
+                vstr_reset(vstr);
                 for (; !S_END(s) && S_CUR(s) != '"';) {
                     byte c = S_CUR(s);
                     if (c == '\\') {
@@ -153,27 +308,33 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                                     }
                                     num = (num << 4) | c;
                                 }
-                                vstr_add_char(&vstr, num);
+                                if (build) {
+                                    vstr_add_char(vstr, num);
+                                }
                                 goto str_cont;
                             }
                         }
                     }
-                    vstr_add_byte(&vstr, c);
+                    if (build) {
+                        vstr_add_byte(vstr, c);
+                    }
                 str_cont:
                     S_NEXT(s);
                 }
                 if (S_END(s)) {
-                    goto fail;
+                    ujson_syntax_error();
                 }
                 S_NEXT(s);
-                next = mp_obj_new_str(vstr.buf, vstr.len, false);
-                break;
+                if (build) {
+                    *value = mp_obj_new_str(vstr->buf, vstr->len, false);
+                }
+                return UJSON_TOK_VALUE;
             case '-':
             case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9': {
                 bool flt = false;
-                vstr_reset(&vstr);
+                vstr_reset(vstr);
                 for (;;) {
-                    vstr_add_byte(&vstr, cur);
+                    vstr_add_byte(vstr, cur);
                     cur = S_CUR(s);
                     if (cur == '.' || cur == 'E' || cur == 'e') {
                         flt = true;
@@ -184,45 +345,74 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                     }
                     S_NEXT(s);
                 }
-                if (flt) {
-                    next = mp_parse_num_decimal(vstr.buf, vstr.len, false, false, NULL);
+                if (!build) {
+                    // pass
+                } else if (flt) {
+                    *value = mp_parse_num_decimal(vstr->buf, vstr->len, false, false, NULL);
                 } else {
-                    next = mp_parse_num_integer(vstr.buf, vstr.len, 10, NULL);
+                    *value = mp_parse_num_integer(vstr->buf, vstr->len, 10, NULL);
                 }
-                break;
+                return UJSON_TOK_VALUE;
             }
             case '[':
+                return UJSON_TOK_LIST;
+            case '{':
+                return UJSON_TOK_DICT;
+            case '}':
+            case ']':
+                return UJSON_TOK_END;
+            default:
+                ujson_syntax_error();
+        }
+    }
+}
+
+// Builds the complete value that starts with token tok (and value, for a
+// primitive), reading the rest of it from the stream.
+STATIC mp_obj_t ujson_build(ujson_stream_t *s, vstr_t *vstr, int tok, mp_obj_t value) {
+    mp_obj_list_t stack; // we use a list as a simple stack for nested JSON
+    stack.len = 0;
+    stack.items = NULL;
+    mp_obj_t stack_top = MP_OBJ_NULL;
+    mp_obj_type_t *stack_top_type = NULL;
+    mp_obj_t stack_key = MP_OBJ_NULL;
+    for (;;) {
+        mp_obj_t next;
+        bool enter = false;
+        switch (tok) {
+            case UJSON_TOK_VALUE:
+                next = value;
+                break;
+            case UJSON_TOK_LIST:
                 next = mp_obj_new_list(0, NULL);
                 enter = true;
                 break;
-            case '{':
+            case UJSON_TOK_DICT:
                 next = mp_obj_new_dict(0);
                 enter = true;
                 break;
-            case '}':
-            case ']': {
+            case UJSON_TOK_END:
                 if (stack_top == MP_OBJ_NULL) {
                     // no object at all
-                    goto fail;
+                    ujson_syntax_error();
                 }
                 if (stack.len == 0) {
                     // finished; compound object
-                    goto success;
+                    return stack_top;
                 }
                 stack.len -= 1;
                 stack_top = stack.items[stack.len];
                 stack_top_type = mp_obj_get_type(stack_top);
-                goto cont;
-            }
+                goto next_tok;
             default:
-                goto fail;
+                ujson_syntax_error();
         }
         if (stack_top == MP_OBJ_NULL) {
             stack_top = next;
             stack_top_type = mp_obj_get_type(stack_top);
             if (!enter) {
                 // finished; single primitive only
-                goto success;
+                return stack_top;
             }
         } else {
             // append to list or dict
@@ -232,7 +422,7 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                 if (stack_key == MP_OBJ_NULL) {
                     stack_key = next;
                     if (enter) {
-                        goto fail;
+                        ujson_syntax_error();
                     }
                 } else {
                     mp_obj_dict_store(stack_top, stack_key, next);
@@ -250,42 +440,247 @@ STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
                 stack_top_type = mp_obj_get_type(stack_top);
             }
         }
+    next_tok:
+        tok = ujson_next_token(s, vstr, true, &value);
     }
-    success:
-    // eat trailing whitespace
+}
+
+// Checks that only whitespace is left after the document
+STATIC void ujson_check_end(ujson_stream_t *s) {
     while (unichar_isspace(S_CUR(s))) {
         S_NEXT(s);
     }
     if (!S_END(s)) {
         // unexpected chars
-        goto fail;
-    }
-    if (stack_top == MP_OBJ_NULL || stack.len != 0) {
-        // not exactly 1 object
-        goto fail;
+        ujson_syntax_error();
     }
+}
+
+STATIC mp_obj_t ujson_load(mp_obj_t obj, bool allow_str) {
+    ujson_stream_t s;
+    ujson_stream_init(&s, obj, allow_str);
+    vstr_t vstr;
+    vstr_init(&vstr, 8);
+    mp_obj_t value = MP_OBJ_NULL;
+    int tok = ujson_next_token(&s, &vstr, true, &value);
+    value = ujson_build(&s, &vstr, tok, value);
+    ujson_check_end(&s);
     vstr_clear(&vstr);
-    return stack_top;
+    return value;
+}
 
-    fail:
-    mp_raise_ValueError("syntax error in JSON");
+STATIC mp_obj_t mod_ujson_load(mp_obj_t stream_obj) {
+    return ujson_load(stream_obj, false);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_load_obj, mod_ujson_load);
 
 STATIC mp_obj_t mod_ujson_loads(mp_obj_t obj) {
-    size_t len;
-    const char *buf = mp_obj_str_get_data(obj, &len);
-    vstr_t vstr = {len, len, (char*)buf, true};
-    mp_obj_stringio_t sio = {{&mp_type_stringio}, &vstr, 0, MP_OBJ_NULL};
-    return mod_ujson_load(MP_OBJ_FROM_PTR(&sio));
+    if (!MP_OBJ_IS_STR_OR_BYTES(obj)) {
+        mp_raise_TypeError(NULL);
+    }
+    return ujson_load(obj, true);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(mod_ujson_loads_obj, mod_ujson_loads);
 
+#if MICROPY_PY_UJSON_ITERLOAD
+
+// ujson.iterload(stream, path) parses a document incrementally and yields the
+// values at the end of path, each built in full, without building the
+// containers around them.  Each entry of path selects members of the
+// container at that depth: a str is an object key, an int is an array index
+// and None is every member.  If the last entry is None and matches an object
+// member, (key, value) tuples are yielded.  An int path n is n Nones.
+
+typedef struct _ujson_iter_level_t {
+    bool is_dict;
+    mp_obj_t key; // key of the current member of a dict, MP_OBJ_NULL if not read yet
+    mp_int_t index; // index of the current member of a list
+} ujson_iter_level_t;
+
+typedef struct _ujson_iter_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    size_t path_len;
+    mp_obj_t *path;
+    ujson_iter_level_t *levels;
+    size_t depth; // number of containers we are inside
+    bool started;
+    bool done;
+    vstr_t vstr;
+    ujson_stream_t s;
+} ujson_iter_t;
+
+// Skips the rest of a container whose opening bracket has been read
+STATIC void ujson_skip_container(ujson_stream_t *s, vstr_t *vstr) {
+    for (size_t nest = 1; nest > 0;) {
+        mp_obj_t value;
+        switch (ujson_next_token(s, vstr, false, &value)) {
+            case UJSON_TOK_LIST:
+            case UJSON_TOK_DICT:
+                ++nest;
+                break;
+            case UJSON_TOK_END:
+                --nest;
+                break;
+            case UJSON_TOK_EOF:
+                ujson_syntax_error();
+        }
+    }
+}
+
+STATIC void ujson_iter_next_member(ujson_iter_t *self) {
+    if (self->depth > 0) {
+        ujson_iter_level_t *level = &self->levels[self->depth - 1];
+        level->key = MP_OBJ_NULL;
+        level->index += 1;
+    }
+}
+
+STATIC mp_obj_t ujson_iter_iternext(mp_obj_t self_in) {
+    ujson_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    ujson_stream_t *s = &self->s;
+    while (!self->done) {
+        mp_obj_t value = MP_OBJ_NULL;
+        int tok;
+
+        if (!self->started) {
+            // the top-level value
+            self->started = true;
+            tok = ujson_next_token(s, &self->vstr, self->path_len == 0, &value);
+            if (self->path_len == 0) {
+                value = ujson_build(s, &self->vstr, tok, value);
+                self->done = true;
+                ujson_check_end(s);
+                return value;
+            }
+            if (tok == UJSON_TOK_LIST || tok == UJSON_TOK_DICT) {
+                self->levels[0].is_dict = tok == UJSON_TOK_DICT;
+                self->levels[0].key = MP_OBJ_NULL;
+                self->levels[0].index = 0;
+                self->depth = 1;
+            } else if (tok == UJSON_TOK_VALUE) {
+                // a primitive has no members to yield
+                self->done = true;
+                ujson_check_end(s);
+            } else {
+                ujson_syntax_error();
+            }
+            continue;
+        }
+
+        ujson_iter_level_t *level = &self->levels[self->depth - 1];
+        if (level->is_dict && level->key == MP_OBJ_NULL) {
+            // a key, or the end of the object
+            tok = ujson_next_token(s, &self->vstr, true, &value);
+            if (tok == UJSON_TOK_VALUE && MP_OBJ_IS_STR(value)) {
+                level->key = value;
+                continue;
+            }
+        } else {
+            // see if the path selects the next member, so it's only built if so
+            mp_obj_t sel = self->path[self->depth - 1];
+            bool match;
+            if (sel == mp_const_none) {
+                match = true;
+            } else if (level->is_dict) {
+                match = mp_obj_equal(sel, level->key);
+            } else {
+                match = MP_OBJ_IS_SMALL_INT(sel) && MP_OBJ_SMALL_INT_VALUE(sel) == level->index;
+            }
+            bool target = match && self->depth == self->path_len;
+            tok = ujson_next_token(s, &self->vstr, target, &value);
+            if (tok != UJSON_TOK_END && tok != UJSON_TOK_EOF) {
+                if (target) {
+                    value = ujson_build(s, &self->vstr, tok, value);
+                    if (sel == mp_const_none && level->is_dict) {
+                        mp_obj_t items[2] = {level->key, value};
+                        value = mp_obj_new_tuple(2, items);
+                    }
+                    ujson_iter_next_member(self);
+                    return value;
+                }
+                if (tok == UJSON_TOK_VALUE) {
+                    ujson_iter_next_member(self);
+                } else if (match) {
+                    level = &self->levels[self->depth++];
+                    level->is_dict = tok == UJSON_TOK_DICT;
+                    level->key = MP_OBJ_NULL;
+                    level->index = 0;
+                } else {
+                    ujson_skip_container(s, &self->vstr);
+                    ujson_iter_next_member(self);
+                }
+                continue;
+            }
+            if (level->is_dict) {
+                // a key without a value
+                ujson_syntax_error();
+            }
+        }
+        if (tok != UJSON_TOK_END) {
+            ujson_syntax_error();
+        }
+
+        // the container is finished, and so is the member of its parent
+        if (--self->depth == 0) {
+            self->done = true;
+            ujson_check_end(s);
+        } else {
+            ujson_iter_next_member(self);
+        }
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+STATIC mp_obj_t mod_ujson_iterload(size_t n_args, const mp_obj_t *args) {
+    ujson_iter_t *self = m_new_obj(ujson_iter_t);
+    self->base.type = &mp_type_polymorph_iter;
+    self->iternext = ujson_iter_iternext;
+    if (n_args < 2) {
+        self->path_len = 0;
+        self->path = NULL;
+    } else if (MP_OBJ_IS_SMALL_INT(args[1])) {
+        mp_int_t n = MP_OBJ_SMALL_INT_VALUE(args[1]);
+        if (n < 0) {
+            mp_raise_ValueError(NULL);
+        }
+        self->path_len = n;
+        self->path = m_new(mp_obj_t, n);
+        for (mp_int_t i = 0; i < n; ++i) {
+            self->path[i] = mp_const_none;
+        }
+    } else {
+        mp_obj_t *items;
+        mp_obj_get_array(args[1], &self->path_len, &items);
+        self->path = m_new(mp_obj_t, self->path_len);
+        for (size_t i = 0; i < self->path_len; ++i) {
+            if (items[i] != mp_const_none && !MP_OBJ_IS_STR(items[i]) && !MP_OBJ_IS_SMALL_INT(items[i])) {
+                mp_raise_TypeError(NULL);
+            }
+            self->path[i] = items[i];
+        }
+    }
+    self->levels = m_new(ujson_iter_level_t, self->path_len);
+    self->depth = 0;
+    self->started = false;
+    self->done = false;
+    vstr_init(&self->vstr, 8);
+    ujson_stream_init(&self->s, args[0], true);
+    return MP_OBJ_FROM_PTR(self);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_ujson_iterload_obj, 1, 2, mod_ujson_iterload);
+
+#endif // MICROPY_PY_UJSON_ITERLOAD
+
 STATIC const mp_rom_map_elem_t mp_module_ujson_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ujson) },
+    { MP_ROM_QSTR(MP_QSTR_dump), MP_ROM_PTR(&mod_ujson_dump_obj) },
     { MP_ROM_QSTR(MP_QSTR_dumps), MP_ROM_PTR(&mod_ujson_dumps_obj) },
     { MP_ROM_QSTR(MP_QSTR_load), MP_ROM_PTR(&mod_ujson_load_obj) },
     { MP_ROM_QSTR(MP_QSTR_loads), MP_ROM_PTR(&mod_ujson_loads_obj) },
+    #if MICROPY_PY_UJSON_ITERLOAD
+    { MP_ROM_QSTR(MP_QSTR_iterload), MP_ROM_PTR(&mod_ujson_iterload_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_ujson_globals, mp_module_ujson_globals_table);
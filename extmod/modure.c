@@ -40,9 +40,16 @@
 #include "re1.5/re1.5.h"
 
 #define FLAG_DEBUG 0x1000
+#define FLAG_PIKEVM 0x2000
+#define FLAG_DFA 0x4000
 
 typedef struct _mp_obj_re_t {
     mp_obj_base_t base;
+    #if MICROPY_PY_URE_PIKEVM
+    int flags;
+    void *pikevm_ws; // workspace for the Pike VM, allocated when first used
+    void *dfa; // DFA cache, allocated when first used
+    #endif
     ByteProg re;
 } mp_obj_re_t;
 
@@ -53,6 +60,77 @@ typedef struct _mp_obj_match_t {
     const char *caps[0];
 } mp_obj_match_t;
 
+// Gets the data of a subject, which can be a str, bytes or anything with the
+// buffer protocol
+STATIC const char *ure_subject_data(mp_obj_t str, size_t *len) {
+    if (MP_OBJ_IS_STR_OR_BYTES(str)) {
+        return mp_obj_str_get_data(str, len);
+    }
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(str, &bufinfo, MP_BUFFER_READ);
+    *len = bufinfo.len;
+    return bufinfo.buf;
+}
+
+// Converts a position in the subject, which counts chars for a str, to a
+// pointer into its data, clamped to the data
+STATIC const char *ure_pos_to_ptr(mp_obj_t str, const char *begin, size_t len, mp_int_t pos) {
+    if (pos <= 0) {
+        return begin;
+    }
+    if ((mp_uint_t)pos >= len) {
+        return begin + len;
+    }
+    #if MICROPY_PY_BUILTINS_STR_UNICODE
+    if (MP_OBJ_IS_STR(str)) {
+        return (const char*)str_index_to_ptr(&mp_type_str, (const byte*)begin, len, MP_OBJ_NEW_SMALL_INT(pos), true);
+    }
+    #else
+    (void)str;
+    #endif
+    return begin + pos;
+}
+
+#if MICROPY_PY_URE_MATCH_SPAN_START_END
+STATIC mp_int_t ure_ptr_to_pos(mp_obj_t str, const char *begin, const char *ptr) {
+    #if MICROPY_PY_BUILTINS_STR_UNICODE
+    if (MP_OBJ_IS_STR(str)) {
+        return unichar_charlen(begin, ptr - begin);
+    }
+    #else
+    (void)str;
+    #endif
+    return ptr - begin;
+}
+#endif
+
+// Returns the part of the subject from start to end, as bytes for a subject
+// that is neither str nor bytes
+STATIC mp_obj_t ure_slice(mp_obj_t str, const char *start, const char *end) {
+    const mp_obj_type_t *type = &mp_type_bytes;
+    if (MP_OBJ_IS_STR(str)) {
+        type = &mp_type_str;
+    }
+    return mp_obj_new_str_of_type(type, (const byte*)start, end - start);
+}
+
+#if MICROPY_PY_URE_SUB || MICROPY_PY_URE_FINDITER
+// Returns the start of the char after the one at p
+STATIC const char *ure_next_char(mp_obj_t str, const char *p, const char *end) {
+    p++;
+    #if MICROPY_PY_BUILTINS_STR_UNICODE
+    if (MP_OBJ_IS_STR(str)) {
+        while (p < end && UTF8_IS_CONT(*p)) {
+            p++;
+        }
+    }
+    #else
+    (void)str;
+    (void)end;
+    #endif
+    return p;
+}
+#endif
 
 STATIC void match_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
@@ -60,25 +138,77 @@ STATIC void match_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind
     mp_printf(print, "<match num=%d>", self->num_matches);
 }
 
-STATIC mp_obj_t match_group(mp_obj_t self_in, mp_obj_t no_in) {
-    mp_obj_match_t *self = MP_OBJ_TO_PTR(self_in);
+STATIC mp_int_t match_get_group(mp_obj_match_t *self, mp_obj_t no_in) {
     mp_int_t no = mp_obj_get_int(no_in);
     if (no < 0 || no >= self->num_matches) {
         nlr_raise(mp_obj_new_exception_arg1(&mp_type_IndexError, no_in));
     }
+    return no;
+}
+
+STATIC mp_obj_t match_group(mp_obj_t self_in, mp_obj_t no_in) {
+    mp_obj_match_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_int_t no = match_get_group(self, no_in);
 
     const char *start = self->caps[no * 2];
     if (start == NULL) {
         // no match for this group
         return mp_const_none;
     }
-    return mp_obj_new_str_of_type(mp_obj_get_type(self->str),
-        (const byte*)start, self->caps[no * 2 + 1] - start);
+    return ure_slice(self->str, start, self->caps[no * 2 + 1]);
 }
 MP_DEFINE_CONST_FUN_OBJ_2(match_group_obj, match_group);
 
+#if MICROPY_PY_URE_MATCH_SPAN_START_END
+
+// Gets the start and end positions of a group, which are -1 if it didn't match
+STATIC void match_span_helper(size_t n_args, const mp_obj_t *args, mp_obj_t span[2]) {
+    mp_obj_match_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t no = 0;
+    if (n_args == 2) {
+        no = match_get_group(self, args[1]);
+    }
+    const char *start = self->caps[no * 2];
+    if (start == NULL) {
+        span[0] = span[1] = MP_OBJ_NEW_SMALL_INT(-1);
+        return;
+    }
+    size_t len;
+    const char *begin = ure_subject_data(self->str, &len);
+    span[0] = mp_obj_new_int(ure_ptr_to_pos(self->str, begin, start));
+    span[1] = mp_obj_new_int(ure_ptr_to_pos(self->str, begin, self->caps[no * 2 + 1]));
+}
+
+STATIC mp_obj_t match_span(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return mp_obj_new_tuple(2, span);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_span_obj, 1, 2, match_span);
+
+STATIC mp_obj_t match_start(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return span[0];
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_start_obj, 1, 2, match_start);
+
+STATIC mp_obj_t match_end(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t span[2];
+    match_span_helper(n_args, args, span);
+    return span[1];
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(match_end_obj, 1, 2, match_end);
+
+#endif
+
 STATIC const mp_rom_map_elem_t match_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_group), MP_ROM_PTR(&match_group_obj) },
+    #if MICROPY_PY_URE_MATCH_SPAN_START_END
+    { MP_ROM_QSTR(MP_QSTR_span), MP_ROM_PTR(&match_span_obj) },
+    { MP_ROM_QSTR(MP_QSTR_start), MP_ROM_PTR(&match_start_obj) },
+    { MP_ROM_QSTR(MP_QSTR_end), MP_ROM_PTR(&match_end_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(match_locals_dict, match_locals_dict_table);
@@ -90,33 +220,76 @@ STATIC const mp_obj_type_t match_type = {
     .locals_dict = (void*)&match_locals_dict,
 };
 
+STATIC mp_obj_t ure_new_match(mp_obj_t str, const char **caps, int caps_num) {
+    mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
+    match->base.type = &match_type;
+    match->num_matches = caps_num / 2; // caps_num counts start and end pointers
+    match->str = str;
+    memcpy((char*)match->caps, caps, caps_num * sizeof(char*));
+    return MP_OBJ_FROM_PTR(match);
+}
+
 STATIC void re_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
     mp_obj_re_t *self = MP_OBJ_TO_PTR(self_in);
     mp_printf(print, "<re %p>", self);
 }
 
+// Runs the matcher that the pattern was compiled for
+STATIC int ure_run(mp_obj_re_t *self, Subject *subj, const char **caps, int caps_num, bool is_anchored) {
+    #if MICROPY_PY_URE_PIKEVM
+    if (self->flags & FLAG_DFA) {
+        if (self->dfa == NULL) {
+            self->dfa = m_new(byte, re1_5_dfa_size(&self->re));
+            re1_5_dfa_init(&self->re, self->dfa);
+        }
+        // a subject that can't match is rejected without running the Pike VM
+        if (re1_5_dfamatch(&self->re, self->dfa, subj, is_anchored) == 0) {
+            return 0;
+        }
+    }
+    if (self->flags & (FLAG_PIKEVM | FLAG_DFA)) {
+        if (self->pikevm_ws == NULL) {
+            self->pikevm_ws = m_new(byte, re1_5_pikevm_size(&self->re, caps_num));
+        }
+        return re1_5_pikevm(&self->re, self->pikevm_ws, subj, caps, caps_num, is_anchored);
+    }
+    #endif
+    return re1_5_recursiveloopprog(&self->re, subj, caps, caps_num, is_anchored);
+}
+
+// Sets up subj for the subject in args[1], from the optional pos in args[2]
+// to endpos in args[3].  ^ only matches at the start of the subject, not at
+// pos.  Returns false if endpos is before pos, when nothing can match.
+STATIC bool ure_init_subject(Subject *subj, size_t n_args, const mp_obj_t *args) {
+    size_t len;
+    const char *begin = ure_subject_data(args[1], &len);
+    subj->begin = subj->begin_line = begin;
+    subj->end = begin + len;
+    if (n_args > 2) {
+        subj->begin = ure_pos_to_ptr(args[1], begin, len, mp_obj_get_int(args[2]));
+        if (n_args > 3) {
+            subj->end = ure_pos_to_ptr(args[1], begin, len, mp_obj_get_int(args[3]));
+        }
+    }
+    return subj->begin <= subj->end;
+}
+
 STATIC mp_obj_t ure_exec(bool is_anchored, uint n_args, const mp_obj_t *args) {
-    (void)n_args;
     mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
     Subject subj;
-    size_t len;
-    subj.begin = mp_obj_str_get_data(args[1], &len);
-    subj.end = subj.begin + len;
+    if (!ure_init_subject(&subj, n_args, args)) {
+        return mp_const_none;
+    }
     int caps_num = (self->re.sub + 1) * 2;
-    mp_obj_match_t *match = m_new_obj_var(mp_obj_match_t, char*, caps_num);
+    const char **caps = alloca(caps_num * sizeof(char*));
     // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
-    memset((char*)match->caps, 0, caps_num * sizeof(char*));
-    int res = re1_5_recursiveloopprog(&self->re, &subj, match->caps, caps_num, is_anchored);
+    memset((char**)caps, 0, caps_num * sizeof(char*));
+    int res = ure_run(self, &subj, caps, caps_num, is_anchored);
     if (res == 0) {
-        m_del_var(mp_obj_match_t, char*, caps_num, match);
         return mp_const_none;
     }
-
-    match->base.type = &match_type;
-    match->num_matches = caps_num / 2; // caps_num counts start and end pointers
-    match->str = args[1];
-    return MP_OBJ_FROM_PTR(match);
+    return ure_new_match(args[1], caps, caps_num);
 }
 
 STATIC mp_obj_t re_match(size_t n_args, const mp_obj_t *args) {
@@ -133,9 +306,9 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
     Subject subj;
     size_t len;
-    const mp_obj_type_t *str_type = mp_obj_get_type(args[1]);
-    subj.begin = mp_obj_str_get_data(args[1], &len);
-    subj.end = subj.begin + len;
+    const char *begin = ure_subject_data(args[1], &len);
+    subj.begin = subj.begin_line = begin;
+    subj.end = begin + len;
     int caps_num = (self->re.sub + 1) * 2;
 
     int maxsplit = 0;
@@ -148,14 +321,14 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
     while (true) {
         // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
         memset((char**)caps, 0, caps_num * sizeof(char*));
-        int res = re1_5_recursiveloopprog(&self->re, &subj, caps, caps_num, false);
+        int res = ure_run(self, &subj, caps, caps_num, false);
 
         // if we didn't have a match, or had an empty match, it's time to stop
         if (!res || caps[0] == caps[1]) {
             break;
         }
 
-        mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)subj.begin, caps[0] - subj.begin);
+        mp_obj_t s = ure_slice(args[1], subj.begin, caps[0]);
         mp_obj_list_append(retval, s);
         if (self->re.sub > 0) {
             mp_raise_NotImplementedError("Splitting with sub-captures");
@@ -166,16 +339,176 @@ STATIC mp_obj_t re_split(size_t n_args, const mp_obj_t *args) {
         }
     }
 
-    mp_obj_t s = mp_obj_new_str_of_type(str_type, (const byte*)subj.begin, subj.end - subj.begin);
+    mp_obj_t s = ure_slice(args[1], subj.begin, subj.end);
     mp_obj_list_append(retval, s);
     return retval;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_split_obj, 2, 3, re_split);
 
+#if MICROPY_PY_URE_SUB
+
+// Appends the replacement template repl to vstr, with \N and \g<N> replaced
+// by group N of the match
+STATIC void ure_expand(vstr_t *vstr, const char *repl, size_t repl_len, const char **caps, int caps_num) {
+    const char *top = repl + repl_len;
+    while (repl < top) {
+        const char *p = repl;
+        mp_int_t no = -1;
+        if (*p == '\\' && p + 1 < top) {
+            if (unichar_isdigit(p[1])) {
+                no = p[1] - '0';
+                p += 2;
+            } else if (p[1] == 'g' && p + 2 < top && p[2] == '<') {
+                const char *q = p + 3;
+                for (no = 0; q < top && unichar_isdigit(*q); q++) {
+                    no = no * 10 + *q - '0';
+                }
+                if (q == p + 3 || q >= top || *q != '>') {
+                    mp_raise_ValueError("bad group reference");
+                }
+                p = q + 1;
+            }
+        }
+        if (no < 0) {
+            vstr_add_byte(vstr, *repl++);
+            continue;
+        }
+        if (no >= caps_num / 2) {
+            nlr_raise(mp_obj_new_exception_arg1(&mp_type_IndexError, MP_OBJ_NEW_SMALL_INT(no)));
+        }
+        const char *start = caps[no * 2];
+        if (start != NULL) {
+            vstr_add_strn(vstr, start, caps[no * 2 + 1] - start);
+        }
+        repl = p;
+    }
+}
+
+STATIC mp_obj_t re_sub(size_t n_args, const mp_obj_t *args) {
+    mp_obj_re_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_t repl = args[1];
+    mp_obj_t str = args[2];
+    mp_int_t count = 0;
+    if (n_args > 3) {
+        count = mp_obj_get_int(args[3]);
+    }
+
+    size_t repl_len = 0;
+    const char *repl_data = NULL;
+    if (!mp_obj_is_callable(repl)) {
+        repl_data = mp_obj_str_get_data(repl, &repl_len);
+    }
+
+    Subject subj;
+    size_t len;
+    const char *begin = ure_subject_data(str, &len);
+    subj.begin = subj.begin_line = begin;
+    subj.end = begin + len;
+    int caps_num = (self->re.sub + 1) * 2;
+    const char **caps = alloca(caps_num * sizeof(char*));
+
+    vstr_t vstr;
+    vstr_init(&vstr, len);
+    for (;;) {
+        // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
+        memset((char**)caps, 0, caps_num * sizeof(char*));
+        if (!ure_run(self, &subj, caps, caps_num, false)) {
+            break;
+        }
+
+        vstr_add_strn(&vstr, subj.begin, caps[0] - subj.begin);
+        if (repl_data == NULL) {
+            // a match object is only made for a callable replacement
+            size_t r_len;
+            const char *r = mp_obj_str_get_data(mp_call_function_1(repl, ure_new_match(str, caps, caps_num)), &r_len);
+            vstr_add_strn(&vstr, r, r_len);
+        } else {
+            ure_expand(&vstr, repl_data, repl_len, caps, caps_num);
+        }
+
+        if (caps[0] != caps[1]) {
+            subj.begin = caps[1];
+        } else if (caps[1] < subj.end) {
+            // an empty match: the next one can't be at the same place
+            subj.begin = ure_next_char(str, caps[1], subj.end);
+            vstr_add_strn(&vstr, caps[1], subj.begin - caps[1]);
+        } else {
+            subj.begin = subj.end;
+            break;
+        }
+        if (count > 0 && --count == 0) {
+            break;
+        }
+    }
+    vstr_add_strn(&vstr, subj.begin, subj.end - subj.begin);
+
+    return mp_obj_new_str_from_vstr(MP_OBJ_IS_STR(str) ? &mp_type_str : &mp_type_bytes, &vstr);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_sub_obj, 3, 4, re_sub);
+
+#endif
+
+#if MICROPY_PY_URE_FINDITER
+
+typedef struct _mp_obj_re_finditer_t {
+    mp_obj_base_t base;
+    mp_fun_1_t iternext;
+    mp_obj_re_t *re;
+    mp_obj_t str;
+    Subject subj;
+    bool done;
+    const char **caps; // reused for each search, a match is only made when one is found
+} mp_obj_re_finditer_t;
+
+STATIC mp_obj_t re_finditer_iternext(mp_obj_t self_in) {
+    mp_obj_re_finditer_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->done) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    int caps_num = (self->re->re.sub + 1) * 2;
+    const char **caps = self->caps;
+    // cast is a workaround for a bug in msvc: it treats const char** as a const pointer instead of a pointer to pointer to const char
+    memset((char**)caps, 0, caps_num * sizeof(char*));
+    if (!ure_run(self->re, &self->subj, caps, caps_num, false)) {
+        self->done = true;
+        return MP_OBJ_STOP_ITERATION;
+    }
+    if (caps[0] != caps[1]) {
+        self->subj.begin = caps[1];
+    } else if (caps[1] < self->subj.end) {
+        // an empty match: the next one can't be at the same place
+        self->subj.begin = ure_next_char(self->str, caps[1], self->subj.end);
+    } else {
+        self->done = true;
+    }
+    return ure_new_match(self->str, caps, caps_num);
+}
+
+STATIC mp_obj_t re_finditer(size_t n_args, const mp_obj_t *args) {
+    mp_obj_re_t *re = MP_OBJ_TO_PTR(args[0]);
+    mp_obj_re_finditer_t *self = m_new_obj(mp_obj_re_finditer_t);
+    self->base.type = &mp_type_polymorph_iter;
+    self->iternext = re_finditer_iternext;
+    self->re = re;
+    self->str = args[1];
+    self->done = !ure_init_subject(&self->subj, n_args, args);
+    self->caps = m_new(const char*, (re->re.sub + 1) * 2);
+    return MP_OBJ_FROM_PTR(self);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(re_finditer_obj, 2, 4, re_finditer);
+
+#endif
+
 STATIC const mp_rom_map_elem_t re_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_match), MP_ROM_PTR(&re_match_obj) },
     { MP_ROM_QSTR(MP_QSTR_search), MP_ROM_PTR(&re_search_obj) },
     { MP_ROM_QSTR(MP_QSTR_split), MP_ROM_PTR(&re_split_obj) },
+    #if MICROPY_PY_URE_SUB
+    { MP_ROM_QSTR(MP_QSTR_sub), MP_ROM_PTR(&re_sub_obj) },
+    #endif
+    #if MICROPY_PY_URE_FINDITER
+    { MP_ROM_QSTR(MP_QSTR_finditer), MP_ROM_PTR(&re_finditer_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(re_locals_dict, re_locals_dict_table);
@@ -207,6 +540,11 @@ error:
     if (flags & FLAG_DEBUG) {
         re1_5_dumpcode(&o->re);
     }
+    #if MICROPY_PY_URE_PIKEVM
+    o->flags = flags;
+    o->pikevm_ws = NULL;
+    o->dfa = NULL;
+    #endif
     return MP_OBJ_FROM_PTR(o);
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_compile_obj, 1, 2, mod_re_compile);
@@ -230,12 +568,39 @@ STATIC mp_obj_t mod_re_search(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_search_obj, 2, 4, mod_re_search);
 
+#if MICROPY_PY_URE_SUB
+STATIC mp_obj_t mod_re_sub(size_t n_args, const mp_obj_t *args) {
+    mp_obj_t self = mod_re_compile(1, args);
+    mp_obj_t args2[] = {self, args[1], args[2], n_args > 3 ? args[3] : MP_OBJ_NEW_SMALL_INT(0)};
+    return re_sub(4, args2);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_re_sub_obj, 3, 4, mod_re_sub);
+#endif
+
+#if MICROPY_PY_URE_FINDITER
+STATIC mp_obj_t mod_re_finditer(mp_obj_t pattern, mp_obj_t str) {
+    mp_obj_t args[] = {mod_re_compile(1, &pattern), str};
+    return re_finditer(2, args);
+}
+MP_DEFINE_CONST_FUN_OBJ_2(mod_re_finditer_obj, mod_re_finditer);
+#endif
+
 STATIC const mp_rom_map_elem_t mp_module_re_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ure) },
     { MP_ROM_QSTR(MP_QSTR_compile), MP_ROM_PTR(&mod_re_compile_obj) },
     { MP_ROM_QSTR(MP_QSTR_match), MP_ROM_PTR(&mod_re_match_obj) },
     { MP_ROM_QSTR(MP_QSTR_search), MP_ROM_PTR(&mod_re_search_obj) },
+    #if MICROPY_PY_URE_SUB
+    { MP_ROM_QSTR(MP_QSTR_sub), MP_ROM_PTR(&mod_re_sub_obj) },
+    #endif
+    #if MICROPY_PY_URE_FINDITER
+    { MP_ROM_QSTR(MP_QSTR_finditer), MP_ROM_PTR(&mod_re_finditer_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_DEBUG), MP_ROM_INT(FLAG_DEBUG) },
+    #if MICROPY_PY_URE_PIKEVM
+    { MP_ROM_QSTR(MP_QSTR_PIKEVM), MP_ROM_INT(FLAG_PIKEVM) },
+    { MP_ROM_QSTR(MP_QSTR_DFA), MP_ROM_INT(FLAG_DFA) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_re_globals, mp_module_re_globals_table);
@@ -253,5 +618,9 @@ const mp_obj_module_t mp_module_ure = {
 #include "re1.5/dumpcode.c"
 #include "re1.5/recursiveloop.c"
 #include "re1.5/charclass.c"
+#if MICROPY_PY_URE_PIKEVM
+#include "re1.5/pike.c"
+#include "re1.5/dfa.c"
+#endif
 
 #endif //MICROPY_PY_URE
@@ -25,7 +25,7 @@
  */
 
 #include "py/mpconfig.h"
-#if MICROPY_PY_USELECT
+#if MICROPY_PY_USELECT || MICROPY_PY_USELECT_GENERIC
 
 #include <stdio.h>
 
@@ -39,37 +39,124 @@
 // Flags for poll()
 #define FLAG_ONESHOT (1)
 
+#if MICROPY_PY_USELECT_NOTIFY
+// Waits until the pointer at dirty_ptr is set by a notifying stream, or for up
+// to timeout_ms (-1 for no limit); it may return early
+#ifndef MICROPY_PY_USELECT_WAIT
+#define MICROPY_PY_USELECT_WAIT(dirty_ptr, timeout_ms) MICROPY_EVENT_POLL_HOOK
+#endif
+// Called after a stream notified, possibly from an ISR
+#ifndef MICROPY_PY_USELECT_WAKE
+#define MICROPY_PY_USELECT_WAKE()
+#endif
+#endif
+
 /// \module select - Provides select function to wait for events on a stream
 ///
 /// This module provides the select function.
 
+typedef struct _mp_obj_poll_t mp_obj_poll_t;
+
 typedef struct _poll_obj_t {
+    #if MICROPY_PY_USELECT_NOTIFY
+    // Streams which can tell when their readiness may have changed are
+    // only polled after that.  The notifier must be the first member.
+    mp_stream_poll_notify_t notify;
+    mp_obj_poll_t *poller;
+    struct _poll_obj_t *next_dirty;
+    struct _poll_obj_t *next_ready;
+    volatile bool dirty;
+    bool polled; // polled every time because the stream can't notify
+    #endif
     mp_obj_t obj;
     mp_uint_t (*ioctl)(mp_obj_t obj, mp_uint_t request, mp_uint_t arg, int *errcode);
     mp_uint_t flags;
     mp_uint_t flags_ret;
 } poll_obj_t;
 
-STATIC void poll_map_add(mp_map_t *poll_map, const mp_obj_t *obj, mp_uint_t obj_len, mp_uint_t flags, bool or_flags) {
+/// \class Poll - poll class
+
+struct _mp_obj_poll_t {
+    mp_obj_base_t base;
+    mp_map_t poll_map;
+    #if MICROPY_PY_USELECT_NOTIFY
+    poll_obj_t *volatile dirty; // objects to poll next time
+    poll_obj_t *ready; // objects found ready by the last poll
+    poll_obj_t *iter_next;
+    mp_uint_t n_polled; // number of objects polled every time
+    #else
+    short iter_cnt;
+    short iter_idx;
+    #endif
+    int flags;
+    // callee-owned tuple
+    mp_obj_t ret_tuple;
+};
+
+#if MICROPY_PY_USELECT_NOTIFY
+// Queues poll_obj to be polled next time; may be called from an ISR
+STATIC void poll_obj_mark_dirty(poll_obj_t *poll_obj) {
+    mp_obj_poll_t *poller = poll_obj->poller;
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    if (!poll_obj->dirty) {
+        poll_obj->dirty = true;
+        poll_obj->next_dirty = poller->dirty;
+        poller->dirty = poll_obj;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+STATIC void poll_obj_notify(mp_stream_poll_notify_t *notify) {
+    poll_obj_mark_dirty((poll_obj_t*)notify);
+    MICROPY_PY_USELECT_WAKE();
+}
+#endif
+
+// poller is NULL when adding to the temporary map of select()
+STATIC void poll_map_add(mp_map_t *poll_map, mp_obj_poll_t *poller, const mp_obj_t *obj, mp_uint_t obj_len, mp_uint_t flags, bool or_flags) {
     for (mp_uint_t i = 0; i < obj_len; i++) {
-        mp_map_elem_t *elem = mp_map_lookup(poll_map, mp_obj_id(obj[i]), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND);
-        if (elem->value == NULL) {
-            // object not found; get its ioctl and add it to the poll list
+        mp_map_elem_t *elem = mp_map_lookup(poll_map, mp_obj_id(obj[i]), MP_MAP_LOOKUP);
+        poll_obj_t *poll_obj;
+        if (elem == NULL) {
+            // object not found; get its ioctl and add it to the poll list,
+            // checking that it's a stream first so no empty entry is left
             const mp_stream_p_t *stream_p = mp_get_stream_raise(obj[i], MP_STREAM_OP_IOCTL);
-            poll_obj_t *poll_obj = m_new_obj(poll_obj_t);
+            poll_obj = m_new_obj(poll_obj_t);
             poll_obj->obj = obj[i];
             poll_obj->ioctl = stream_p->ioctl;
             poll_obj->flags = flags;
             poll_obj->flags_ret = 0;
-            elem->value = poll_obj;
+            mp_map_lookup(poll_map, mp_obj_id(obj[i]), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = poll_obj;
+            #if !MICROPY_PY_USELECT_NOTIFY
+            (void)poller;
+            #else
+            poll_obj->notify.notify = poll_obj_notify;
+            poll_obj->notify.attached = false;
+            poll_obj->poller = poller;
+            poll_obj->dirty = false;
+            poll_obj->polled = true;
+            if (poller != NULL) {
+                // a stream which doesn't know the request leaves attached unset
+                int errcode;
+                poll_obj->ioctl(obj[i], MP_STREAM_SET_POLL_NOTIFY, (uintptr_t)&poll_obj->notify, &errcode);
+                poll_obj->polled = !poll_obj->notify.attached;
+                poller->n_polled += poll_obj->polled;
+            }
+            #endif
         } else {
             // object exists; update its flags
+            poll_obj = elem->value;
             if (or_flags) {
-                ((poll_obj_t*)elem->value)->flags |= flags;
+                poll_obj->flags |= flags;
             } else {
-                ((poll_obj_t*)elem->value)->flags = flags;
+                poll_obj->flags = flags;
             }
         }
+        #if MICROPY_PY_USELECT_NOTIFY
+        if (poller != NULL && !poll_obj->polled) {
+            poll_obj_mark_dirty(poll_obj);
+        }
+        #endif
     }
 }
 
@@ -111,7 +198,7 @@ STATIC mp_uint_t poll_map_poll(mp_map_t *poll_map, mp_uint_t *rwx_num) {
 }
 
 /// \function select(rlist, wlist, xlist[, timeout])
-STATIC mp_obj_t select_select(uint n_args, const mp_obj_t *args) {
+STATIC mp_obj_t select_select(size_t n_args, const mp_obj_t *args) {
     // get array data from tuple/list arguments
     size_t rwx_len[3];
     mp_obj_t *r_array, *w_array, *x_array;
@@ -137,9 +224,9 @@ STATIC mp_obj_t select_select(uint n_args, const mp_obj_t *args) {
     // merge separate lists and get the ioctl function for each object
     mp_map_t poll_map;
     mp_map_init(&poll_map, rwx_len[0] + rwx_len[1] + rwx_len[2]);
-    poll_map_add(&poll_map, r_array, rwx_len[0], MP_STREAM_POLL_RD, true);
-    poll_map_add(&poll_map, w_array, rwx_len[1], MP_STREAM_POLL_WR, true);
-    poll_map_add(&poll_map, x_array, rwx_len[2], MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP, true);
+    poll_map_add(&poll_map, NULL, r_array, rwx_len[0], MP_STREAM_POLL_RD, true);
+    poll_map_add(&poll_map, NULL, w_array, rwx_len[1], MP_STREAM_POLL_WR, true);
+    poll_map_add(&poll_map, NULL, x_array, rwx_len[2], MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP, true);
 
     mp_uint_t start_tick = mp_hal_ticks_ms();
     rwx_len[0] = rwx_len[1] = rwx_len[2] = 0;
@@ -147,7 +234,7 @@ STATIC mp_obj_t select_select(uint n_args, const mp_obj_t *args) {
         // poll the objects
         mp_uint_t n_ready = poll_map_poll(&poll_map, rwx_len);
 
-        if (n_ready > 0 || (timeout != -1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
+        if (n_ready > 0 || (timeout != (mp_uint_t)-1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
             // one or more objects are ready, or we had a timeout
             mp_obj_t list_array[3];
             list_array[0] = mp_obj_new_list(rwx_len[0], NULL);
@@ -175,22 +262,10 @@ STATIC mp_obj_t select_select(uint n_args, const mp_obj_t *args) {
         MICROPY_EVENT_POLL_HOOK
     }
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_select_select_obj, 3, 4, select_select);
-
-/// \class Poll - poll class
-
-typedef struct _mp_obj_poll_t {
-    mp_obj_base_t base;
-    mp_map_t poll_map;
-    short iter_cnt;
-    short iter_idx;
-    int flags;
-    // callee-owned tuple
-    mp_obj_t ret_tuple;
-} mp_obj_poll_t;
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_select_select_obj, 3, 4, select_select);
 
 /// \method register(obj[, eventmask])
-STATIC mp_obj_t poll_register(uint n_args, const mp_obj_t *args) {
+STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = args[0];
     mp_uint_t flags;
     if (n_args == 3) {
@@ -198,19 +273,35 @@ STATIC mp_obj_t poll_register(uint n_args, const mp_obj_t *args) {
     } else {
         flags = MP_STREAM_POLL_RD | MP_STREAM_POLL_WR;
     }
-    poll_map_add(&self->poll_map, &args[1], 1, flags, false);
+    poll_map_add(&self->poll_map, self, &args[1], 1, flags, false);
     return mp_const_none;
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
 
 /// \method unregister(obj)
 STATIC mp_obj_t poll_unregister(mp_obj_t self_in, mp_obj_t obj_in) {
     mp_obj_poll_t *self = self_in;
-    mp_map_lookup(&self->poll_map, mp_obj_id(obj_in), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+    mp_map_elem_t *elem = mp_map_lookup(&self->poll_map, mp_obj_id(obj_in), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
     // TODO raise KeyError if obj didn't exist in map
+    #if MICROPY_PY_USELECT_NOTIFY
+    if (elem != NULL) {
+        poll_obj_t *poll_obj = elem->value;
+        if (poll_obj->polled) {
+            self->n_polled -= 1;
+        } else {
+            int errcode;
+            poll_obj->ioctl(poll_obj->obj, MP_STREAM_CLR_POLL_NOTIFY, (uintptr_t)&poll_obj->notify, &errcode);
+        }
+        // it may still be in the dirty and ready lists, which skip it
+        poll_obj->obj = MP_OBJ_NULL;
+        poll_obj->flags_ret = 0;
+    }
+    #else
+    (void)elem;
+    #endif
     return mp_const_none;
 }
-MP_DEFINE_CONST_FUN_OBJ_2(poll_unregister_obj, poll_unregister);
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(poll_unregister_obj, poll_unregister);
 
 /// \method modify(obj, eventmask)
 STATIC mp_obj_t poll_modify(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmask_in) {
@@ -219,12 +310,103 @@ STATIC mp_obj_t poll_modify(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmas
     if (elem == NULL) {
         mp_raise_OSError(MP_ENOENT);
     }
-    ((poll_obj_t*)elem->value)->flags = mp_obj_get_int(eventmask_in);
+    poll_obj_t *poll_obj = elem->value;
+    poll_obj->flags = mp_obj_get_int(eventmask_in);
+    #if MICROPY_PY_USELECT_NOTIFY
+    if (!poll_obj->polled) {
+        poll_obj_mark_dirty(poll_obj);
+    }
+    #endif
     return mp_const_none;
 }
-MP_DEFINE_CONST_FUN_OBJ_3(poll_modify_obj, poll_modify);
+STATIC MP_DEFINE_CONST_FUN_OBJ_3(poll_modify_obj, poll_modify);
+
+#if MICROPY_PY_USELECT_NOTIFY
+// Polls one object, adding it to the ready list if it's ready
+STATIC mp_uint_t poll_obj_poll(mp_obj_poll_t *self, poll_obj_t *poll_obj, int *errcode) {
+    mp_uint_t ret = poll_obj->ioctl(poll_obj->obj, MP_STREAM_POLL, poll_obj->flags, errcode);
+    if (ret == MP_STREAM_ERROR) {
+        return ret;
+    }
+    poll_obj->flags_ret = ret;
+    if (ret != 0) {
+        poll_obj->next_ready = self->ready;
+        self->ready = poll_obj;
+        if (!poll_obj->polled) {
+            // no notification comes while it stays ready, so check it again next time
+            poll_obj_mark_dirty(poll_obj);
+        }
+    }
+    return ret;
+}
+
+// Polls the objects which notified, and those that can't, and returns the
+// number of ready objects
+STATIC mp_uint_t poll_poll_once(mp_obj_poll_t *self) {
+    for (poll_obj_t *poll_obj = self->ready; poll_obj != NULL; poll_obj = poll_obj->next_ready) {
+        poll_obj->flags_ret = 0;
+    }
+    self->ready = NULL;
+
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    poll_obj_t *dirty = self->dirty;
+    self->dirty = NULL;
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+
+    mp_uint_t n_ready = 0;
+    int errcode;
+    while (dirty != NULL) {
+        poll_obj_t *poll_obj = dirty;
+        dirty = poll_obj->next_dirty;
+        // a notification from now on queues it again
+        atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+        poll_obj->dirty = false;
+        MICROPY_END_ATOMIC_SECTION(atomic_state);
+        if (poll_obj->obj == MP_OBJ_NULL || poll_obj->polled) {
+            continue;
+        }
+        if (!poll_obj->notify.attached) {
+            // another poller took over the stream's notifier
+            poll_obj->polled = true;
+            self->n_polled += 1;
+            continue;
+        }
+        mp_uint_t ret = poll_obj_poll(self, poll_obj, &errcode);
+        if (ret == MP_STREAM_ERROR) {
+            // keep the objects that weren't polled yet queued
+            poll_obj_mark_dirty(poll_obj);
+            while (dirty != NULL) {
+                poll_obj = dirty;
+                dirty = poll_obj->next_dirty;
+                poll_obj->dirty = false;
+                poll_obj_mark_dirty(poll_obj);
+            }
+            mp_raise_OSError(errcode);
+        }
+        n_ready += ret != 0;
+    }
 
-STATIC mp_uint_t poll_poll_internal(uint n_args, const mp_obj_t *args) {
+    if (self->n_polled != 0) {
+        for (mp_uint_t i = 0; i < self->poll_map.alloc; ++i) {
+            if (!MP_MAP_SLOT_IS_FILLED(&self->poll_map, i)) {
+                continue;
+            }
+            poll_obj_t *poll_obj = (poll_obj_t*)self->poll_map.table[i].value;
+            if (poll_obj->polled) {
+                mp_uint_t ret = poll_obj_poll(self, poll_obj, &errcode);
+                if (ret == MP_STREAM_ERROR) {
+                    mp_raise_OSError(errcode);
+                }
+                n_ready += ret != 0;
+            }
+        }
+    }
+
+    return n_ready;
+}
+#endif
+
+STATIC mp_uint_t poll_poll_internal(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = args[0];
 
     // work out timeout (its given already in ms)
@@ -248,40 +430,74 @@ STATIC mp_uint_t poll_poll_internal(uint n_args, const mp_obj_t *args) {
     mp_uint_t n_ready;
     for (;;) {
         // poll the objects
+        #if MICROPY_PY_USELECT_NOTIFY
+        n_ready = poll_poll_once(self);
+        #else
         n_ready = poll_map_poll(&self->poll_map, NULL);
-        if (n_ready > 0 || (timeout != -1 && mp_hal_ticks_ms() - start_tick >= timeout)) {
+        #endif
+        mp_uint_t elapsed = mp_hal_ticks_ms() - start_tick;
+        if (n_ready > 0 || (timeout != (mp_uint_t)-1 && elapsed >= timeout)) {
             break;
         }
+        #if MICROPY_PY_USELECT_NOTIFY
+        if (self->n_polled == 0 && self->dirty == NULL) {
+            // nothing changes until a stream notifies
+            MICROPY_PY_USELECT_WAIT((void *volatile*)&self->dirty, timeout == (mp_uint_t)-1 ? -1 : (int)(timeout - elapsed));
+            continue;
+        }
+        #endif
         MICROPY_EVENT_POLL_HOOK
     }
 
     return n_ready;
 }
 
-STATIC mp_obj_t poll_poll(uint n_args, const mp_obj_t *args) {
+// Returns the (obj, flags) tuple for a ready object, or NULL for none
+STATIC mp_obj_t poll_ret_tuple(mp_obj_poll_t *self, poll_obj_t *poll_obj, mp_obj_t ret_tuple) {
+    if (poll_obj->flags_ret == 0) {
+        return MP_OBJ_NULL;
+    }
+    mp_obj_t tuple[2] = {poll_obj->obj, MP_OBJ_NEW_SMALL_INT(poll_obj->flags_ret)};
+    if (ret_tuple == MP_OBJ_NULL) {
+        ret_tuple = mp_obj_new_tuple(2, tuple);
+    } else {
+        mp_obj_tuple_t *t = MP_OBJ_TO_PTR(ret_tuple);
+        t->items[0] = tuple[0];
+        t->items[1] = tuple[1];
+    }
+    if (self->flags & FLAG_ONESHOT) {
+        // Don't poll next time, until new event flags will be set explicitly
+        poll_obj->flags = 0;
+    }
+    return ret_tuple;
+}
+
+STATIC mp_obj_t poll_poll(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = args[0];
     mp_uint_t n_ready = poll_poll_internal(n_args, args);
 
     // one or more objects are ready, or we had a timeout
     mp_obj_list_t *ret_list = mp_obj_new_list(n_ready, NULL);
     n_ready = 0;
+    #if MICROPY_PY_USELECT_NOTIFY
+    for (poll_obj_t *poll_obj = self->ready; poll_obj != NULL; poll_obj = poll_obj->next_ready) {
+        ret_list->items[n_ready++] = poll_ret_tuple(self, poll_obj, MP_OBJ_NULL);
+    }
+    #else
     for (mp_uint_t i = 0; i < self->poll_map.alloc; ++i) {
         if (!MP_MAP_SLOT_IS_FILLED(&self->poll_map, i)) {
             continue;
         }
         poll_obj_t *poll_obj = (poll_obj_t*)self->poll_map.table[i].value;
-        if (poll_obj->flags_ret != 0) {
-            mp_obj_t tuple[2] = {poll_obj->obj, MP_OBJ_NEW_SMALL_INT(poll_obj->flags_ret)};
-            ret_list->items[n_ready++] = mp_obj_new_tuple(2, tuple);
-            if (self->flags & FLAG_ONESHOT) {
-                // Don't poll next time, until new event flags will be set explicitly
-                poll_obj->flags = 0;
-            }
+        mp_obj_t t = poll_ret_tuple(self, poll_obj, MP_OBJ_NULL);
+        if (t != MP_OBJ_NULL) {
+            ret_list->items[n_ready++] = t;
         }
     }
+    #endif
     return ret_list;
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_poll_obj, 1, 3, poll_poll);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_poll_obj, 1, 3, poll_poll);
 
 STATIC mp_obj_t poll_ipoll(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -291,16 +507,33 @@ STATIC mp_obj_t poll_ipoll(size_t n_args, const mp_obj_t *args) {
     }
 
     int n_ready = poll_poll_internal(n_args, args);
+    #if MICROPY_PY_USELECT_NOTIFY
+    (void)n_ready;
+    self->iter_next = self->ready;
+    #else
     self->iter_cnt = n_ready;
     self->iter_idx = 0;
+    #endif
 
     return args[0];
 }
-MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_ipoll_obj, 1, 3, poll_ipoll);
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_ipoll_obj, 1, 3, poll_ipoll);
 
 STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
 
+    #if MICROPY_PY_USELECT_NOTIFY
+    while (self->iter_next != NULL) {
+        poll_obj_t *poll_obj = self->iter_next;
+        self->iter_next = poll_obj->next_ready;
+        // objects unregistered since the poll are skipped
+        mp_obj_t t = poll_ret_tuple(self, poll_obj, self->ret_tuple);
+        if (t != MP_OBJ_NULL) {
+            return t;
+        }
+    }
+    return MP_OBJ_STOP_ITERATION;
+    #else
     if (self->iter_cnt == 0) {
         return MP_OBJ_STOP_ITERATION;
     }
@@ -313,21 +546,16 @@ STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
             continue;
         }
         poll_obj_t *poll_obj = (poll_obj_t*)self->poll_map.table[i].value;
-        if (poll_obj->flags_ret != 0) {
-            mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
-            t->items[0] = poll_obj->obj;
-            t->items[1] = MP_OBJ_NEW_SMALL_INT(poll_obj->flags_ret);
-            if (self->flags & FLAG_ONESHOT) {
-                // Don't poll next time, until new event flags will be set explicitly
-                poll_obj->flags = 0;
-            }
-            return MP_OBJ_FROM_PTR(t);
+        mp_obj_t t = poll_ret_tuple(self, poll_obj, self->ret_tuple);
+        if (t != MP_OBJ_NULL) {
+            return t;
         }
     }
 
     assert(!"inconsistent number of poll active entries");
     self->iter_cnt = 0;
     return MP_OBJ_STOP_ITERATION;
+    #endif
 }
 
 STATIC const mp_rom_map_elem_t poll_locals_dict_table[] = {
@@ -352,14 +580,25 @@ STATIC mp_obj_t select_poll(void) {
     mp_obj_poll_t *poll = m_new_obj(mp_obj_poll_t);
     poll->base.type = &mp_type_poll;
     mp_map_init(&poll->poll_map, 0);
+    #if MICROPY_PY_USELECT_NOTIFY
+    poll->dirty = NULL;
+    poll->ready = NULL;
+    poll->iter_next = NULL;
+    poll->n_polled = 0;
+    #else
     poll->iter_cnt = 0;
+    #endif
     poll->ret_tuple = MP_OBJ_NULL;
     return poll;
 }
-MP_DEFINE_CONST_FUN_OBJ_0(mp_select_poll_obj, select_poll);
+STATIC MP_DEFINE_CONST_FUN_OBJ_0(mp_select_poll_obj, select_poll);
 
 STATIC const mp_rom_map_elem_t mp_module_select_globals_table[] = {
+    #if MICROPY_PY_USELECT
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uselect) },
+    #else
+    { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR__uselect_generic) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_select), MP_ROM_PTR(&mp_select_select_obj) },
     { MP_ROM_QSTR(MP_QSTR_poll), MP_ROM_PTR(&mp_select_poll_obj) },
     { MP_ROM_QSTR(MP_QSTR_POLLIN), MP_ROM_INT(MP_STREAM_POLL_RD) },
@@ -370,9 +609,13 @@ STATIC const mp_rom_map_elem_t mp_module_select_globals_table[] = {
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_select_globals, mp_module_select_globals_table);
 
+#if MICROPY_PY_USELECT
 const mp_obj_module_t mp_module_uselect = {
+#else
+const mp_obj_module_t mp_module_uselect_generic = {
+#endif
     .base = { &mp_type_module },
     .globals = (mp_obj_dict_t*)&mp_module_select_globals,
 };
 
-#endif // MICROPY_PY_USELECT
+#endif // MICROPY_PY_USELECT || MICROPY_PY_USELECT_GENERIC
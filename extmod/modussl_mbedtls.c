@@ -54,16 +54,29 @@ typedef struct _mp_obj_ssl_socket_t {
     mbedtls_x509_crt cacert;
     mbedtls_x509_crt cert;
     mbedtls_pk_context pkey;
+    // The session attribute, created when first read
+    mp_obj_t session;
+    // Events the underlying socket must be ready for before an unfinished
+    // handshake can make progress
+    uint8_t poll_mask;
 } mp_obj_ssl_socket_t;
 
+typedef struct _mp_obj_ssl_session_t {
+    mp_obj_base_t base;
+    mbedtls_ssl_session session;
+} mp_obj_ssl_session_t;
+
 struct ssl_args {
     mp_arg_val_t key;
     mp_arg_val_t cert;
     mp_arg_val_t server_side;
     mp_arg_val_t server_hostname;
+    mp_arg_val_t session;
+    mp_arg_val_t do_handshake;
 };
 
 STATIC const mp_obj_type_t ussl_socket_type;
+STATIC const mp_obj_type_t ussl_session_type;
 
 #ifdef MBEDTLS_DEBUG_C
 STATIC void mbedtls_debug(void *ctx, int level, const char *file, int line, const char *str) {
@@ -124,6 +137,8 @@ STATIC mp_obj_ssl_socket_t *socket_new(mp_obj_t sock, struct ssl_args *args) {
     mp_obj_ssl_socket_t *o = m_new_obj(mp_obj_ssl_socket_t);
 #endif
     o->base.type = &ussl_socket_type;
+    o->session = MP_OBJ_NULL;
+    o->poll_mask = 0;
 
     int ret;
     mbedtls_ssl_init(&o->ssl);
@@ -157,6 +172,13 @@ STATIC mp_obj_ssl_socket_t *socket_new(mp_obj_t sock, struct ssl_args *args) {
     #ifdef MBEDTLS_DEBUG_C
     mbedtls_ssl_conf_dbg(&o->conf, mbedtls_debug, NULL);
     #endif
+    #ifdef MBEDTLS_SSL_SESSION_TICKETS
+    if (!args->server_side.u_bool) {
+        // let the server hand out a ticket that a later connection can
+        // resume the session with, without the server keeping any state
+        mbedtls_ssl_conf_session_tickets(&o->conf, MBEDTLS_SSL_SESSION_TICKETS_ENABLED);
+    }
+    #endif
 
     ret = mbedtls_ssl_setup(&o->ssl, &o->conf);
     if (ret != 0) {
@@ -171,6 +193,15 @@ STATIC mp_obj_ssl_socket_t *socket_new(mp_obj_t sock, struct ssl_args *args) {
         }
     }
 
+    if (args->session.u_obj != mp_const_none) {
+        // the session is copied, so one session can be resumed many times
+        mp_obj_ssl_session_t *session = MP_OBJ_TO_PTR(args->session.u_obj);
+        ret = mbedtls_ssl_set_session(&o->ssl, &session->session);
+        if (ret != 0) {
+            goto cleanup;
+        }
+    }
+
     o->sock = sock;
     mbedtls_ssl_set_bio(&o->ssl, &o->sock, _mbedtls_ssl_send, _mbedtls_ssl_recv, NULL);
 
@@ -191,10 +222,14 @@ STATIC mp_obj_ssl_socket_t *socket_new(mp_obj_t sock, struct ssl_args *args) {
         assert(ret == 0);
     }
 
-    while ((ret = mbedtls_ssl_handshake(&o->ssl)) != 0) {
-        if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
-            printf("mbedtls_ssl_handshake error: -%x\n", -ret);
-            goto cleanup;
+    // with do_handshake=False the handshake is instead driven by do_handshake(),
+    // or by the first read or write
+    if (args->do_handshake.u_bool) {
+        while ((ret = mbedtls_ssl_handshake(&o->ssl)) != 0) {
+            if (ret != MBEDTLS_ERR_SSL_WANT_READ && ret != MBEDTLS_ERR_SSL_WANT_WRITE) {
+                printf("mbedtls_ssl_handshake error: -%x\n", -ret);
+                goto cleanup;
+            }
         }
     }
 
@@ -226,6 +261,62 @@ STATIC mp_obj_t mod_ssl_getpeercert(mp_obj_t o_in, mp_obj_t binary_form) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(mod_ssl_getpeercert_obj, mod_ssl_getpeercert);
 
+// Translates the result of a TLS operation that would block into the socket
+// events it waits for, and the error for the stream protocol
+STATIC int socket_would_block(mp_obj_ssl_socket_t *o, int ret) {
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ) {
+        o->poll_mask = MP_STREAM_POLL_RD;
+    } else if (ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+        o->poll_mask = MP_STREAM_POLL_WR;
+    } else {
+        return ret;
+    }
+    return MP_EWOULDBLOCK;
+}
+
+STATIC mp_obj_t socket_do_handshake(mp_obj_t self_in) {
+    mp_obj_ssl_socket_t *o = MP_OBJ_TO_PTR(self_in);
+    int ret = mbedtls_ssl_handshake(&o->ssl);
+    if (ret == 0) {
+        o->poll_mask = 0;
+        return mp_const_true;
+    }
+    ret = socket_would_block(o, ret);
+    if (ret == MP_EWOULDBLOCK) {
+        return mp_const_false;
+    }
+    // as with read and write, other errors keep the mbedtls code so that
+    // e.g. a failed certificate verification can be told apart
+    mp_raise_OSError(ret == MBEDTLS_ERR_SSL_ALLOC_FAILED ? MP_ENOMEM : ret);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(socket_do_handshake_obj, socket_do_handshake);
+
+STATIC mp_obj_t socket_get_session(mp_obj_ssl_socket_t *o) {
+    // there is only a session to export once a client has finished its handshake
+    if (o->ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER || o->conf.endpoint != MBEDTLS_SSL_IS_CLIENT) {
+        return mp_const_none;
+    }
+    // the handshake is only done once, so neither is the session, and it's
+    // exported just once to not leave copies to free
+    if (o->session != MP_OBJ_NULL) {
+        return o->session;
+    }
+#if MICROPY_PY_USSL_FINALISER
+    mp_obj_ssl_session_t *s = m_new_obj_with_finaliser(mp_obj_ssl_session_t);
+#else
+    mp_obj_ssl_session_t *s = m_new_obj(mp_obj_ssl_session_t);
+#endif
+    s->base.type = &ussl_session_type;
+    mbedtls_ssl_session_init(&s->session);
+    int ret = mbedtls_ssl_get_session(&o->ssl, &s->session);
+    if (ret != 0) {
+        mbedtls_ssl_session_free(&s->session);
+        mp_raise_OSError(ret == MBEDTLS_ERR_SSL_ALLOC_FAILED ? MP_ENOMEM : ret);
+    }
+    o->session = MP_OBJ_FROM_PTR(s);
+    return o->session;
+}
+
 STATIC void socket_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kind_t kind) {
     (void)kind;
     mp_obj_ssl_socket_t *self = MP_OBJ_TO_PTR(self_in);
@@ -241,12 +332,11 @@ STATIC mp_uint_t socket_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errc
         return 0;
     }
     if (ret >= 0) {
+        o->poll_mask = 0;
         return ret;
     }
-    if (ret == MBEDTLS_ERR_SSL_WANT_READ) {
-        ret = MP_EWOULDBLOCK;
-    }
-    *errcode = ret;
+    // a handshake in progress may also need to write
+    *errcode = socket_would_block(o, ret);
     return MP_STREAM_ERROR;
 }
 
@@ -255,12 +345,49 @@ STATIC mp_uint_t socket_write(mp_obj_t o_in, const void *buf, mp_uint_t size, in
 
     int ret = mbedtls_ssl_write(&o->ssl, buf, size);
     if (ret >= 0) {
+        o->poll_mask = 0;
         return ret;
     }
-    if (ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
-        ret = MP_EWOULDBLOCK;
+    *errcode = socket_would_block(o, ret);
+    return MP_STREAM_ERROR;
+}
+
+STATIC mp_uint_t socket_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_ssl_socket_t *o = MP_OBJ_TO_PTR(o_in);
+    mp_obj_t sock = o->sock;
+    const mp_stream_p_t *sock_stream = mp_get_stream_raise(sock, MP_STREAM_OP_IOCTL);
+
+    if (request == MP_STREAM_POLL) {
+        mp_uint_t ret = 0;
+        if ((arg & MP_STREAM_POLL_RD) && mbedtls_ssl_get_bytes_avail(&o->ssl) > 0) {
+            // decrypted data is already buffered
+            ret |= MP_STREAM_POLL_RD;
+        }
+        // While the handshake is unfinished, whichever operation is asked for
+        // can only progress once the socket is ready for what TLS waits for
+        mp_uint_t flags = arg;
+        if (o->poll_mask != 0 && o->ssl.state != MBEDTLS_SSL_HANDSHAKE_OVER) {
+            flags = o->poll_mask;
+        }
+        mp_uint_t sock_ret = sock_stream->ioctl(sock, MP_STREAM_POLL, flags, errcode);
+        if (sock_ret == MP_STREAM_ERROR) {
+            return MP_STREAM_ERROR;
+        }
+        if (flags != arg) {
+            if (sock_ret & flags) {
+                ret |= arg & (MP_STREAM_POLL_RD | MP_STREAM_POLL_WR);
+            }
+        } else {
+            ret |= sock_ret & (MP_STREAM_POLL_RD | MP_STREAM_POLL_WR);
+        }
+        return ret | (sock_ret & (MP_STREAM_POLL_ERR | MP_STREAM_POLL_HUP));
+    } else if (request == MP_STREAM_SET_POLL_NOTIFY || request == MP_STREAM_CLR_POLL_NOTIFY) {
+        // readiness only ever changes with that of the underlying socket
+        return sock_stream->ioctl(sock, request, arg, errcode);
     }
-    *errcode = ret;
+    // in particular the file descriptor isn't passed on, as reading and
+    // writing it directly would bypass TLS
+    *errcode = MP_EINVAL;
     return MP_STREAM_ERROR;
 }
 
@@ -300,13 +427,31 @@ STATIC const mp_rom_map_elem_t ussl_socket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&socket_close_obj) },
 #endif
     { MP_ROM_QSTR(MP_QSTR_getpeercert), MP_ROM_PTR(&mod_ssl_getpeercert_obj) },
+    { MP_ROM_QSTR(MP_QSTR_do_handshake), MP_ROM_PTR(&socket_do_handshake_obj) },
 };
 
 STATIC MP_DEFINE_CONST_DICT(ussl_socket_locals_dict, ussl_socket_locals_dict_table);
 
+STATIC void socket_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // attributes can't be stored or deleted
+        return;
+    }
+    if (attr == MP_QSTR_session) {
+        dest[0] = socket_get_session(MP_OBJ_TO_PTR(self_in));
+        return;
+    }
+    // the type has an attr handler, so methods must be looked up here
+    mp_map_elem_t *elem = mp_map_lookup((mp_map_t*)&ussl_socket_locals_dict.map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+    if (elem != NULL) {
+        mp_convert_member_lookup(self_in, &ussl_socket_type, elem->value, dest);
+    }
+}
+
 STATIC const mp_stream_p_t ussl_socket_stream_p = {
     .read = socket_read,
     .write = socket_write,
+    .ioctl = socket_ioctl,
 };
 
 STATIC const mp_obj_type_t ussl_socket_type = {
@@ -316,10 +461,34 @@ STATIC const mp_obj_type_t ussl_socket_type = {
     .print = socket_print,
     .getiter = NULL,
     .iternext = NULL,
+    .attr = socket_attr,
     .protocol = &ussl_socket_stream_p,
     .locals_dict = (void*)&ussl_socket_locals_dict,
 };
 
+#if MICROPY_PY_USSL_FINALISER
+STATIC mp_obj_t session_del(mp_obj_t self_in) {
+    mp_obj_ssl_session_t *self = MP_OBJ_TO_PTR(self_in);
+    mbedtls_ssl_session_free(&self->session);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(session_del_obj, session_del);
+
+STATIC const mp_rom_map_elem_t ussl_session_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&session_del_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(ussl_session_locals_dict, ussl_session_locals_dict_table);
+#endif
+
+STATIC const mp_obj_type_t ussl_session_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_SSLSession,
+    #if MICROPY_PY_USSL_FINALISER
+    .locals_dict = (void*)&ussl_session_locals_dict,
+    #endif
+};
+
 STATIC mp_obj_t mod_ssl_wrap_socket(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
     // TODO: Implement more args
     static const mp_arg_t allowed_args[] = {
@@ -327,6 +496,8 @@ STATIC mp_obj_t mod_ssl_wrap_socket(size_t n_args, const mp_obj_t *pos_args, mp_
         { MP_QSTR_cert, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
         { MP_QSTR_server_side, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = false} },
         { MP_QSTR_server_hostname, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_session, MP_ARG_KW_ONLY | MP_ARG_OBJ, {.u_obj = mp_const_none} },
+        { MP_QSTR_do_handshake, MP_ARG_KW_ONLY | MP_ARG_BOOL, {.u_bool = true} },
     };
 
     // TODO: Check that sock implements stream protocol
@@ -336,6 +507,12 @@ STATIC mp_obj_t mod_ssl_wrap_socket(size_t n_args, const mp_obj_t *pos_args, mp_
     mp_arg_parse_all(n_args - 1, pos_args + 1, kw_args,
         MP_ARRAY_SIZE(allowed_args), allowed_args, (mp_arg_val_t*)&args);
 
+    // only a client can resume a session
+    if (args.session.u_obj != mp_const_none
+        && (args.server_side.u_bool || !MP_OBJ_IS_TYPE(args.session.u_obj, &ussl_session_type))) {
+        mp_raise_ValueError(NULL);
+    }
+
     return MP_OBJ_FROM_PTR(socket_new(sock, &args));
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_KW(mod_ssl_wrap_socket_obj, 1, mod_ssl_wrap_socket);
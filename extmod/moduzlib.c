@@ -33,6 +33,8 @@
 
 #if MICROPY_PY_UZLIB
 
+#define TINF_FAST_BITS MICROPY_PY_UZLIB_FAST_BITS
+#define TINF_CRC32_SLICES MICROPY_PY_UZLIB_CRC32_SLICES
 #include "uzlib/tinf.h"
 
 #if 0 // print debugging info
@@ -153,19 +155,25 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
     mp_uint_t dest_buf_size = (bufinfo.len + 15) & ~15;
     byte *dest_buf = m_new(byte, dest_buf_size);
 
-    decomp->dest = dest_buf;
+    decomp->destStart = decomp->dest = dest_buf;
     decomp->destSize = dest_buf_size;
     DEBUG_printf("uzlib: Initial out buffer: " UINT_FMT " bytes\n", decomp->destSize);
     decomp->source = bufinfo.buf;
+    decomp->source_limit = decomp->source + bufinfo.len;
 
     int st;
-    bool is_zlib = true;
+    mp_int_t wbits = 0;
 
-    if (n_args > 1 && MP_OBJ_SMALL_INT_VALUE(args[1]) < 0) {
-        is_zlib = false;
+    if (n_args > 1) {
+        wbits = MP_OBJ_SMALL_INT_VALUE(args[1]);
     }
 
-    if (is_zlib) {
+    if (wbits >= 16) {
+        st = uzlib_gzip_parse_header(decomp);
+        if (st < 0) {
+            goto error;
+        }
+    } else if (wbits >= 0) {
         st = uzlib_zlib_parse_header(decomp);
         if (st < 0) {
             goto error;
@@ -180,11 +188,14 @@ STATIC mp_obj_t mod_uzlib_decompress(size_t n_args, const mp_obj_t *args) {
         if (st == TINF_DONE) {
             break;
         }
+        // grow by half, so the data is copied a bounded number of times
         size_t offset = decomp->dest - dest_buf;
-        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + 256);
-        dest_buf_size += 256;
+        size_t grow = dest_buf_size / 2 + 256;
+        dest_buf = m_renew(byte, dest_buf, dest_buf_size, dest_buf_size + grow);
+        dest_buf_size += grow;
+        decomp->destStart = dest_buf;
         decomp->dest = dest_buf + offset;
-        decomp->destSize = 256;
+        decomp->destSize = grow;
     }
 
     mp_uint_t final_sz = decomp->dest - dest_buf;
@@ -199,10 +210,204 @@ error:
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_decompress_obj, 1, 3, mod_uzlib_decompress);
 
+#if MICROPY_PY_UZLIB_COMPRESS
+
+// Parses wbits as for CPython's zlib: 9..15 for zlib, 25..31 (16 + 9..15) for
+// gzip and -9..-15 for raw deflate framing.  Returns log2 of the window size.
+STATIC int compress_parse_wbits(mp_int_t wbits, int *framing) {
+    *framing = TINF_CHKSUM_ADLER;
+    if (wbits < 0) {
+        *framing = TINF_CHKSUM_NONE;
+        wbits = -wbits;
+    } else if (wbits >= 16) {
+        *framing = TINF_CHKSUM_CRC;
+        wbits -= 16;
+    }
+    if (wbits < TDEFL_MIN_WBITS || wbits > TDEFL_MAX_WBITS) {
+        mp_raise_ValueError("wbits");
+    }
+    return wbits;
+}
+
+// level is -1 for the default, or 0 to 9
+STATIC mp_int_t compress_parse_level(mp_int_t level) {
+    if (level < -1 || level > 9) {
+        mp_raise_ValueError("level");
+    }
+    return level;
+}
+
+STATIC void compress_start(TDEFL_DATA *comp, int wbits, int framing, mp_int_t level, void *mem) {
+    uzlib_deflate_init(comp, wbits, level, mem);
+    if (framing == TINF_CHKSUM_ADLER) {
+        uzlib_zlib_write_header(comp);
+    } else if (framing == TINF_CHKSUM_CRC) {
+        uzlib_gzip_write_header(comp);
+    }
+}
+
+typedef struct _mp_obj_compio_t {
+    mp_obj_base_t base;
+    mp_obj_t dest_stream;
+    TDEFL_DATA comp;
+    bool closed;
+    byte wbits;
+    byte buf[MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE];
+} mp_obj_compio_t;
+
+STATIC void compio_write_dest(TDEFL_DATA *data) {
+    byte *p = (void*)data;
+    p -= offsetof(mp_obj_compio_t, comp);
+    mp_obj_compio_t *self = (mp_obj_compio_t*)p;
+
+    int err;
+    mp_uint_t len = data->dest - data->destStart;
+    data->dest = data->destStart;
+    mp_stream_write_exactly(self->dest_stream, data->destStart, len, &err);
+    if (err != 0) {
+        mp_raise_OSError(err);
+    }
+}
+
+STATIC mp_obj_t compio_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 3, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_WRITE);
+    int framing;
+    int wbits = compress_parse_wbits(n_args > 1 ? mp_obj_get_int(args[1]) : 10, &framing);
+    mp_int_t level = compress_parse_level(n_args > 2 ? mp_obj_get_int(args[2]) : -1);
+
+    mp_obj_compio_t *o = m_new_obj(mp_obj_compio_t);
+    o->base.type = type;
+    o->dest_stream = args[0];
+    o->closed = false;
+    o->wbits = wbits;
+    o->comp.destStart = o->comp.dest = o->buf;
+    o->comp.destSize = sizeof(o->buf);
+    o->comp.writeDest = compio_write_dest;
+    compress_start(&o->comp, wbits, framing, level, m_new(byte, TDEFL_MEM_SIZE(wbits)));
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_uint_t compio_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    if (o->closed) {
+        *errcode = MP_EINVAL;
+        return MP_STREAM_ERROR;
+    }
+    uzlib_deflate(&o->comp, buf, size, TDEFL_NO_FLUSH);
+    return size;
+}
+
+// Writes out all the compressed data buffered so far
+STATIC void compio_flush(mp_obj_compio_t *o, int flush) {
+    uzlib_deflate(&o->comp, NULL, 0, flush);
+    if (o->comp.dest != o->comp.destStart) {
+        compio_write_dest(&o->comp);
+    }
+}
+
+STATIC mp_uint_t compio_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(o_in);
+    (void)arg;
+    if (request == MP_STREAM_FLUSH) {
+        if (!o->closed) {
+            compio_flush(o, TDEFL_SYNC_FLUSH);
+        }
+        return 0;
+    }
+    *errcode = MP_EINVAL;
+    return MP_STREAM_ERROR;
+}
+
+STATIC mp_obj_t compio_close(mp_obj_t self_in) {
+    mp_obj_compio_t *o = MP_OBJ_TO_PTR(self_in);
+    if (!o->closed) {
+        o->closed = true;
+        compio_flush(o, TDEFL_FINISH);
+        m_del(byte, o->comp.window, TDEFL_MEM_SIZE(o->wbits));
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(compio_close_obj, compio_close);
+
+STATIC mp_obj_t compio___exit__(size_t n_args, const mp_obj_t *args) {
+    (void)n_args;
+    return compio_close(args[0]);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(compio___exit___obj, 4, 4, compio___exit__);
+
+STATIC const mp_rom_map_elem_t compio_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_write), MP_ROM_PTR(&mp_stream_write_obj) },
+    { MP_ROM_QSTR(MP_QSTR_flush), MP_ROM_PTR(&mp_stream_flush_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&compio_close_obj) },
+    { MP_ROM_QSTR(MP_QSTR___enter__), MP_ROM_PTR(&mp_identity_obj) },
+    { MP_ROM_QSTR(MP_QSTR___exit__), MP_ROM_PTR(&compio___exit___obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(compio_locals_dict, compio_locals_dict_table);
+
+STATIC const mp_stream_p_t compio_stream_p = {
+    .write = compio_write,
+    .ioctl = compio_ioctl,
+};
+
+STATIC const mp_obj_type_t compio_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_CompressIO,
+    .make_new = compio_make_new,
+    .protocol = &compio_stream_p,
+    .locals_dict = (void*)&compio_locals_dict,
+};
+
+typedef struct _compress_vstr_t {
+    TDEFL_DATA comp;
+    vstr_t vstr;
+} compress_vstr_t;
+
+// Keeps the output buffer at the free end of the vstr, growing it as needed
+STATIC void compress_write_vstr(TDEFL_DATA *data) {
+    compress_vstr_t *c = (compress_vstr_t*)data;
+    c->vstr.len += data->dest - data->destStart;
+    vstr_hint_size(&c->vstr, c->vstr.alloc / 2 + 16);
+    data->destStart = data->dest = (byte*)c->vstr.buf + c->vstr.len;
+    data->destSize = c->vstr.alloc - c->vstr.len;
+}
+
+STATIC mp_obj_t mod_uzlib_compress(size_t n_args, const mp_obj_t *args) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(args[0], &bufinfo, MP_BUFFER_READ);
+    mp_int_t level = compress_parse_level(n_args > 1 ? mp_obj_get_int(args[1]) : -1);
+    int framing;
+    int wbits = compress_parse_wbits(n_args > 2 ? mp_obj_get_int(args[2]) : 15, &framing);
+    // a window larger than the data doesn't help
+    while (wbits > TDEFL_MIN_WBITS && (1u << (wbits - 1)) >= bufinfo.len) {
+        wbits--;
+    }
+
+    compress_vstr_t c;
+    vstr_init(&c.vstr, bufinfo.len / 2 + 16);
+    c.comp.destStart = c.comp.dest = (byte*)c.vstr.buf;
+    c.comp.destSize = c.vstr.alloc;
+    c.comp.writeDest = compress_write_vstr;
+    byte *mem = m_new(byte, TDEFL_MEM_SIZE(wbits));
+    compress_start(&c.comp, wbits, framing, level, mem);
+    uzlib_deflate(&c.comp, bufinfo.buf, bufinfo.len, TDEFL_FINISH);
+    c.vstr.len += c.comp.dest - c.comp.destStart;
+    m_del(byte, mem, TDEFL_MEM_SIZE(wbits));
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &c.vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mod_uzlib_compress_obj, 1, 3, mod_uzlib_compress);
+
+#endif // MICROPY_PY_UZLIB_COMPRESS
+
 STATIC const mp_rom_map_elem_t mp_module_uzlib_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_uzlib) },
     { MP_ROM_QSTR(MP_QSTR_decompress), MP_ROM_PTR(&mod_uzlib_decompress_obj) },
     { MP_ROM_QSTR(MP_QSTR_DecompIO), MP_ROM_PTR(&decompio_type) },
+    #if MICROPY_PY_UZLIB_COMPRESS
+    { MP_ROM_QSTR(MP_QSTR_compress), MP_ROM_PTR(&mod_uzlib_compress_obj) },
+    { MP_ROM_QSTR(MP_QSTR_CompressIO), MP_ROM_PTR(&compio_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_uzlib_globals, mp_module_uzlib_globals_table);
@@ -220,5 +425,8 @@ const mp_obj_module_t mp_module_uzlib = {
 #include "uzlib/tinfgzip.c"
 #include "uzlib/adler32.c"
 #include "uzlib/crc32.c"
+#if MICROPY_PY_UZLIB_COMPRESS
+#include "uzlib/tdeflate.c"
+#endif
 
 #endif // MICROPY_PY_UZLIB
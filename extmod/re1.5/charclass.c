@@ -31,3 +31,22 @@ int _re1_5_namedclassmatch(const char *pc, const char *sp)
     }
     return off;
 }
+
+// Returns the instruction after the consumer at pc if it matches the char at
+// sp, nil if it doesn't
+const char *_re1_5_step(const char *pc, const char *sp)
+{
+    switch (*pc) {
+    case Char:
+        return *sp == pc[1] ? pc + 2 : nil;
+    case Any:
+        return pc + 1;
+    case Class:
+    case ClassNot:
+        return _re1_5_classmatch(pc + 1, sp) ? pc + 2 + *(unsigned char*)(pc + 1) * 2 : nil;
+    case NamedClass:
+        return _re1_5_namedclassmatch(pc + 1, sp) ? pc + 2 : nil;
+    }
+    re1_5_fatal("step");
+    return nil;
+}
@@ -0,0 +1,298 @@
+// Copyright 2026 The MicroPython contributors.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Lazily built DFA, which only says whether the program matches a subject.
+// Each state is the set of consumer, Eol and Match instructions that are live
+// at a position of the subject.  States and their transitions are built as
+// the subject needs them and cached for later subjects; bytes that no
+// instruction tells apart share a column of the transition table.  When the
+// cache fills up it is flushed, and if that happens too often the caller is
+// told to use one of the other matchers instead.
+
+#define DFA_MATCH 1
+#define DFA_MATCH_AT_END 2
+
+// A full cache is only flushed once it has served this many bytes, counted
+// across calls; until then the caller is told to use another matcher
+#define DFA_FLUSH_BYTES (10 * RE1_5_DFA_STATES)
+
+typedef struct DState DState;
+
+struct DState {
+    unsigned short first; // index of the first pc of the state in pcs
+    unsigned short n;
+    unsigned char flags;
+};
+
+typedef struct DFA DFA;
+
+struct DFA {
+    int ncls;
+    int nstates;
+    int npcs;
+    int max_pcs;
+    int since_flush; // bytes gone over since the last flush, up to DFA_FLUSH_BYTES
+    unsigned char start[4]; // state + 1 to start a search or a match at, 0 if not built
+    unsigned char cls[256];
+    DState states[RE1_5_DFA_STATES];
+    unsigned short *pcs;
+    unsigned short *set; // the state being built
+    unsigned short *stack;
+    unsigned char *mark;
+    unsigned char *trans; // state + 1 for each state and byte class, 0 if not built
+};
+
+static int inst_len(const char *pc)
+{
+    switch (*pc) {
+    case Any:
+    case Bol:
+    case Eol:
+    case Match:
+        return 1;
+    case Class:
+    case ClassNot:
+        return 2 + *(unsigned char*)(pc + 1) * 2;
+    default:
+        return 2;
+    }
+}
+
+// Bytes are in the same class if every consumer instruction treats them alike
+static int byteclasses(ByteProg *prog, unsigned char *cls)
+{
+    char rep[256];
+    int ncls = 0;
+    const char *end = prog->insts + prog->bytelen;
+    for (int b = 0; b < 256; b++) {
+        char c = b;
+        int k;
+        for (k = 0; k < ncls; k++) {
+            const char *pc;
+            for (pc = prog->insts; pc < end; pc += inst_len(pc)) {
+                if (inst_is_consumer(*pc) && (_re1_5_step(pc, &c) == nil) != (_re1_5_step(pc, &rep[k]) == nil)) {
+                    break;
+                }
+            }
+            if (pc >= end) {
+                break;
+            }
+        }
+        if (k == ncls) {
+            rep[ncls++] = c;
+        }
+        cls[b] = k;
+    }
+    return ncls;
+}
+
+int re1_5_dfa_size(ByteProg *prog)
+{
+    unsigned char cls[256];
+    int ncls = byteclasses(prog, cls);
+    return sizeof(DFA)
+        + (RE1_5_DFA_STATES * prog->len + 2 * prog->len + prog->bytelen) * sizeof(unsigned short)
+        + RE1_5_DFA_STATES * ncls + prog->bytelen;
+}
+
+static void flush(DFA *d)
+{
+    d->nstates = 0;
+    d->npcs = 0;
+    d->since_flush = 0;
+    memset(d->start, 0, sizeof(d->start));
+    memset(d->trans, 0, RE1_5_DFA_STATES * d->ncls);
+}
+
+void re1_5_dfa_init(ByteProg *prog, void *dfa)
+{
+    DFA *d = dfa;
+    d->ncls = byteclasses(prog, d->cls);
+    d->max_pcs = RE1_5_DFA_STATES * prog->len;
+    d->pcs = (unsigned short*)(d + 1);
+    d->set = d->pcs + d->max_pcs;
+    d->stack = d->set + 2 * prog->len;
+    d->trans = (unsigned char*)(d->stack + prog->bytelen);
+    d->mark = d->trans + RE1_5_DFA_STATES * d->ncls;
+    flush(d);
+}
+
+// Adds the instructions reachable from pc without consuming input to set,
+// which has n entries.  The caller clears mark once per set.
+static int closure(ByteProg *prog, DFA *d, unsigned short *set, int n, int pc, int at_begin, int at_end)
+{
+    int sp = 0;
+    if (d->mark[pc]) {
+        return n;
+    }
+    d->mark[pc] = 1;
+    d->stack[sp++] = pc;
+    while (sp > 0) {
+        pc = d->stack[--sp];
+        const char *code = prog->insts + pc;
+        int next[2];
+        int nnext = 0;
+        switch (*code) {
+        case Jmp:
+            next[nnext++] = pc + 2 + (signed char)code[1];
+            break;
+        case Split:
+        case RSplit:
+            next[nnext++] = pc + 2;
+            next[nnext++] = pc + 2 + (signed char)code[1];
+            break;
+        case Save:
+            next[nnext++] = pc + 2;
+            break;
+        case Bol:
+            if (at_begin) {
+                next[nnext++] = pc + 1;
+            }
+            break;
+        case Eol:
+            if (at_end) {
+                next[nnext++] = pc + 1;
+                break;
+            }
+            // whether it holds is only known at the end, so keep it
+            set[n++] = pc;
+            break;
+        default:
+            set[n++] = pc;
+            break;
+        }
+        for (int i = 0; i < nnext; i++) {
+            if (!d->mark[next[i]]) {
+                d->mark[next[i]] = 1;
+                d->stack[sp++] = next[i];
+            }
+        }
+    }
+    return n;
+}
+
+// Returns the state + 1 for the n pcs in d->set, adding it if it's new, or 0
+// if the cache is full
+static int addstate(ByteProg *prog, DFA *d, int n)
+{
+    unsigned short *set = d->set;
+    for (int i = 1; i < n; i++) {
+        unsigned short pc = set[i];
+        int j;
+        for (j = i; j > 0 && set[j - 1] > pc; j--) {
+            set[j] = set[j - 1];
+        }
+        set[j] = pc;
+    }
+    for (int s = 0; s < d->nstates; s++) {
+        DState *st = &d->states[s];
+        if (st->n == n && memcmp(d->pcs + st->first, set, n * sizeof(*set)) == 0) {
+            return s + 1;
+        }
+    }
+    if (d->nstates == RE1_5_DFA_STATES || d->npcs + n > d->max_pcs) {
+        return 0;
+    }
+
+    DState *st = &d->states[d->nstates];
+    st->first = d->npcs;
+    st->n = n;
+    st->flags = 0;
+    memcpy(d->pcs + d->npcs, set, n * sizeof(*set));
+    d->npcs += n;
+
+    // see whether the Eol instructions of the state lead to a match at the end
+    unsigned short *end_set = set + prog->len;
+    int end_n = 0;
+    memset(d->mark, 0, prog->bytelen);
+    for (int i = 0; i < n; i++) {
+        char op = prog->insts[set[i]];
+        if (op == Match) {
+            st->flags |= DFA_MATCH;
+        } else if (op == Eol) {
+            end_n = closure(prog, d, end_set, end_n, set[i], 0, 1);
+        }
+    }
+    for (int i = 0; i < end_n; i++) {
+        if (prog->insts[end_set[i]] == Match) {
+            st->flags |= DFA_MATCH_AT_END;
+        }
+    }
+    return ++d->nstates;
+}
+
+int re1_5_dfamatch(ByteProg *prog, void *dfa, Subject *input, int is_anchored)
+{
+    DFA *d = dfa;
+    if (input->begin == input->end) {
+        // ^ and $ both hold here, which the states don't account for
+        return -1;
+    }
+
+    int at_begin = input->begin == input->begin_line;
+    unsigned char *start = &d->start[is_anchored * 2 + at_begin];
+    int s = *start;
+    if (s == 0) {
+        memset(d->mark, 0, prog->bytelen);
+        int n = closure(prog, d, d->set, 0, HANDLE_ANCHORED(prog->insts, is_anchored) - prog->insts, at_begin, 0);
+        s = addstate(prog, d, n);
+        if (s == 0) {
+            flush(d);
+            s = addstate(prog, d, n);
+        }
+        *start = s;
+    }
+
+    for (const char *sp = input->begin; sp < input->end; sp++) {
+        DState *st = &d->states[s - 1];
+        if (st->flags & DFA_MATCH) {
+            return 1;
+        }
+        if (st->n == 0) {
+            return 0;
+        }
+        unsigned char *t = &d->trans[(s - 1) * d->ncls + d->cls[(unsigned char)*sp]];
+        if (*t != 0) {
+            s = *t;
+            if (d->since_flush < DFA_FLUSH_BYTES) {
+                d->since_flush++;
+            }
+            continue;
+        }
+
+        // a transition not seen before
+        int n = 0;
+        memset(d->mark, 0, prog->bytelen);
+        for (int i = 0; i < st->n; i++) {
+            const char *pc = prog->insts + d->pcs[st->first + i];
+            if (inst_is_consumer(*pc) && (pc = _re1_5_step(pc, sp)) != nil) {
+                n = closure(prog, d, d->set, n, pc - prog->insts, 0, 0);
+            }
+        }
+        int next = addstate(prog, d, n);
+        if (next == 0) {
+            if (d->since_flush < DFA_FLUSH_BYTES) {
+                // the other matcher goes over the rest of the subject, which
+                // also counts towards flushing
+                int left = input->end - sp;
+                if (left > DFA_FLUSH_BYTES - d->since_flush) {
+                    left = DFA_FLUSH_BYTES - d->since_flush;
+                }
+                d->since_flush += left;
+                return -1;
+            }
+            flush(d);
+            s = addstate(prog, d, n);
+            continue;
+        }
+        *t = next;
+        s = next;
+        if (d->since_flush < DFA_FLUSH_BYTES) {
+            d->since_flush++;
+        }
+    }
+    return (d->states[s - 1].flags & (DFA_MATCH | DFA_MATCH_AT_END)) != 0;
+}
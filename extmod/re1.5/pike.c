@@ -0,0 +1,141 @@
+// Copyright 2026 The MicroPython contributors.
+// The Pike VM follows the design of pike.c in Russ Cox's re1.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+#include "re1.5.h"
+
+// Pike VM: all threads of the program run in lock step over the subject, so
+// matching time is linear in the length of the subject and the recursion
+// depth is bounded by the size of the program, not of the subject.  Threads
+// are kept in priority order, which gives the same submatches as the
+// backtracking matchers.
+
+typedef struct ThreadList ThreadList;
+
+struct ThreadList {
+    int n;
+    unsigned short *pc;
+    const char **caps;
+};
+
+typedef struct PikeVM PikeVM;
+
+struct PikeVM {
+    ByteProg *prog;
+    Subject *input;
+    int nsubp;
+    unsigned int gen;
+    unsigned int *mark;
+};
+
+// Follows pc through the instructions that don't consume input and adds the
+// ones that do (and Match) to l, with the captures they would have at sp.
+static void addthread(PikeVM *vm, ThreadList *l, int pc, const char *sp, const char **caps)
+{
+    re1_5_stack_chk();
+
+    for (;;) {
+        if (vm->mark[pc] == vm->gen) {
+            // a higher priority thread already got here
+            return;
+        }
+        vm->mark[pc] = vm->gen;
+        const char *code = vm->prog->insts + pc;
+        int off;
+        switch (*code) {
+        case Jmp:
+            pc += 2 + (signed char)code[1];
+            continue;
+        case Split:
+            addthread(vm, l, pc + 2, sp, caps);
+            pc += 2 + (signed char)code[1];
+            continue;
+        case RSplit:
+            addthread(vm, l, pc + 2 + (signed char)code[1], sp, caps);
+            pc += 2;
+            continue;
+        case Save:
+            off = (unsigned char)code[1];
+            if (off < vm->nsubp) {
+                const char *old = caps[off];
+                caps[off] = sp;
+                addthread(vm, l, pc + 2, sp, caps);
+                caps[off] = old;
+                return;
+            }
+            pc += 2;
+            continue;
+        case Bol:
+            if (sp != vm->input->begin_line) {
+                return;
+            }
+            pc++;
+            continue;
+        case Eol:
+            if (sp != vm->input->end) {
+                return;
+            }
+            pc++;
+            continue;
+        default:
+            l->pc[l->n] = pc;
+            memcpy(l->caps + l->n * vm->nsubp, caps, vm->nsubp * sizeof(*caps));
+            l->n++;
+            return;
+        }
+    }
+}
+
+int re1_5_pikevm_size(ByteProg *prog, int nsubp)
+{
+    return (2 * prog->len + 1) * nsubp * sizeof(const char*)
+        + prog->bytelen * sizeof(unsigned int)
+        + 2 * prog->len * sizeof(unsigned short);
+}
+
+int re1_5_pikevm(ByteProg *prog, void *ws, Subject *input, const char **subp, int nsubp, int is_anchored)
+{
+    PikeVM vm = { prog, input, nsubp, 1, NULL };
+    ThreadList clist, nlist, tmp;
+    const char **caps = ws;
+    clist.caps = caps;
+    nlist.caps = caps + prog->len * nsubp;
+    caps += 2 * prog->len * nsubp;
+    vm.mark = (unsigned int*)(caps + nsubp);
+    clist.pc = (unsigned short*)(vm.mark + prog->bytelen);
+    nlist.pc = clist.pc + prog->len;
+    memset(caps, 0, nsubp * sizeof(*caps));
+    memset(vm.mark, 0, prog->bytelen * sizeof(*vm.mark));
+
+    int matched = 0;
+    clist.n = 0;
+    addthread(&vm, &clist, HANDLE_ANCHORED(prog->insts, is_anchored) - prog->insts, input->begin, caps);
+    for (const char *sp = input->begin; clist.n > 0; sp++) {
+        vm.gen++;
+        nlist.n = 0;
+        for (int i = 0; i < clist.n; i++) {
+            const char *pc = prog->insts + clist.pc[i];
+            caps = clist.caps + i * nsubp;
+            if (*pc == Match) {
+                // lower priority threads are cut off by this match
+                matched = 1;
+                memcpy(subp, caps, nsubp * sizeof(*caps));
+                break;
+            }
+            if (sp < input->end) {
+                pc = _re1_5_step(pc, sp);
+                if (pc != nil) {
+                    addthread(&vm, &nlist, pc - prog->insts, sp + 1, caps);
+                }
+            }
+        }
+        tmp = clist;
+        clist = nlist;
+        nlist = tmp;
+        if (sp == input->end) {
+            break;
+        }
+    }
+    return matched;
+}
@@ -132,6 +132,7 @@ void decref(Sub*);
 struct Subject {
 	const char *begin;
 	const char *end;
+	const char *begin_line; // where ^ matches, which can be before begin
 };
 
 
@@ -139,7 +140,8 @@ struct Subject {
 #define HANDLE_ANCHORED(bytecode, is_anchored) ((is_anchored) ? (bytecode) + NON_ANCHORED_PREFIX : (bytecode))
 
 int re1_5_backtrack(ByteProg*, Subject*, const char**, int, int);
-int re1_5_pikevm(ByteProg*, Subject*, const char**, int, int);
+int re1_5_pikevm_size(ByteProg*, int);
+int re1_5_pikevm(ByteProg*, void*, Subject*, const char**, int, int);
 int re1_5_recursiveloopprog(ByteProg*, Subject*, const char**, int, int);
 int re1_5_recursiveprog(ByteProg*, Subject*, const char**, int, int);
 int re1_5_thompsonvm(ByteProg*, Subject*, const char**, int, int);
@@ -150,5 +152,14 @@ void re1_5_dumpcode(ByteProg *prog);
 void cleanmarks(ByteProg *prog);
 int _re1_5_classmatch(const char *pc, const char *sp);
 int _re1_5_namedclassmatch(const char *pc, const char *sp);
+const char *_re1_5_step(const char *pc, const char *sp);
+
+#ifndef RE1_5_DFA_STATES
+#define RE1_5_DFA_STATES 32
+#endif
+
+int re1_5_dfa_size(ByteProg *prog);
+void re1_5_dfa_init(ByteProg *prog, void *dfa);
+int re1_5_dfamatch(ByteProg *prog, void *dfa, Subject *input, int is_anchored);
 
 #endif /*_RE1_5_REGEXP__H*/
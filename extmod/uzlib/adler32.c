@@ -51,27 +51,39 @@ uint32_t uzlib_adler32(const void *data, unsigned int length, uint32_t prev_sum
    while (length > 0)
    {
       int k = length < A32_NMAX ? length : A32_NMAX;
-      int i;
 
-      for (i = k / 16; i; --i, buf += 16)
+      length -= k;
+
+      for (; k && ((uintptr_t)buf & 3); --k) { s1 += *buf++; s2 += s1; }
+
+      /* 64 bytes at a time, an aligned word at a time: a and b sum bytes 0,
+         2 and 1, 3 of the words in 16-bit lanes, and pa and pb sum a and b
+         after each word.  Over the block s2 gains s1 for each byte, plus
+         each byte times its distance from the end of the block. */
+      for (; k >= 64; k -= 64)
       {
-         s1 += buf[0];  s2 += s1; s1 += buf[1];  s2 += s1;
-         s1 += buf[2];  s2 += s1; s1 += buf[3];  s2 += s1;
-         s1 += buf[4];  s2 += s1; s1 += buf[5];  s2 += s1;
-         s1 += buf[6];  s2 += s1; s1 += buf[7];  s2 += s1;
+         uint32_t a = 0, b = 0, pa = 0, pb = 0;
+         int i;
 
-         s1 += buf[8];  s2 += s1; s1 += buf[9];  s2 += s1;
-         s1 += buf[10]; s2 += s1; s1 += buf[11]; s2 += s1;
-         s1 += buf[12]; s2 += s1; s1 += buf[13]; s2 += s1;
-         s1 += buf[14]; s2 += s1; s1 += buf[15]; s2 += s1;
+         for (i = 0; i < 16; ++i, buf += 4)
+         {
+            uint32_t w = tinf_get_le32_aligned(buf);
+            a += w & 0x00ff00ff;
+            b += (w >> 8) & 0x00ff00ff;
+            pa += a;
+            pb += b;
+         }
+
+         s2 += (s1 << 6)
+            + (((pa & 0xffff) + (pa >> 16) + (pb & 0xffff) + (pb >> 16)) << 2)
+            - ((b & 0xffff) + ((a >> 16) << 1) + (b >> 16) * 3);
+         s1 += (a & 0xffff) + (a >> 16) + (b & 0xffff) + (b >> 16);
       }
 
-      for (i = k % 16; i; --i) { s1 += *buf++; s2 += s1; }
+      for (; k; --k) { s1 += *buf++; s2 += s1; }
 
       s1 %= A32_BASE;
       s2 %= A32_BASE;
-
-      length -= k;
    }
 
    return (s2 << 16) | s1;
@@ -0,0 +1,422 @@
+/*
+ * tdeflate  -  tiny deflate
+ *
+ * Copyright (c) 2014-2016 by Paul Sokolovsky
+ *
+ * This software is provided 'as-is', without any express
+ * or implied warranty.  In no event will the authors be
+ * held liable for any damages arising from the use of
+ * this software.
+ *
+ * Permission is granted to anyone to use this software
+ * for any purpose, including commercial applications,
+ * and to alter it and redistribute it freely, subject to
+ * the following restrictions:
+ *
+ * 1. The origin of this software must not be
+ *    misrepresented; you must not claim that you
+ *    wrote the original software. If you use this
+ *    software in a product, an acknowledgment in
+ *    the product documentation would be appreciated
+ *    but is not required.
+ *
+ * 2. Altered source versions must be plainly marked
+ *    as such, and must not be misrepresented as
+ *    being the original software.
+ *
+ * 3. This notice may not be removed or altered from
+ *    any source distribution.
+ */
+
+/*
+ * LZ77 with hash chains, over a window that slides by half its size when
+ * it fills up, and optionally lazy matching like zlib's.  Symbols are
+ * coded with the fixed Huffman codes, so nothing needs to be buffered
+ * besides the window: the memory used is 4 bytes per byte of window plus
+ * the hash table heads.
+ */
+
+#include <string.h>
+#include "tinf.h"
+
+#define MIN_MATCH 3
+#define MAX_MATCH 258
+/* lookahead that lets a match of any length be found */
+#define MIN_LOOKAHEAD (MAX_MATCH + MIN_MATCH + 1)
+/* a match of MIN_MATCH bytes further away than this costs more than literals */
+#define TOO_FAR 4096
+
+/* search parameters for each level */
+static const struct {
+    unsigned short max_chain;
+    unsigned short nice_len;
+    unsigned char lazy;
+} tdefl_levels[10] = {
+    {0, 0, 0},
+    {4, 8, 0},
+    {8, 16, 0},
+    {16, 32, 0},
+    {16, 32, 1},
+    {32, 64, 1},
+    {64, 128, 1},
+    {128, 258, 1},
+    {512, 258, 1},
+    {2048, 258, 1},
+};
+
+/* bit-reversed nibbles */
+static const unsigned char tdefl_rev4[16] = {
+    0x0, 0x8, 0x4, 0xc, 0x2, 0xa, 0x6, 0xe,
+    0x1, 0x9, 0x5, 0xd, 0x3, 0xb, 0x7, 0xf
+};
+
+/* ------------------ *
+ * -- output bits -- *
+ * ------------------ */
+
+static void tdefl_outbyte(TDEFL_DATA *d, unsigned char c)
+{
+    *d->dest++ = c;
+    if (d->dest == d->destStart + d->destSize) {
+        d->writeDest(d);
+    }
+}
+
+static void tdefl_outbits(TDEFL_DATA *d, uint32_t bits, int n)
+{
+    d->outbits |= bits << d->noutbits;
+    d->noutbits += n;
+    while (d->noutbits >= 8) {
+        tdefl_outbyte(d, d->outbits);
+        d->outbits >>= 8;
+        d->noutbits -= 8;
+    }
+}
+
+/* Huffman codes are sent from their most significant bit */
+static void tdefl_outcode(TDEFL_DATA *d, unsigned int code, int n)
+{
+    unsigned int rev = tdefl_rev4[code & 0xf] << 12 | tdefl_rev4[(code >> 4) & 0xf] << 8
+        | tdefl_rev4[(code >> 8) & 0xf] << 4 | tdefl_rev4[code >> 12];
+    tdefl_outbits(d, rev >> (16 - n), n);
+}
+
+static void tdefl_align(TDEFL_DATA *d)
+{
+    if (d->noutbits > 0) {
+        tdefl_outbits(d, 0, 8 - d->noutbits);
+    }
+}
+
+/* a symbol of the fixed literal/length code */
+static void tdefl_outsym(TDEFL_DATA *d, unsigned int sym)
+{
+    if (sym < 144) {
+        tdefl_outcode(d, 0x30 + sym, 8);
+    } else if (sym < 256) {
+        tdefl_outcode(d, 0x190 + sym - 144, 9);
+    } else if (sym < 280) {
+        tdefl_outcode(d, sym - 256, 7);
+    } else {
+        tdefl_outcode(d, 0xc0 + sym - 280, 8);
+    }
+}
+
+static int tdefl_log2(unsigned int v)
+{
+    int n = 0;
+    while (v >>= 1) {
+        n++;
+    }
+    return n;
+}
+
+static void tdefl_outmatch(TDEFL_DATA *d, unsigned int len, unsigned int dist)
+{
+    /* length codes 265 and up cover 4 lengths per number of extra bits */
+    unsigned int v = len - MIN_MATCH;
+    if (len == MAX_MATCH) {
+        tdefl_outsym(d, 285);
+    } else if (v < 8) {
+        tdefl_outsym(d, 257 + v);
+    } else {
+        int extra = tdefl_log2(v) - 2;
+        tdefl_outsym(d, 257 + 4 * (extra + 1) + ((v >> extra) & 3));
+        tdefl_outbits(d, v & ((1 << extra) - 1), extra);
+    }
+
+    /* distance codes 4 and up cover 2 distances per number of extra bits */
+    v = dist - 1;
+    if (v < 4) {
+        tdefl_outcode(d, v, 5);
+    } else {
+        int extra = tdefl_log2(v) - 1;
+        tdefl_outcode(d, 2 * (extra + 1) + ((v >> extra) & 1), 5);
+        tdefl_outbits(d, v & ((1 << extra) - 1), extra);
+    }
+}
+
+/* ------------------- *
+ * -- match finding -- *
+ * ------------------- */
+
+/* adds position p to the hash chains and returns the previous position with
+   the same hash, 0 if none */
+static unsigned int tdefl_insert(TDEFL_DATA *d, unsigned int p)
+{
+    const unsigned char *s = d->window + p;
+    uint32_t h = ((uint32_t)(s[0] << 16 | s[1] << 8 | s[2]) * 2654435761u) >> (32 - d->hash_bits);
+    unsigned int cur = d->head[h];
+    d->prev[p & (d->wsize - 1)] = cur;
+    d->head[h] = p;
+    return cur;
+}
+
+/* returns the length of the longest match at pos along the chain from cur,
+   if longer than best, and sets *dist to its distance */
+static unsigned int tdefl_longest_match(TDEFL_DATA *d, unsigned int cur, unsigned int best, unsigned int *dist)
+{
+    const unsigned char *scan = d->window + d->pos;
+    unsigned int max = d->fill - d->pos;
+    if (max > MAX_MATCH) {
+        max = MAX_MATCH;
+    }
+    if (best >= max) {
+        return best;
+    }
+    unsigned int limit = d->pos > d->wsize - 1 ? d->pos - (d->wsize - 1) : 1;
+    unsigned int chain = d->max_chain;
+
+    while (cur >= limit) {
+        const unsigned char *m = d->window + cur;
+        if (m[best] == scan[best] && m[0] == scan[0] && m[1] == scan[1]) {
+            unsigned int len = 2;
+            while (len < max && m[len] == scan[len]) {
+                len++;
+            }
+            if (len > best) {
+                best = len;
+                *dist = d->pos - cur;
+                if (len >= d->nice_len || len == max) {
+                    break;
+                }
+            }
+        }
+        if (--chain == 0) {
+            break;
+        }
+        cur = d->prev[cur & (d->wsize - 1)];
+    }
+    return best;
+}
+
+/* moves the second window to the first to make room for more data */
+static void tdefl_slide(TDEFL_DATA *d)
+{
+    unsigned int w = d->wsize;
+    unsigned int i;
+    memcpy(d->window, d->window + w, w);
+    d->pos -= w;
+    d->fill -= w;
+    for (i = 0; i < 1u << d->hash_bits; i++) {
+        d->head[i] = d->head[i] >= w ? d->head[i] - w : 0;
+    }
+    for (i = 0; i < w; i++) {
+        d->prev[i] = d->prev[i] >= w ? d->prev[i] - w : 0;
+    }
+}
+
+/* codes the data in the window, leaving enough lookahead for the longest
+   match unless at_end */
+static void tdefl_run(TDEFL_DATA *d, int at_end)
+{
+    const unsigned char *win = d->window;
+    unsigned int keep = at_end ? 0 : MIN_LOOKAHEAD;
+
+    while (d->fill - d->pos > keep) {
+        unsigned int cur = 0;
+        unsigned int len = MIN_MATCH - 1;
+        unsigned int dist = 0;
+        unsigned int prev_len = d->match_len;
+        unsigned int p;
+
+        if (d->pos + MIN_MATCH <= d->fill) {
+            cur = tdefl_insert(d, d->pos);
+        }
+        if (cur != 0 && d->max_chain != 0 && (!d->lazy || prev_len < d->nice_len)) {
+            len = tdefl_longest_match(d, cur, prev_len > len ? prev_len : len, &dist);
+            if (len == MIN_MATCH && dist > TOO_FAR) {
+                len = MIN_MATCH - 1;
+            }
+            if (len <= prev_len) {
+                len = MIN_MATCH - 1;
+            }
+        }
+
+        if (!d->lazy) {
+            if (len >= MIN_MATCH) {
+                tdefl_outmatch(d, len, dist);
+                for (p = d->pos + 1; p < d->pos + len && p + MIN_MATCH <= d->fill; p++) {
+                    tdefl_insert(d, p);
+                }
+                d->pos += len;
+            } else {
+                tdefl_outsym(d, win[d->pos]);
+                d->pos++;
+            }
+        } else if (prev_len >= MIN_MATCH && len < MIN_MATCH) {
+            /* the match at pos - 1 is the best one, and pos is inserted */
+            unsigned int end = d->pos - 1 + prev_len;
+            tdefl_outmatch(d, prev_len, d->match_dist);
+            for (p = d->pos + 1; p < end && p + MIN_MATCH <= d->fill; p++) {
+                tdefl_insert(d, p);
+            }
+            d->pos = end;
+            d->match_avail = 0;
+            d->match_len = 0;
+        } else {
+            /* wait for the next position to maybe have a longer match */
+            if (d->match_avail) {
+                tdefl_outsym(d, win[d->pos - 1]);
+            }
+            d->match_avail = 1;
+            d->match_len = len >= MIN_MATCH ? len : 0;
+            d->match_dist = dist;
+            d->pos++;
+        }
+    }
+}
+
+/* --------------------- *
+ * -- API functions -- *
+ * --------------------- */
+
+void uzlib_deflate_init(TDEFL_DATA *d, int wbits, int level, void *mem)
+{
+    if (level < 0 || level > 9) {
+        level = 6;
+    }
+    d->noutbits = 0;
+    d->outbits = 0;
+    d->in_block = 0;
+    d->checksum_type = TINF_CHKSUM_NONE;
+    d->size = 0;
+    d->wsize = 1 << wbits;
+    d->hash_bits = tdefl_hash_bits(wbits);
+    d->window = mem;
+    d->prev = (unsigned short*)(d->window + 2 * d->wsize);
+    d->head = d->prev + d->wsize;
+    memset(d->head, 0, sizeof(*d->head) << d->hash_bits);
+    d->fill = 0;
+    d->pos = 0;
+    d->max_chain = tdefl_levels[level].max_chain;
+    d->nice_len = tdefl_levels[level].nice_len;
+    d->lazy = tdefl_levels[level].lazy;
+    d->match_avail = 0;
+    d->match_len = 0;
+}
+
+void uzlib_zlib_write_header(TDEFL_DATA *d)
+{
+    unsigned int cmf = (tdefl_log2(d->wsize) - 8) << 4 | 8;
+    /* FLEVEL 2, the default */
+    unsigned int flg = 2 << 6;
+    flg += (31 - (cmf * 256 + flg) % 31) % 31;
+    tdefl_outbyte(d, cmf);
+    tdefl_outbyte(d, flg);
+    d->checksum_type = TINF_CHKSUM_ADLER;
+    d->checksum = 1;
+}
+
+void uzlib_gzip_write_header(TDEFL_DATA *d)
+{
+    /* deflate, no flags or time, unknown OS */
+    static const unsigned char header[10] = {0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff};
+    unsigned int i;
+    for (i = 0; i < sizeof(header); i++) {
+        tdefl_outbyte(d, header[i]);
+    }
+    d->checksum_type = TINF_CHKSUM_CRC;
+    d->checksum = 0xffffffff;
+}
+
+void uzlib_deflate(TDEFL_DATA *d, const void *data, unsigned int len, int flush)
+{
+    const unsigned char *src = data;
+
+    if (d->checksum_type == TINF_CHKSUM_ADLER) {
+        d->checksum = uzlib_adler32(src, len, d->checksum);
+    } else if (d->checksum_type == TINF_CHKSUM_CRC) {
+        d->checksum = uzlib_crc32(src, len, d->checksum);
+    }
+    d->size += len;
+
+    if (!d->in_block) {
+        /* not the final block, fixed codes */
+        tdefl_outbits(d, 1 << 1, 3);
+        d->in_block = 1;
+    }
+
+    while (len > 0) {
+        unsigned int n;
+        if (d->fill == 2 * d->wsize) {
+            tdefl_slide(d);
+        }
+        n = 2 * d->wsize - d->fill;
+        if (n > len) {
+            n = len;
+        }
+        memcpy(d->window + d->fill, src, n);
+        d->fill += n;
+        src += n;
+        len -= n;
+        tdefl_run(d, 0);
+    }
+
+    if (flush == TDEFL_NO_FLUSH) {
+        return;
+    }
+
+    tdefl_run(d, 1);
+    if (d->match_avail) {
+        tdefl_outsym(d, d->window[d->pos - 1]);
+        d->match_avail = 0;
+    }
+    d->match_len = 0;
+    /* end of block */
+    tdefl_outsym(d, 256);
+
+    if (flush == TDEFL_SYNC_FLUSH) {
+        /* an empty stored block, then carry on in a new block */
+        tdefl_outbits(d, 0, 3);
+        tdefl_align(d);
+        tdefl_outbyte(d, 0);
+        tdefl_outbyte(d, 0);
+        tdefl_outbyte(d, 0xff);
+        tdefl_outbyte(d, 0xff);
+        d->in_block = 0;
+        return;
+    }
+
+    /* an empty final block */
+    tdefl_outbits(d, 1 | 1 << 1, 3);
+    tdefl_outsym(d, 256);
+    tdefl_align(d);
+
+    if (d->checksum_type == TINF_CHKSUM_ADLER) {
+        int i;
+        for (i = 24; i >= 0; i -= 8) {
+            tdefl_outbyte(d, d->checksum >> i);
+        }
+    } else if (d->checksum_type == TINF_CHKSUM_CRC) {
+        uint32_t crc = d->checksum ^ 0xffffffff;
+        int i;
+        for (i = 0; i < 32; i += 8) {
+            tdefl_outbyte(d, crc >> i);
+        }
+        for (i = 0; i < 32; i += 8) {
+            tdefl_outbyte(d, d->size >> i);
+        }
+    }
+    d->in_block = 0;
+}
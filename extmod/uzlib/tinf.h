@@ -12,6 +12,7 @@
 #define TINF_H_INCLUDED
 
 #include <stdint.h>
+#include <string.h>
 
 /* calling convention */
 #ifndef TINFCC
@@ -39,19 +40,40 @@ extern "C" {
 #define TINF_CHKSUM_ADLER 1
 #define TINF_CHKSUM_CRC   2
 
+/* Huffman codes of up to this many bits are decoded with one table lookup,
+   which takes 2 << TINF_FAST_BITS bytes per tree; 0 decodes bit by bit */
+#ifndef TINF_FAST_BITS
+#define TINF_FAST_BITS 9
+#endif
+
+/* CRC32 is computed this many bytes at a time, with a 1KB table per byte;
+   0 computes it 4 bits at a time with a 64 byte table */
+#ifndef TINF_CRC32_SLICES
+#define TINF_CRC32_SLICES 0
+#endif
+
 /* data structures */
 
 typedef struct {
    unsigned short table[16];  /* table of code length counts */
    unsigned short trans[288]; /* code -> symbol translation table */
+#if TINF_FAST_BITS
+   /* code length << 9 | symbol for each value of the next bits, 0 if the
+      code is longer */
+   unsigned short fast[1 << TINF_FAST_BITS];
+#endif
 } TINF_TREE;
 
 struct TINF_DATA;
 typedef struct TINF_DATA {
    const unsigned char *source;
+   /* End of the data at source; reading past it gives zeros and sets eof,
+      which makes decompression fail */
+   const unsigned char *source_limit;
    /* If source above is NULL, this function will be used to read
       next byte from source stream */
    unsigned char (*readSource)(struct TINF_DATA *data);
+   char eof;
 
    unsigned int tag;
    unsigned int bitcount;
@@ -101,10 +123,87 @@ int TINFCC uzlib_gzip_parse_header(TINF_DATA *d);
 
 /* Compression API */
 
-void TINFCC uzlib_compress(void *data, const uint8_t *src, unsigned slen);
+/* flush modes for uzlib_deflate() */
+#define TDEFL_NO_FLUSH    0
+/* end the output on a byte boundary, so all data so far can be decoded */
+#define TDEFL_SYNC_FLUSH  1
+/* end the compressed stream */
+#define TDEFL_FINISH      2
+
+/* smallest and largest supported window, as log2 of its size */
+#define TDEFL_MIN_WBITS   9
+#define TDEFL_MAX_WBITS   15
+
+#define TDEFL_MEM_SIZE(wbits) \
+    ((4u << (wbits)) + (2u << tdefl_hash_bits(wbits)))
+
+static inline unsigned int tdefl_hash_bits(unsigned int wbits) {
+    return wbits > 13 ? 12 : wbits - 1;
+}
+
+struct TDEFL_DATA;
+typedef struct TDEFL_DATA {
+    /* Output buffer.  When it is full writeDest is called, which must
+       consume destSize bytes from destStart and set dest back to where
+       the next byte should go. */
+    unsigned char *destStart;
+    unsigned int destSize;
+    unsigned char *dest;
+    void (*writeDest)(struct TDEFL_DATA *data);
+
+    uint32_t outbits;
+    int noutbits;
+    char in_block;
+
+    /* Accumulating checksum and size of the uncompressed data */
+    uint32_t checksum;
+    char checksum_type;
+    uint32_t size;
+
+    /* Two windows of data, the first one being history for the second */
+    unsigned char *window;
+    /* Hash chains: latest position for each hash of 3 bytes, and the
+       previous position with the same hash for each position */
+    unsigned short *head;
+    unsigned short *prev;
+    unsigned int wsize;
+    unsigned int hash_bits;
+    unsigned int fill;
+    unsigned int pos;
+
+    /* Match search parameters */
+    unsigned int max_chain;
+    unsigned int nice_len;
+    char lazy;
+
+    /* Match found at pos - 1, which lazy matching may still drop */
+    char match_avail;
+    unsigned int match_len;
+    unsigned int match_dist;
+} TDEFL_DATA;
+
+/* mem is TDEFL_MEM_SIZE(wbits) bytes, aligned for unsigned short; level is
+   0 (no matching) to 9 (best compression) */
+void TINFCC uzlib_deflate_init(TDEFL_DATA *d, int wbits, int level, void *mem);
+/* Optional, to be called after init before any data */
+void TINFCC uzlib_zlib_write_header(TDEFL_DATA *d);
+void TINFCC uzlib_gzip_write_header(TDEFL_DATA *d);
+void TINFCC uzlib_deflate(TDEFL_DATA *d, const void *data, unsigned int len, int flush);
 
 /* Checksum API */
 
+/* Reads a little-endian word from p, which must be 4-byte aligned, so that
+   it is a single load even on CPUs that can't load unaligned words */
+static inline uint32_t tinf_get_le32_aligned(const unsigned char *p) {
+#if defined(__GNUC__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint32_t w;
+    memcpy(&w, __builtin_assume_aligned(p, 4), 4);
+    return w;
+#else
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+#endif
+}
+
 /* prev_sum is previous value for incremental computation, 1 initially */
 uint32_t TINFCC uzlib_adler32(const void *data, unsigned int length, uint32_t prev_sum);
 /* crc is previous value for incremental computation, 0xffffffff initially */
@@ -33,6 +33,7 @@
  */
 
 #include <assert.h>
+#include <string.h>
 #include "tinf.h"
 
 uint32_t tinf_get_le_uint32(TINF_DATA *d);
@@ -112,13 +113,41 @@ static void tinf_build_bits_base(unsigned char *bits, unsigned short *base, int
 }
 #endif
 
+#if TINF_FAST_BITS
+/* fill the lookup table of a tree for its codes of up to TINF_FAST_BITS bits */
+static void tinf_build_fast(TINF_TREE *t)
+{
+   unsigned int len, i, j, code = 0, idx = 0;
+
+   memset(t->fast, 0, sizeof(t->fast));
+
+   /* codes of each length are consecutive, in the order of trans */
+   for (len = 1; len <= TINF_FAST_BITS; ++len)
+   {
+      for (i = 0; i < t->table[len]; ++i, ++code, ++idx)
+      {
+         /* codes are sent from their most significant bit, so the
+            index is the code reversed, with any bits following it */
+         unsigned int rev = 0, c = code;
+         for (j = 0; j < len; ++j, c >>= 1) rev = rev << 1 | (c & 1);
+         for (j = rev & ((1 << TINF_FAST_BITS) - 1); j < 1 << TINF_FAST_BITS; j += 1 << len)
+            t->fast[j] = len << 9 | t->trans[idx];
+      }
+      code <<= 1;
+   }
+}
+#else
+#define tinf_build_fast(t) (void)0
+#endif
+
 /* build the fixed huffman trees */
 static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
 {
    int i;
 
-   /* build fixed length tree */
-   for (i = 0; i < 7; ++i) lt->table[i] = 0;
+   /* build fixed length tree, clearing all the counts that a dynamic
+      tree may have left, which tinf_build_fast reads */
+   for (i = 0; i < 16; ++i) lt->table[i] = 0;
 
    lt->table[7] = 24;
    lt->table[8] = 152;
@@ -130,11 +159,14 @@ static void tinf_build_fixed_trees(TINF_TREE *lt, TINF_TREE *dt)
    for (i = 0; i < 112; ++i) lt->trans[24 + 144 + 8 + i] = 144 + i;
 
    /* build fixed distance tree */
-   for (i = 0; i < 5; ++i) dt->table[i] = 0;
+   for (i = 0; i < 16; ++i) dt->table[i] = 0;
 
    dt->table[5] = 32;
 
    for (i = 0; i < 32; ++i) dt->trans[i] = i;
+
+   tinf_build_fast(lt);
+   tinf_build_fast(dt);
 }
 
 /* given an array of code lengths, build a tree */
@@ -163,6 +195,8 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
    {
       if (lengths[i]) t->trans[offs[lengths[i]]++] = i;
    }
+
+   tinf_build_fast(t);
 }
 
 /* ---------------------- *
@@ -172,7 +206,11 @@ static void tinf_build_tree(TINF_TREE *t, const unsigned char *lengths, unsigned
 unsigned char uzlib_get_byte(TINF_DATA *d)
 {
     if (d->source) {
-        return *d->source++;
+        if (d->source < d->source_limit) {
+            return *d->source++;
+        }
+        d->eof = 1;
+        return 0;
     }
     return d->readSource(d);
 }
@@ -197,22 +235,29 @@ uint32_t tinf_get_be_uint32(TINF_DATA *d)
     return val;
 }
 
+/* Bits are taken from tag, which holds bitcount bits (and zeros above
+   them).  Bytes are only read from the source when bits are needed, so
+   that nothing past the end of the compressed data gets read. */
+
+/* add the next byte of the source to tag */
+static void tinf_load_byte(TINF_DATA *d)
+{
+   d->tag |= (uint32_t)uzlib_get_byte(d) << d->bitcount;
+   d->bitcount += 8;
+}
+
 /* get one bit from source stream */
 static int tinf_getbit(TINF_DATA *d)
 {
    unsigned int bit;
 
    /* check if tag is empty */
-   if (!d->bitcount--)
-   {
-      /* load next tag */
-      d->tag = uzlib_get_byte(d);
-      d->bitcount = 7;
-   }
+   if (!d->bitcount) tinf_load_byte(d);
 
    /* shift bit out of tag */
    bit = d->tag & 0x01;
    d->tag >>= 1;
+   d->bitcount--;
 
    return bit;
 }
@@ -220,17 +265,13 @@ static int tinf_getbit(TINF_DATA *d)
 /* read a num bit value from a stream and add base */
 static unsigned int tinf_read_bits(TINF_DATA *d, int num, int base)
 {
-   unsigned int val = 0;
+   unsigned int val;
 
-   /* read num bits */
-   if (num)
-   {
-      unsigned int limit = 1 << (num);
-      unsigned int mask;
+   while (d->bitcount < (unsigned int)num) tinf_load_byte(d);
 
-      for (mask = 1; mask < limit; mask *= 2)
-         if (tinf_getbit(d)) val += mask;
-   }
+   val = d->tag & ((1 << num) - 1);
+   d->tag >>= num;
+   d->bitcount -= num;
 
    return val + base;
 }
@@ -240,9 +281,30 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
 {
    int sum = 0, cur = 0, len = 0;
 
+#if TINF_FAST_BITS
+   for (;;)
+   {
+      /* bits not read yet are zeros in the index, which still finds a
+         code if it is no longer than the bits there are */
+      unsigned int e = t->fast[d->tag & ((1 << TINF_FAST_BITS) - 1)];
+      if (e != 0 && e >> 9 <= d->bitcount)
+      {
+         d->tag >>= e >> 9;
+         d->bitcount -= e >> 9;
+         return e & 0x1ff;
+      }
+      /* a code longer than the table, decoded bit by bit below */
+      if (d->bitcount >= TINF_FAST_BITS) break;
+      tinf_load_byte(d);
+   }
+#endif
+
    /* get more bits while code value is above sum */
    do {
 
+      /* no code matches */
+      if (len == 15) return TINF_DATA_ERROR;
+
       cur = 2*cur + tinf_getbit(d);
 
       ++len;
@@ -256,7 +318,7 @@ static int tinf_decode_symbol(TINF_DATA *d, TINF_TREE *t)
 }
 
 /* given a data stream, decode dynamic trees from it */
-static void tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
+static int tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 {
    unsigned char lengths[288+32];
    unsigned int hlit, hdist, hclen;
@@ -289,62 +351,72 @@ static void tinf_decode_trees(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
    for (num = 0; num < hlit + hdist; )
    {
       int sym = tinf_decode_symbol(d, lt);
+      unsigned char fill = 0;
 
       switch (sym)
       {
       case 16:
          /* copy previous code length 3-6 times (read 2 bits) */
-         {
-            unsigned char prev = lengths[num - 1];
-            for (length = tinf_read_bits(d, 2, 3); length; --length)
-            {
-               lengths[num++] = prev;
-            }
-         }
+         if (num == 0) return TINF_DATA_ERROR;
+         fill = lengths[num - 1];
+         length = tinf_read_bits(d, 2, 3);
          break;
       case 17:
          /* repeat code length 0 for 3-10 times (read 3 bits) */
-         for (length = tinf_read_bits(d, 3, 3); length; --length)
-         {
-            lengths[num++] = 0;
-         }
+         length = tinf_read_bits(d, 3, 3);
          break;
       case 18:
          /* repeat code length 0 for 11-138 times (read 7 bits) */
-         for (length = tinf_read_bits(d, 7, 11); length; --length)
-         {
-            lengths[num++] = 0;
-         }
+         length = tinf_read_bits(d, 7, 11);
          break;
       default:
+         if (sym < 0) return sym;
          /* values 0-15 represent the actual code lengths */
-         lengths[num++] = sym;
+         fill = sym;
+         length = 1;
          break;
       }
+
+      if (num + length > hlit + hdist) return TINF_DATA_ERROR;
+      for (; length; --length)
+      {
+         lengths[num++] = fill;
+      }
    }
 
    /* build dynamic trees */
    tinf_build_tree(lt, lengths, hlit);
    tinf_build_tree(dt, lengths + hlit, hdist);
+
+   return TINF_OK;
 }
 
 /* ----------------------------- *
  * -- block inflate functions -- *
  * ----------------------------- */
 
-/* given a stream and two trees, inflate a block of data */
+/* given a stream and two trees, inflate a block of data, until the end of
+   the block or until destSize bytes are produced */
 static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 {
+  for (;;) {
     if (d->curlen == 0) {
         unsigned int offs;
         int dist;
         int sym = tinf_decode_symbol(d, lt);
         //printf("huff sym: %02x\n", sym);
 
+        if (sym < 0) {
+            return sym;
+        }
+
         /* literal byte */
         if (sym < 256) {
             TINF_PUT(d, sym);
-            return TINF_OK;
+            if (--d->destSize == 0) {
+                return TINF_OK;
+            }
+            continue;
         }
 
         /* end of block */
@@ -354,10 +426,16 @@ static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
 
         /* substring from sliding dictionary */
         sym -= 257;
+        if (sym >= 29) {
+            return TINF_DATA_ERROR;
+        }
         /* possibly get more bits from length code */
         d->curlen = tinf_read_bits(d, length_bits[sym], length_base[sym]);
 
         dist = tinf_decode_symbol(d, dt);
+        if ((unsigned)dist >= 30) {
+            return TINF_DATA_ERROR;
+        }
         /* possibly get more bits from distance code */
         offs = tinf_read_bits(d, dist_bits[dist], dist_base[dist]);
         if (d->dict_ring) {
@@ -369,25 +447,44 @@ static int tinf_inflate_block_data(TINF_DATA *d, TINF_TREE *lt, TINF_TREE *dt)
                 d->lzOff += d->dict_size;
             }
         } else {
+            if (offs > (unsigned)(d->dest - d->destStart)) {
+                return TINF_DICT_ERROR;
+            }
             d->lzOff = -offs;
         }
     }
 
-    /* copy next byte from dict substring */
+    /* copy as much of the dict substring as fits */
+    unsigned int n = d->curlen < d->destSize ? d->curlen : d->destSize;
+    d->curlen -= n;
+    d->destSize -= n;
     if (d->dict_ring) {
-        TINF_PUT(d, d->dict_ring[d->lzOff]);
-        if ((unsigned)++d->lzOff == d->dict_size) {
-            d->lzOff = 0;
+        while (n--) {
+            TINF_PUT(d, d->dict_ring[d->lzOff]);
+            if ((unsigned)++d->lzOff == d->dict_size) {
+                d->lzOff = 0;
+            }
         }
+    } else if ((unsigned)-d->lzOff >= n) {
+        /* the substring doesn't overlap the output */
+        memcpy(d->dest, d->dest + d->lzOff, n);
+        d->dest += n;
     } else {
-        d->dest[0] = d->dest[d->lzOff];
-        d->dest++;
+        unsigned char *p = d->dest;
+        d->dest += n;
+        while (p < d->dest) {
+            *p = p[d->lzOff];
+            p++;
+        }
     }
-    d->curlen--;
-    return TINF_OK;
+    if (d->destSize == 0) {
+        return TINF_OK;
+    }
+  }
 }
 
-/* inflate an uncompressed block of data */
+/* inflate an uncompressed block of data, until the end of the block or until
+   destSize bytes are produced */
 static int tinf_inflate_uncompressed_block(TINF_DATA *d)
 {
     if (d->curlen == 0) {
@@ -406,15 +503,36 @@ static int tinf_inflate_uncompressed_block(TINF_DATA *d)
 
         /* make sure we start next block on a byte boundary */
         d->bitcount = 0;
+        d->tag = 0;
     }
 
-    if (--d->curlen == 0) {
-        return TINF_DONE;
+    if (d->source && !d->dict_ring) {
+        /* copy as much of the block as fits, and is there */
+        unsigned int n = d->curlen - 1 < d->destSize ? d->curlen - 1 : d->destSize;
+        if (n > (unsigned int)(d->source_limit - d->source)) {
+            n = d->source_limit - d->source;
+        }
+        memcpy(d->dest, d->source, n);
+        d->dest += n;
+        d->source += n;
+        d->curlen -= n;
+        d->destSize -= n;
+        if (d->destSize == 0) {
+            return TINF_OK;
+        }
     }
 
-    unsigned char c = uzlib_get_byte(d);
-    TINF_PUT(d, c);
-    return TINF_OK;
+    for (;;) {
+        if (--d->curlen == 0) {
+            return TINF_DONE;
+        }
+
+        unsigned char c = uzlib_get_byte(d);
+        TINF_PUT(d, c);
+        if (--d->destSize == 0) {
+            return TINF_OK;
+        }
+    }
 }
 
 /* ---------------------- *
@@ -439,6 +557,7 @@ void uzlib_init(void)
 void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
 {
    d->bitcount = 0;
+   d->tag = 0;
    d->bfinal = 0;
    d->btype = -1;
    d->dict_size = dictLen;
@@ -447,10 +566,10 @@ void uzlib_uncompress_init(TINF_DATA *d, void *dict, unsigned int dictLen)
    d->curlen = 0;
 }
 
-/* inflate next byte of compressed stream */
+/* inflate next destSize bytes of compressed stream */
 int uzlib_uncompress(TINF_DATA *d)
 {
-    do {
+    while (d->destSize) {
         int res;
 
         /* start a new block */
@@ -468,7 +587,10 @@ next_blk:
                 tinf_build_fixed_trees(&d->ltree, &d->dtree);
             } else if (d->btype == 2) {
                 /* decode trees from stream */
-                tinf_decode_trees(d, &d->ltree, &d->dtree);
+                res = tinf_decode_trees(d, &d->ltree, &d->dtree);
+                if (res != TINF_OK) {
+                    return res;
+                }
             }
         }
 
@@ -489,17 +611,21 @@ next_blk:
             return TINF_DATA_ERROR;
         }
 
+        if (d->eof) {
+            /* the compressed data ended early */
+            return TINF_DATA_ERROR;
+        }
+
         if (res == TINF_DONE && !d->bfinal) {
-            /* the block has ended (without producing more data), but we
-               can't return without data, so start procesing next block */
+            /* the block has ended before producing all the data asked
+               for, so start procesing next block */
             goto next_blk;
         }
 
         if (res != TINF_OK) {
             return res;
         }
-
-    } while (--d->destSize);
+    }
 
     return TINF_OK;
 }
@@ -545,6 +671,10 @@ int uzlib_uncompress_chksum(TINF_DATA *d)
             val = tinf_get_le_uint32(d);
             break;
         }
+
+        if (d->eof) {
+            return TINF_DATA_ERROR;
+        }
     }
 
     return res;
@@ -62,5 +62,6 @@ int uzlib_zlib_parse_header(TINF_DATA *d)
    d->checksum_type = TINF_CHKSUM_ADLER;
    d->checksum = 1;
 
-   return cmf >> 4;
+   /* return log2 of the window size */
+   return (cmf >> 4) + 8;
 }
@@ -278,25 +278,36 @@ STATIC mp_obj_t socket_setblocking(const mp_obj_t arg0, const mp_obj_t arg1) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_setblocking_obj, socket_setblocking);
 
-mp_obj_t _socket_recvfrom(mp_obj_t self_in, mp_obj_t len_in,
+int _socket_recvfrom_into(socket_obj_t *sock, void *buf, size_t len,
         struct sockaddr *from, socklen_t *from_len) {
-    socket_obj_t *sock = MP_OBJ_TO_PTR(self_in);
-    size_t len = mp_obj_get_int(len_in);
-    vstr_t vstr;
-    vstr_init_len(&vstr, len);
-
     // XXX Would be nicer to use RTC to handle timeouts
     for (int i=0; i<=sock->retries; i++) {
         MP_THREAD_GIL_EXIT();
-        int r = lwip_recvfrom_r(sock->fd, vstr.buf, len, 0, from, from_len);
+        int r = lwip_recvfrom_r(sock->fd, buf, len, 0, from, from_len);
         MP_THREAD_GIL_ENTER();
-        if (r >= 0) { vstr.len = r; return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr); }
+        if (r >= 0) return r;
         if (errno != EWOULDBLOCK) exception_from_errno(errno);
         check_for_exceptions();
     }
     mp_raise_OSError(MP_ETIMEDOUT);
 }
 
+mp_obj_t _socket_recvfrom(mp_obj_t self_in, mp_obj_t len_in,
+        struct sockaddr *from, socklen_t *from_len) {
+    socket_obj_t *sock = MP_OBJ_TO_PTR(self_in);
+    size_t len = mp_obj_get_int(len_in);
+    vstr_t vstr;
+    vstr_init_len(&vstr, len);
+    vstr.len = _socket_recvfrom_into(sock, vstr.buf, len, from, from_len);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+
+STATIC mp_obj_t _socket_format_addr(struct sockaddr *from) {
+    uint8_t *ip = (uint8_t*)&((struct sockaddr_in*)from)->sin_addr;
+    mp_uint_t port = lwip_ntohs(((struct sockaddr_in*)from)->sin_port);
+    return netutils_format_inet_addr(ip, port, NETUTILS_BIG);
+}
+
 STATIC mp_obj_t socket_recv(mp_obj_t self_in, mp_obj_t len_in) {
     return _socket_recvfrom(self_in, len_in, NULL, NULL);
 }
@@ -308,15 +319,50 @@ STATIC mp_obj_t socket_recvfrom(mp_obj_t self_in, mp_obj_t len_in) {
 
     mp_obj_t tuple[2];
     tuple[0] = _socket_recvfrom(self_in, len_in, &from, &fromlen);
-
-    uint8_t *ip = (uint8_t*)&((struct sockaddr_in*)&from)->sin_addr;
-    mp_uint_t port = lwip_ntohs(((struct sockaddr_in*)&from)->sin_port);
-    tuple[1] = netutils_format_inet_addr(ip, port, NETUTILS_BIG);
+    tuple[1] = _socket_format_addr(&from);
 
     return mp_obj_new_tuple(2, tuple);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_recvfrom_obj, socket_recvfrom);
 
+// Gets the buffer to receive into for recv_into and recvfrom_into, which take
+// (buffer[, nbytes]); nbytes of 0 or not given means the whole buffer.
+STATIC void _socket_get_recv_into_buf(size_t n_args, const mp_obj_t *args, mp_buffer_info_t *bufinfo) {
+    mp_get_buffer_raise(args[1], bufinfo, MP_BUFFER_WRITE);
+    if (n_args > 2) {
+        mp_int_t nbytes = mp_obj_get_int(args[2]);
+        if (nbytes < 0 || (size_t)nbytes > bufinfo->len) {
+            mp_raise_ValueError("nbytes is greater than the length of the buffer");
+        }
+        if (nbytes != 0) {
+            bufinfo->len = nbytes;
+        }
+    }
+}
+
+STATIC mp_obj_t socket_recv_into(size_t n_args, const mp_obj_t *args) {
+    socket_obj_t *sock = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    _socket_get_recv_into_buf(n_args, args, &bufinfo);
+    return mp_obj_new_int(_socket_recvfrom_into(sock, bufinfo.buf, bufinfo.len, NULL, NULL));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_into_obj, 2, 3, socket_recv_into);
+
+STATIC mp_obj_t socket_recvfrom_into(size_t n_args, const mp_obj_t *args) {
+    socket_obj_t *sock = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    _socket_get_recv_into_buf(n_args, args, &bufinfo);
+    struct sockaddr from;
+    socklen_t fromlen = sizeof(from);
+
+    mp_obj_t tuple[2];
+    tuple[0] = mp_obj_new_int(_socket_recvfrom_into(sock, bufinfo.buf, bufinfo.len, &from, &fromlen));
+    tuple[1] = _socket_format_addr(&from);
+
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvfrom_into_obj, 2, 3, socket_recvfrom_into);
+
 int _socket_send(socket_obj_t *sock, const char *data, size_t datalen) {
     int sentlen = 0;
     for (int i=0; i<=sock->retries && sentlen < datalen; i++) {
@@ -352,13 +398,7 @@ STATIC mp_obj_t socket_sendall(const mp_obj_t arg0, const mp_obj_t arg1) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_2(socket_sendall_obj, socket_sendall);
 
-STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t data_in, mp_obj_t addr_in) {
-    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
-
-    // get the buffer to send
-    mp_buffer_info_t bufinfo;
-    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
-
+STATIC mp_obj_t _socket_sendto(socket_obj_t *self, const void *buf, size_t len, mp_obj_t addr_in) {
     // create the destination address
     struct sockaddr_in to;
     to.sin_len = sizeof(to);
@@ -368,7 +408,7 @@ STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t data_in, mp_obj_t addr_
     // send the data
     for (int i=0; i<=self->retries; i++) {
         MP_THREAD_GIL_EXIT();
-        int ret = lwip_sendto_r(self->fd, bufinfo.buf, bufinfo.len, 0, (struct sockaddr*)&to, sizeof(to));
+        int ret = lwip_sendto_r(self->fd, buf, len, 0, (struct sockaddr*)&to, sizeof(to));
         MP_THREAD_GIL_ENTER();
         if (ret > 0) return mp_obj_new_int_from_uint(ret);
         if (ret == -1 && errno != EWOULDBLOCK) {
@@ -378,8 +418,65 @@ STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t data_in, mp_obj_t addr_
     }
     mp_raise_OSError(MP_ETIMEDOUT); 
 }
+
+STATIC mp_obj_t socket_sendto(mp_obj_t self_in, mp_obj_t data_in, mp_obj_t addr_in) {
+    socket_obj_t *self = MP_OBJ_TO_PTR(self_in);
+
+    // get the buffer to send
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(data_in, &bufinfo, MP_BUFFER_READ);
+
+    return _socket_sendto(self, bufinfo.buf, bufinfo.len, addr_in);
+}
 STATIC MP_DEFINE_CONST_FUN_OBJ_3(socket_sendto_obj, socket_sendto);
 
+// sendmsg(buffers[, ancdata[, flags[, address]]]): sends the data of all the
+// buffers, as one packet for UDP.  Ancillary data isn't supported and flags
+// are ignored.
+STATIC mp_obj_t socket_sendmsg(size_t n_args, const mp_obj_t *args) {
+    socket_obj_t *sock = MP_OBJ_TO_PTR(args[0]);
+    if (n_args > 2 && mp_obj_get_int(mp_obj_len(args[2])) != 0) {
+        mp_raise_NotImplementedError("ancdata");
+    }
+
+    size_t n_bufs;
+    mp_obj_t *bufs;
+    mp_obj_get_array(args[1], &n_bufs, &bufs);
+
+    if (sock->type == SOCK_STREAM) {
+        // stop at the first buffer which isn't sent in full
+        int sent = 0;
+        for (size_t i = 0; i < n_bufs; i++) {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(bufs[i], &bufinfo, MP_BUFFER_READ);
+            int r = _socket_send(sock, bufinfo.buf, bufinfo.len);
+            sent += r;
+            if (r < bufinfo.len) {
+                break;
+            }
+        }
+        return mp_obj_new_int(sent);
+    }
+
+    // a datagram must be sent with one call, so gather the buffers
+    vstr_t vstr;
+    vstr_init(&vstr, 64);
+    for (size_t i = 0; i < n_bufs; i++) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(bufs[i], &bufinfo, MP_BUFFER_READ);
+        vstr_add_strn(&vstr, bufinfo.buf, bufinfo.len);
+    }
+    mp_obj_t ret;
+    if (n_args > 4 && args[4] != mp_const_none) {
+        ret = _socket_sendto(sock, vstr.buf, vstr.len, args[4]);
+    } else {
+        ret = mp_obj_new_int(_socket_send(sock, vstr.buf, vstr.len));
+    }
+    vstr_clear(&vstr);
+    return ret;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendmsg_obj, 2, 5, socket_sendmsg);
+
 STATIC mp_obj_t socket_fileno(const mp_obj_t arg0) {
     socket_obj_t *self = MP_OBJ_TO_PTR(arg0);
     return mp_obj_new_int(self->fd);
@@ -468,6 +565,9 @@ STATIC const mp_map_elem_t socket_locals_dict_table[] = {
     { MP_OBJ_NEW_QSTR(MP_QSTR_sendto), (mp_obj_t)&socket_sendto_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_recv), (mp_obj_t)&socket_recv_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_recvfrom), (mp_obj_t)&socket_recvfrom_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_recv_into), (mp_obj_t)&socket_recv_into_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_recvfrom_into), (mp_obj_t)&socket_recvfrom_into_obj },
+    { MP_OBJ_NEW_QSTR(MP_QSTR_sendmsg), (mp_obj_t)&socket_sendmsg_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_setsockopt), (mp_obj_t)&socket_setsockopt_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_settimeout), (mp_obj_t)&socket_settimeout_obj },
     { MP_OBJ_NEW_QSTR(MP_QSTR_setblocking), (mp_obj_t)&socket_setblocking_obj },
@@ -22,6 +22,11 @@
 // optimisations
 #define MICROPY_OPT_COMPUTED_GOTO           (1)
 #define MICROPY_OPT_MPZ_BITWISE             (1)
+#define MICROPY_OPT_MPZ_KARATSUBA           (1)
+#define MICROPY_OPT_MPZ_MONTGOMERY          (1)
+#define MICROPY_OPT_MPZ_FAST_STR            (1)
+#define MICROPY_OPT_FLOAT_ROUNDTRIP         (1)
+#define MICROPY_OPT_INSTANCE_SHARED_KEYS    (1)
 
 // Python internal features
 #define MICROPY_READER_VFS                  (1)
@@ -57,6 +62,7 @@
 
 // control over Python builtins
 #define MICROPY_PY_FUNCTION_ATTRS           (1)
+#define MICROPY_PY_SLOTS                    (1)
 #define MICROPY_PY_STR_BYTES_CMP_WARN       (1)
 #define MICROPY_PY_BUILTINS_STR_UNICODE     (1)
 #define MICROPY_PY_BUILTINS_STR_CENTER      (1)
@@ -99,7 +105,10 @@
 #define MICROPY_PY_IO_FILEIO                (1)
 #define MICROPY_PY_IO_BYTESIO               (1)
 #define MICROPY_PY_IO_BUFFEREDWRITER        (1)
+#define MICROPY_PY_IO_BUFFEREDREADER        (1)
+#define MICROPY_PY_IO_COPY                  (1)
 #define MICROPY_PY_STRUCT                   (1)
+#define MICROPY_PY_STRUCT_STRUCT            (1)
 #define MICROPY_PY_SYS                      (1)
 #define MICROPY_PY_SYS_MAXSIZE              (1)
 #define MICROPY_PY_SYS_MODULES              (1)
@@ -115,15 +124,26 @@
 
 // extended modules
 #define MICROPY_PY_UCTYPES                  (1)
+#define MICROPY_PY_UCTYPES_COMPILE          (1)
 #define MICROPY_PY_UZLIB                    (1)
+#define MICROPY_PY_UZLIB_COMPRESS           (1)
+#define MICROPY_PY_UZLIB_FAST_BITS          (9)
+#define MICROPY_PY_UZLIB_CRC32_SLICES       (4)
 #define MICROPY_PY_UJSON                    (1)
+#define MICROPY_PY_UJSON_ITERLOAD           (1)
 #define MICROPY_PY_URE                      (1)
+#define MICROPY_PY_URE_PIKEVM               (1)
+#define MICROPY_PY_URE_MATCH_SPAN_START_END (1)
+#define MICROPY_PY_URE_SUB                  (1)
+#define MICROPY_PY_URE_FINDITER             (1)
 #define MICROPY_PY_UHEAPQ                   (1)
 #define MICROPY_PY_UTIMEQ                   (1)
+#define MICROPY_PY_UASYNCIO                 (1)
 #define MICROPY_PY_UHASHLIB                 (0) // We use the ESP32 version
 #define MICROPY_PY_UHASHLIB_SHA1            (MICROPY_PY_USSL && MICROPY_SSL_AXTLS)
 #define MICROPY_PY_UBINASCII                (1)
 #define MICROPY_PY_UBINASCII_CRC32          (1)
+#define MICROPY_PY_UBINASCII_INTO           (1)
 #define MICROPY_PY_URANDOM                  (1)
 #define MICROPY_PY_URANDOM_EXTRA_FUNCS      (1)
 #define MICROPY_PY_MACHINE                  (1)
@@ -18,6 +18,10 @@
 
 #undef MICROPY_PY_IO_FILEIO
 #define MICROPY_PY_IO_FILEIO            (0)
+#undef MICROPY_PY_IO_BUFFEREDREADER
+#define MICROPY_PY_IO_BUFFEREDREADER    (0)
+#undef MICROPY_PY_IO_COPY
+#define MICROPY_PY_IO_COPY              (0)
 
 #undef MICROPY_PY_SYS_STDIO_BUFFER
 #define MICROPY_PY_SYS_STDIO_BUFFER     (0)
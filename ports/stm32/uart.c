@@ -88,6 +88,9 @@ struct _pyb_uart_obj_t {
     volatile uint16_t read_buf_head;    // indexes first empty slot
     uint16_t read_buf_tail;             // indexes first full slot (not full if equals head)
     byte *read_buf;                     // byte or uint16_t, depending on char size
+    #if MICROPY_PY_USELECT_NOTIFY
+    mp_stream_poll_notify_t *poll_notify; // notified by the RX IRQ
+    #endif
 };
 
 STATIC mp_obj_t pyb_uart_deinit(mp_obj_t self_in);
@@ -485,6 +488,9 @@ void uart_irq_handler(mp_uint_t uart_id) {
                     self->read_buf[self->read_buf_head] = data;
                 }
                 self->read_buf_head = next_head;
+                #if MICROPY_PY_USELECT_NOTIFY
+                mp_stream_poll_notify(self->poll_notify);
+                #endif
             } else { // No room: leave char in buf, disable interrupt
                 __HAL_UART_DISABLE_IT(&self->uart, UART_IT_RXNE);
             }
@@ -1002,6 +1008,16 @@ STATIC mp_uint_t pyb_uart_ioctl(mp_obj_t self_in, mp_uint_t request, mp_uint_t a
         if ((flags & MP_STREAM_POLL_WR) && __HAL_UART_GET_FLAG(&self->uart, UART_FLAG_TXE)) {
             ret |= MP_STREAM_POLL_WR;
         }
+        #if MICROPY_PY_USELECT_NOTIFY
+        if ((flags & ~ret & MP_STREAM_POLL_WR) || ((flags & ~ret & MP_STREAM_POLL_RD) && self->read_buf_len == 0)) {
+            // there's no IRQ for this, so ask to be polled again
+            mp_stream_poll_notify(self->poll_notify);
+        }
+        #endif
+    #if MICROPY_PY_USELECT_NOTIFY
+    } else if (request == MP_STREAM_SET_POLL_NOTIFY || request == MP_STREAM_CLR_POLL_NOTIFY) {
+        ret = mp_stream_poll_notify_ioctl(&self->poll_notify, request, arg);
+    #endif
     } else {
         *errcode = MP_EINVAL;
         ret = MP_STREAM_ERROR;
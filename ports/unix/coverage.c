@@ -133,6 +133,61 @@ STATIC const mp_obj_type_t mp_type_stest_textio2 = {
     .locals_dict = (mp_obj_dict_t*)&rawfile_locals_dict2,
 };
 
+// stream whose poll readiness is set from Python, possibly from another
+// thread, and which notifies a poller when it changes
+typedef struct _mp_obj_stest_notify_t {
+    mp_obj_base_t base;
+    volatile mp_uint_t ready;
+    mp_stream_poll_notify_t *poll_notify;
+} mp_obj_stest_notify_t;
+
+STATIC mp_obj_t stest_notify_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    (void)args;
+    mp_arg_check_num(n_args, n_kw, 0, 0, false);
+    mp_obj_stest_notify_t *o = m_new_obj(mp_obj_stest_notify_t);
+    o->base.type = type;
+    o->ready = 0;
+    o->poll_notify = NULL;
+    return MP_OBJ_FROM_PTR(o);
+}
+
+STATIC mp_obj_t stest_notify_set_ready(mp_obj_t o_in, mp_obj_t flags_in) {
+    mp_obj_stest_notify_t *o = MP_OBJ_TO_PTR(o_in);
+    o->ready = mp_obj_get_int(flags_in);
+    mp_stream_poll_notify(o->poll_notify);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(stest_notify_set_ready_obj, stest_notify_set_ready);
+
+STATIC mp_uint_t stest_notify_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_stest_notify_t *o = MP_OBJ_TO_PTR(o_in);
+    if (request == MP_STREAM_POLL) {
+        return o->ready & arg;
+    } else if (request == MP_STREAM_SET_POLL_NOTIFY || request == MP_STREAM_CLR_POLL_NOTIFY) {
+        return mp_stream_poll_notify_ioctl(&o->poll_notify, request, arg);
+    }
+    *errcode = MP_EINVAL;
+    return MP_STREAM_ERROR;
+}
+
+STATIC const mp_rom_map_elem_t stest_notify_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_set_ready), MP_ROM_PTR(&stest_notify_set_ready_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(stest_notify_locals_dict, stest_notify_locals_dict_table);
+
+STATIC const mp_stream_p_t stest_notify_stream_p = {
+    .ioctl = stest_notify_ioctl,
+};
+
+const mp_obj_type_t mp_type_stest_notify = {
+    { &mp_type_type },
+    .name = MP_QSTR_stest_notify,
+    .make_new = stest_notify_make_new,
+    .protocol = &stest_notify_stream_p,
+    .locals_dict = (mp_obj_dict_t*)&stest_notify_locals_dict,
+};
+
 // str/bytes objects without a valid hash
 STATIC const mp_obj_str_t str_no_hash_obj = {{&mp_type_str}, 0, 10, (const byte*)"0123456789"};
 STATIC const mp_obj_str_t bytes_no_hash_obj = {{&mp_type_bytes}, 0, 10, (const byte*)"0123456789"};
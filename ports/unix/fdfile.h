@@ -29,12 +29,44 @@
 
 #include "py/obj.h"
 
+#ifndef MICROPY_PY_IO_FILE_BUFFERING
+#define MICROPY_PY_IO_FILE_BUFFERING (0)
+#endif
+
+#if MICROPY_PY_IO_FILE_BUFFERING
+// Userspace buffer of a file object.  It holds either data read ahead of the
+// file position, data[pos:len], or data not yet written, data[0:len].
+typedef struct _mp_fdfile_buf_t {
+    // next file with data not yet written, see mp_fdfile_flush_all
+    struct _mp_obj_fdfile_t *next_dirty;
+    size_t alloc;
+    size_t pos;
+    size_t len;
+    bool writing;
+    // false for files opened read-only, whose writes aren't buffered so
+    // that they fail straight away
+    bool writable;
+    // whether to write out the buffer when a newline is written
+    bool line;
+    byte data[];
+} mp_fdfile_buf_t;
+#endif
+
 typedef struct _mp_obj_fdfile_t {
     mp_obj_base_t base;
     int fd;
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    // NULL if the file is unbuffered
+    mp_fdfile_buf_t *buf;
+    #endif
 } mp_obj_fdfile_t;
 
 extern const mp_obj_type_t mp_type_fileio;
 extern const mp_obj_type_t mp_type_textio;
 
+#if MICROPY_PY_IO_FILE_BUFFERING
+// Write out the buffered data of all files, e.g. before exiting
+void mp_fdfile_flush_all(void);
+#endif
+
 #endif // MICROPY_INCLUDED_UNIX_FDFILE_H
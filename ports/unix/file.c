@@ -25,11 +25,15 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#ifndef _WIN32
+#include <poll.h>
+#endif
 
 #include "py/runtime.h"
 #include "py/stream.h"
@@ -62,9 +66,7 @@ STATIC void fdfile_print(const mp_print_t *print, mp_obj_t self_in, mp_print_kin
     mp_printf(print, "<io.%s %d>", mp_obj_get_type_str(self_in), self->fd);
 }
 
-STATIC mp_uint_t fdfile_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
-    mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
-    check_fd_is_open(o);
+STATIC mp_uint_t fdfile_read_raw(mp_obj_fdfile_t *o, void *buf, mp_uint_t size, int *errcode) {
     mp_int_t r = read(o->fd, buf, size);
     if (r == -1) {
         *errcode = errno;
@@ -73,15 +75,7 @@ STATIC mp_uint_t fdfile_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errc
     return r;
 }
 
-STATIC mp_uint_t fdfile_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
-    mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
-    check_fd_is_open(o);
-    #if MICROPY_PY_OS_DUPTERM
-    if (o->fd <= STDERR_FILENO) {
-        mp_hal_stdout_tx_strn(buf, size);
-        return size;
-    }
-    #endif
+STATIC mp_uint_t fdfile_write_raw(mp_obj_fdfile_t *o, const void *buf, mp_uint_t size, int *errcode) {
     mp_int_t r = write(o->fd, buf, size);
     while (r == -1 && errno == EINTR) {
         if (MP_STATE_VM(mp_pending_exception) != MP_OBJ_NULL) {
@@ -98,12 +92,217 @@ STATIC mp_uint_t fdfile_write(mp_obj_t o_in, const void *buf, mp_uint_t size, in
     return r;
 }
 
+#if MICROPY_PY_IO_FILE_BUFFERING
+
+// Files with data not yet written are kept in a list, so that it can be
+// written out at exit even if they weren't closed
+
+STATIC void fdfile_set_dirty(mp_obj_fdfile_t *o) {
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    o->buf->next_dirty = MP_STATE_PORT(fdfile_dirty);
+    MP_STATE_PORT(fdfile_dirty) = o;
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+STATIC void fdfile_clr_dirty(mp_obj_fdfile_t *o) {
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    mp_obj_fdfile_t **p = (mp_obj_fdfile_t**)&MP_STATE_PORT(fdfile_dirty);
+    while (*p != NULL) {
+        if (*p == o) {
+            *p = o->buf->next_dirty;
+            break;
+        }
+        p = &(*p)->buf->next_dirty;
+    }
+    o->buf->next_dirty = NULL;
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+}
+
+// Writes out the data not yet written; on error, what is left stays buffered
+STATIC mp_uint_t fdfile_flush_buf(mp_obj_fdfile_t *o, int *errcode) {
+    mp_fdfile_buf_t *b = o->buf;
+    if (!b->writing) {
+        return 0;
+    }
+    size_t done = 0;
+    while (done < b->len) {
+        mp_uint_t out_sz = fdfile_write_raw(o, b->data + done, b->len - done, errcode);
+        if (out_sz == MP_STREAM_ERROR || out_sz == 0) {
+            if (out_sz == 0) {
+                *errcode = MP_EIO;
+            }
+            memmove(b->data, b->data + done, b->len - done);
+            b->len -= done;
+            return MP_STREAM_ERROR;
+        }
+        done += out_sz;
+    }
+    b->len = 0;
+    b->writing = false;
+    fdfile_clr_dirty(o);
+    return 0;
+}
+
+// Drops the data read ahead, moving the file position back to where the
+// reader is; fails for files that can't seek, which keep the data
+STATIC mp_uint_t fdfile_drop_read_ahead(mp_obj_fdfile_t *o, int *errcode) {
+    mp_fdfile_buf_t *b = o->buf;
+    if (!b->writing && b->pos != b->len) {
+        if (lseek(o->fd, -(off_t)(b->len - b->pos), SEEK_CUR) == (off_t)-1) {
+            *errcode = errno;
+            return MP_STREAM_ERROR;
+        }
+        b->pos = 0;
+        b->len = 0;
+    }
+    return 0;
+}
+
+// Makes the file position of the fd that of the file object, and leaves
+// nothing buffered
+STATIC mp_uint_t fdfile_sync_buf(mp_obj_fdfile_t *o, int *errcode) {
+    if (o->buf == NULL) {
+        return 0;
+    }
+    if (fdfile_flush_buf(o, errcode) == MP_STREAM_ERROR) {
+        return MP_STREAM_ERROR;
+    }
+    return fdfile_drop_read_ahead(o, errcode);
+}
+
+void mp_fdfile_flush_all(void) {
+    nlr_buf_t nlr;
+    if (nlr_push(&nlr) == 0) {
+        mp_obj_fdfile_t *o;
+        while ((o = MP_STATE_PORT(fdfile_dirty)) != NULL) {
+            int errcode;
+            if (fdfile_flush_buf(o, &errcode) == MP_STREAM_ERROR) {
+                // give up on this file
+                fdfile_clr_dirty(o);
+            }
+        }
+        nlr_pop();
+    }
+}
+
+STATIC mp_uint_t fdfile_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
+    check_fd_is_open(o);
+    mp_fdfile_buf_t *b = o->buf;
+    if (b == NULL) {
+        return fdfile_read_raw(o, buf, size, errcode);
+    }
+    if (fdfile_flush_buf(o, errcode) == MP_STREAM_ERROR) {
+        return MP_STREAM_ERROR;
+    }
+    if (b->pos == b->len) {
+        b->pos = 0;
+        b->len = 0;
+        if (size >= b->alloc) {
+            // nothing to gain from copying through the buffer
+            return fdfile_read_raw(o, buf, size, errcode);
+        }
+        mp_uint_t out_sz = fdfile_read_raw(o, b->data, b->alloc, errcode);
+        if (out_sz == MP_STREAM_ERROR) {
+            return MP_STREAM_ERROR;
+        }
+        b->pos = 0;
+        b->len = out_sz;
+    }
+    if (size > b->len - b->pos) {
+        size = b->len - b->pos;
+    }
+    memcpy(buf, b->data + b->pos, size);
+    b->pos += size;
+    return size;
+}
+
+STATIC mp_uint_t fdfile_write_buffered(mp_obj_fdfile_t *o, const void *buf, mp_uint_t size, int *errcode) {
+    mp_fdfile_buf_t *b = o->buf;
+    if (!b->writable) {
+        return fdfile_write_raw(o, buf, size, errcode);
+    }
+    if (!b->writing) {
+        if (fdfile_drop_read_ahead(o, errcode) == MP_STREAM_ERROR) {
+            // Reading and writing are independent for files that can't
+            // seek, e.g. ttys, so keep the data read ahead and don't buffer
+            return fdfile_write_raw(o, buf, size, errcode);
+        }
+        // all the data read was consumed
+        b->pos = 0;
+        b->len = 0;
+        b->writing = true;
+    }
+    if (b->len + size > b->alloc) {
+        if (fdfile_flush_buf(o, errcode) == MP_STREAM_ERROR) {
+            return MP_STREAM_ERROR;
+        }
+        if (size >= b->alloc) {
+            return fdfile_write_raw(o, buf, size, errcode);
+        }
+        b->writing = true;
+    }
+    if (b->len == 0) {
+        fdfile_set_dirty(o);
+    }
+    memcpy(b->data + b->len, buf, size);
+    b->len += size;
+    if (b->line && memchr(buf, '\n', size) != NULL) {
+        if (fdfile_flush_buf(o, errcode) == MP_STREAM_ERROR) {
+            return MP_STREAM_ERROR;
+        }
+    }
+    return size;
+}
+#else
+#define fdfile_sync_buf(o, errcode) (0)
+
+STATIC mp_uint_t fdfile_read(mp_obj_t o_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
+    check_fd_is_open(o);
+    return fdfile_read_raw(o, buf, size, errcode);
+}
+#endif
+
+STATIC mp_uint_t fdfile_write(mp_obj_t o_in, const void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
+    check_fd_is_open(o);
+    #if MICROPY_PY_OS_DUPTERM
+    if (o->fd <= STDERR_FILENO) {
+        mp_hal_stdout_tx_strn(buf, size);
+        return size;
+    }
+    #endif
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    if (o->buf != NULL) {
+        return fdfile_write_buffered(o, buf, size, errcode);
+    }
+    #endif
+    return fdfile_write_raw(o, buf, size, errcode);
+}
+
 STATIC mp_uint_t fdfile_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
     mp_obj_fdfile_t *o = MP_OBJ_TO_PTR(o_in);
     check_fd_is_open(o);
     switch (request) {
         case MP_STREAM_SEEK: {
             struct mp_stream_seek_t *s = (struct mp_stream_seek_t*)arg;
+            #if MICROPY_PY_IO_FILE_BUFFERING
+            mp_fdfile_buf_t *b = o->buf;
+            if (b != NULL && !b->writing && s->whence == SEEK_CUR && s->offset == 0) {
+                // tell() keeps the data read ahead
+                off_t off = lseek(o->fd, 0, SEEK_CUR);
+                if (off == (off_t)-1) {
+                    *errcode = errno;
+                    return MP_STREAM_ERROR;
+                }
+                s->offset = off - (b->len - b->pos);
+                return 0;
+            }
+            #endif
+            if (fdfile_sync_buf(o, errcode) == MP_STREAM_ERROR) {
+                return MP_STREAM_ERROR;
+            }
             off_t off = lseek(o->fd, s->offset, s->whence);
             if (off == (off_t)-1) {
                 *errcode = errno;
@@ -113,11 +312,47 @@ STATIC mp_uint_t fdfile_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, i
             return 0;
         }
         case MP_STREAM_FLUSH:
-            if (fsync(o->fd) < 0) {
+            #if MICROPY_PY_IO_FILE_BUFFERING
+            if (o->buf != NULL && fdfile_flush_buf(o, errcode) == MP_STREAM_ERROR) {
+                return MP_STREAM_ERROR;
+            }
+            #endif
+            // EINVAL means that the fd doesn't support syncing, e.g. a tty
+            if (fsync(o->fd) < 0 && errno != EINVAL) {
                 *errcode = errno;
                 return MP_STREAM_ERROR;
             }
             return 0;
+        #ifndef _WIN32
+        case MP_STREAM_POLL: {
+            // MP_STREAM_POLL_xxx flags are the same as POLLxxx ones
+            struct pollfd pfd = { .fd = o->fd, .events = arg };
+            if (poll(&pfd, 1, 0) == -1) {
+                *errcode = errno;
+                return MP_STREAM_ERROR;
+            }
+            mp_uint_t ret = pfd.revents & (arg | POLLERR | POLLHUP);
+            #if MICROPY_PY_IO_FILE_BUFFERING
+            if (o->buf != NULL && !o->buf->writing && o->buf->pos != o->buf->len) {
+                ret |= arg & MP_STREAM_POLL_RD;
+            }
+            #endif
+            return ret;
+        }
+        #endif
+        case MP_STREAM_GET_FILENO:
+            #if MICROPY_PY_OS_DUPTERM
+            if (o->fd <= STDERR_FILENO) {
+                // output to these goes through dupterm, not just the fd
+                *errcode = EINVAL;
+                return MP_STREAM_ERROR;
+            }
+            #endif
+            // whoever uses the fd directly must see the same file position
+            if (fdfile_sync_buf(o, errcode) == MP_STREAM_ERROR) {
+                return MP_STREAM_ERROR;
+            }
+            return o->fd;
         default:
             *errcode = EINVAL;
             return MP_STREAM_ERROR;
@@ -126,10 +361,23 @@ STATIC mp_uint_t fdfile_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, i
 
 STATIC mp_obj_t fdfile_close(mp_obj_t self_in) {
     mp_obj_fdfile_t *self = MP_OBJ_TO_PTR(self_in);
+    int err = 0;
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    if (self->buf != NULL) {
+        if (fdfile_flush_buf(self, &err) == MP_STREAM_ERROR) {
+            fdfile_clr_dirty(self);
+        }
+        m_del_var(mp_fdfile_buf_t, byte, self->buf->alloc, self->buf);
+        self->buf = NULL;
+    }
+    #endif
     close(self->fd);
 #ifdef MICROPY_CPYTHON_COMPAT
     self->fd = -1;
 #endif
+    if (err != 0) {
+        mp_raise_OSError(err);
+    }
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(fdfile_close_obj, fdfile_close);
@@ -192,19 +440,52 @@ STATIC mp_obj_t fdfile_open(const mp_obj_type_t *type, mp_arg_val_t *args) {
 
     o->base.type = type;
 
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    // As in CPython, buffering is 0 for unbuffered (binary files only), 1
+    // for line buffering, or the buffer size; by default ttys are line
+    // buffered, and other files fully buffered
+    mp_int_t buf_size = -1;
+    if (args[2].u_obj != mp_const_none) {
+        buf_size = mp_obj_get_int(args[2].u_obj);
+    }
+    bool line = buf_size == 1;
+    if (buf_size == 0 && type == &mp_type_textio) {
+        mp_raise_ValueError("can't have unbuffered text I/O");
+    }
+    if (buf_size < 0 || buf_size == 1) {
+        buf_size = MICROPY_PY_IO_FILE_BUFFER_SIZE;
+    }
+    o->buf = NULL;
+    #endif
+
     mp_obj_t fid = args[0].u_obj;
 
     if (MP_OBJ_IS_SMALL_INT(fid)) {
         o->fd = MP_OBJ_SMALL_INT_VALUE(fid);
-        return MP_OBJ_FROM_PTR(o);
+    } else {
+        const char *fname = mp_obj_str_get_str(fid);
+        int fd = open(fname, mode_x | mode_rw, 0644);
+        if (fd == -1) {
+            mp_raise_OSError(errno);
+        }
+        o->fd = fd;
     }
 
-    const char *fname = mp_obj_str_get_str(fid);
-    int fd = open(fname, mode_x | mode_rw, 0644);
-    if (fd == -1) {
-        mp_raise_OSError(errno);
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    if (buf_size > 0) {
+        mp_fdfile_buf_t *b = m_new_obj_var(mp_fdfile_buf_t, byte, buf_size);
+        b->next_dirty = NULL;
+        b->alloc = buf_size;
+        b->pos = 0;
+        b->len = 0;
+        b->writing = false;
+        int fl = fcntl(o->fd, F_GETFL);
+        b->writable = fl != -1 && (fl & O_ACCMODE) != O_RDONLY;
+        b->line = line || (args[2].u_obj == mp_const_none && isatty(o->fd));
+        o->buf = b;
     }
-    o->fd = fd;
+    #endif
+
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -48,6 +48,7 @@
 #include "extmod/misc.h"
 #include "genhdr/mpversion.h"
 #include "input.h"
+#include "fdfile.h"
 
 // Command line options, with their defaults
 STATIC bool compile_only = false;
@@ -493,6 +494,8 @@ MP_NOINLINE int main_(int argc, char **argv) {
     {
         MP_DECLARE_CONST_FUN_OBJ_0(extra_coverage_obj);
         mp_store_global(QSTR_FROM_STR_STATIC("extra_coverage"), MP_OBJ_FROM_PTR(&extra_coverage_obj));
+        extern const mp_obj_type_t mp_type_stest_notify;
+        mp_store_global(QSTR_FROM_STR_STATIC("stest_notify"), MP_OBJ_FROM_PTR(&mp_type_stest_notify));
     }
     #endif
 
@@ -628,6 +631,11 @@ MP_NOINLINE int main_(int argc, char **argv) {
     }
     #endif
 
+    #if MICROPY_PY_IO_FILE_BUFFERING
+    // Write out what files that weren't closed still have buffered
+    mp_fdfile_flush_all();
+    #endif
+
     mp_deinit();
 
 #if MICROPY_ENABLE_GC && !defined(NDEBUG)
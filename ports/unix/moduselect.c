@@ -32,6 +32,10 @@
 #include <stdio.h>
 #include <errno.h>
 #include <poll.h>
+#if MICROPY_PY_USELECT_EPOLL
+#include <unistd.h>
+#include <sys/epoll.h>
+#endif
 
 #include "py/runtime.h"
 #include "py/obj.h"
@@ -49,19 +53,6 @@ extern const mp_obj_type_t mp_type_socket;
 
 /// \class Poll - poll class
 
-typedef struct _mp_obj_poll_t {
-    mp_obj_base_t base;
-    unsigned short alloc;
-    unsigned short len;
-    struct pollfd *entries;
-    mp_obj_t *obj_map;
-    short iter_cnt;
-    short iter_idx;
-    int flags;
-    // callee-owned tuple
-    mp_obj_t ret_tuple;
-} mp_obj_poll_t;
-
 STATIC int get_fd(mp_obj_t fdlike) {
     int fd;
     // Shortcut for fdfile compatible types
@@ -78,6 +69,256 @@ STATIC int get_fd(mp_obj_t fdlike) {
     return fd;
 }
 
+#if MICROPY_PY_USELECT_EPOLL
+
+// This implementation keeps the registered fds in an epoll instance, so that
+// registering, modifying and unregistering an fd, and polling, take time that
+// depends on the number of ready fds rather than of registered ones.  The
+// POLL* flags have the same values as the EPOLL* ones on Linux, so they are
+// passed through as they are.
+
+typedef struct _mp_obj_poll_t {
+    mp_obj_base_t base;
+    int epfd;
+    // registered objects, or fds as small ints, keyed by fd
+    mp_map_t fds;
+    // fds that epoll doesn't support, mapped to their event mask; these are
+    // regular files and the like, which are always ready
+    mp_map_t files;
+    // ready fds, with room for all registered fds
+    struct epoll_event *ready;
+    unsigned int ready_alloc;
+    short iter_cnt;
+    short iter_idx;
+    int flags;
+    // callee-owned tuple
+    mp_obj_t ret_tuple;
+} mp_obj_poll_t;
+
+// Sets the events that fd is polled for, and adds it to epoll if is_new
+STATIC void poll_set_events(mp_obj_poll_t *self, int fd, mp_uint_t events, bool is_new) {
+    mp_map_elem_t *file = mp_map_lookup(&self->files, MP_OBJ_NEW_SMALL_INT(fd), MP_MAP_LOOKUP);
+    if (file != NULL) {
+        file->value = MP_OBJ_NEW_SMALL_INT(events);
+        return;
+    }
+
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.fd = fd;
+    int op = is_new ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    int ret = epoll_ctl(self->epfd, op, fd, &ev);
+    if (ret == -1 && (errno == EEXIST || errno == ENOENT)) {
+        // the fd was closed, which removes it from epoll, and reused
+        ret = epoll_ctl(self->epfd, is_new ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    }
+    if (ret == -1 && errno == EPERM) {
+        mp_map_lookup(&self->files, MP_OBJ_NEW_SMALL_INT(fd), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value
+            = MP_OBJ_NEW_SMALL_INT(events);
+        return;
+    }
+    RAISE_ERRNO(ret, errno);
+}
+
+/// \method register(obj[, eventmask])
+STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
+    int fd = get_fd(args[1]);
+
+    mp_uint_t flags;
+    if (n_args == 3) {
+        flags = mp_obj_get_int(args[2]);
+    } else {
+        flags = POLLIN | POLLOUT;
+    }
+
+    mp_obj_t key = MP_OBJ_NEW_SMALL_INT(fd);
+    bool is_new = mp_map_lookup(&self->fds, key, MP_MAP_LOOKUP) == NULL;
+    if (is_new && self->fds.used + 1 >= self->ready_alloc) {
+        self->ready = m_renew(struct epoll_event, self->ready, self->ready_alloc, self->ready_alloc * 2);
+        self->ready_alloc *= 2;
+    }
+    poll_set_events(self, fd, flags, is_new);
+    mp_map_lookup(&self->fds, key, MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = args[1];
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
+
+/// \method unregister(obj)
+STATIC mp_obj_t poll_unregister(mp_obj_t self_in, mp_obj_t obj_in) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
+    int fd = get_fd(obj_in);
+    mp_obj_t key = MP_OBJ_NEW_SMALL_INT(fd);
+    if (mp_map_lookup(&self->fds, key, MP_MAP_LOOKUP_REMOVE_IF_FOUND) != NULL
+        && mp_map_lookup(&self->files, key, MP_MAP_LOOKUP_REMOVE_IF_FOUND) == NULL) {
+        // fails if the fd was closed, which removed it already
+        struct epoll_event ev;
+        epoll_ctl(self->epfd, EPOLL_CTL_DEL, fd, &ev);
+    }
+
+    // TODO raise KeyError if obj didn't exist in map
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_2(poll_unregister_obj, poll_unregister);
+
+/// \method modify(obj, eventmask)
+STATIC mp_obj_t poll_modify(mp_obj_t self_in, mp_obj_t obj_in, mp_obj_t eventmask_in) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
+    int fd = get_fd(obj_in);
+    if (mp_map_lookup(&self->fds, MP_OBJ_NEW_SMALL_INT(fd), MP_MAP_LOOKUP) != NULL) {
+        poll_set_events(self, fd, mp_obj_get_int(eventmask_in), false);
+    }
+
+    // TODO raise KeyError if obj didn't exist in map
+    return mp_const_none;
+}
+MP_DEFINE_CONST_FUN_OBJ_3(poll_modify_obj, poll_modify);
+
+STATIC int poll_poll_internal(size_t n_args, const mp_obj_t *args) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    // work out timeout (it's given already in ms)
+    int timeout = -1;
+    int flags = 0;
+    if (n_args >= 2) {
+        if (args[1] != mp_const_none) {
+            mp_int_t timeout_i = mp_obj_get_int(args[1]);
+            if (timeout_i >= 0) {
+                timeout = timeout_i;
+            }
+        }
+        if (n_args >= 3) {
+            flags = mp_obj_get_int(args[2]);
+        }
+    }
+
+    self->flags = flags;
+
+    // fds that epoll doesn't support are ready for whatever they're polled for
+    int n_files = 0;
+    for (size_t i = 0; self->files.used > 0 && i < self->files.alloc; i++) {
+        if (MP_MAP_SLOT_IS_FILLED(&self->files, i)) {
+            mp_uint_t events = MP_OBJ_SMALL_INT_VALUE(self->files.table[i].value) & (POLLIN | POLLOUT);
+            if (events != 0) {
+                self->ready[n_files].events = events;
+                self->ready[n_files].data.fd = MP_OBJ_SMALL_INT_VALUE(self->files.table[i].key);
+                n_files++;
+            }
+        }
+    }
+    if (n_files != 0) {
+        timeout = 0;
+    }
+
+    int n_ready = epoll_wait(self->epfd, self->ready + n_files, self->ready_alloc - n_files, timeout);
+    RAISE_ERRNO(n_ready, errno);
+    return n_files + n_ready;
+}
+
+// Returns the object registered for the ready fd at index i of self->ready,
+// and stops polling it if the last poll was one-shot
+STATIC mp_obj_t poll_get_ready(mp_obj_poll_t *self, int i) {
+    int fd = self->ready[i].data.fd;
+    mp_map_elem_t *elem = mp_map_lookup(&self->fds, MP_OBJ_NEW_SMALL_INT(fd), MP_MAP_LOOKUP);
+    if (elem == NULL) {
+        // unregistered while iterating
+        return MP_OBJ_NEW_SMALL_INT(fd);
+    }
+    if (self->flags & FLAG_ONESHOT) {
+        mp_map_elem_t *file = mp_map_lookup(&self->files, MP_OBJ_NEW_SMALL_INT(fd), MP_MAP_LOOKUP);
+        if (file != NULL) {
+            file->value = MP_OBJ_NEW_SMALL_INT(0);
+        } else {
+            // errors are ignored: an fd closed since the poll is already gone
+            // from epoll, and raising would lose the results gathered so far
+            struct epoll_event ev;
+            ev.events = 0;
+            ev.data.fd = fd;
+            epoll_ctl(self->epfd, EPOLL_CTL_MOD, fd, &ev);
+        }
+    }
+    return elem->value;
+}
+
+/// \method poll([timeout])
+/// Timeout is in milliseconds.
+STATIC mp_obj_t poll_poll(size_t n_args, const mp_obj_t *args) {
+    int n_ready = poll_poll_internal(n_args, args);
+
+    if (n_ready == 0) {
+        return mp_const_empty_tuple;
+    }
+
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    mp_obj_list_t *ret_list = MP_OBJ_TO_PTR(mp_obj_new_list(n_ready, NULL));
+    for (int i = 0; i < n_ready; i++) {
+        mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
+        t->items[0] = poll_get_ready(self, i);
+        t->items[1] = MP_OBJ_NEW_SMALL_INT(self->ready[i].events);
+        ret_list->items[i] = MP_OBJ_FROM_PTR(t);
+    }
+
+    return MP_OBJ_FROM_PTR(ret_list);
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_poll_obj, 1, 3, poll_poll);
+
+STATIC mp_obj_t poll_ipoll(size_t n_args, const mp_obj_t *args) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    if (self->ret_tuple == MP_OBJ_NULL) {
+        self->ret_tuple = mp_obj_new_tuple(2, NULL);
+    }
+
+    int n_ready = poll_poll_internal(n_args, args);
+    self->iter_cnt = n_ready;
+    self->iter_idx = 0;
+
+    return args[0];
+}
+MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_ipoll_obj, 1, 3, poll_ipoll);
+
+STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->iter_cnt == 0) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+
+    self->iter_cnt--;
+
+    int i = self->iter_idx++;
+    mp_obj_tuple_t *t = MP_OBJ_TO_PTR(self->ret_tuple);
+    t->items[0] = poll_get_ready(self, i);
+    t->items[1] = MP_OBJ_NEW_SMALL_INT(self->ready[i].events);
+    return MP_OBJ_FROM_PTR(t);
+}
+
+STATIC mp_obj_t poll_close(mp_obj_t self_in) {
+    mp_obj_poll_t *self = MP_OBJ_TO_PTR(self_in);
+    if (self->epfd != -1) {
+        close(self->epfd);
+        self->epfd = -1;
+    }
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(poll_close_obj, poll_close);
+
+#else
+
+typedef struct _mp_obj_poll_t {
+    mp_obj_base_t base;
+    unsigned short alloc;
+    unsigned short len;
+    struct pollfd *entries;
+    mp_obj_t *obj_map;
+    short iter_cnt;
+    short iter_idx;
+    int flags;
+    // callee-owned tuple
+    mp_obj_t ret_tuple;
+} mp_obj_poll_t;
+
 /// \method register(obj[, eventmask])
 STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     mp_obj_poll_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -98,7 +339,7 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
         int entry_fd = entry->fd;
         if (entry_fd == fd) {
             entry->events = flags;
-            return mp_const_false;
+            return mp_const_none;
         }
         if (entry_fd == -1) {
             free_slot = entry;
@@ -126,7 +367,7 @@ STATIC mp_obj_t poll_register(size_t n_args, const mp_obj_t *args) {
     free_slot->fd = fd;
     free_slot->events = flags;
     free_slot->revents = 0;
-    return mp_const_true;
+    return mp_const_none;
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(poll_register_obj, 2, 3, poll_register);
 
@@ -277,12 +518,17 @@ STATIC mp_obj_t poll_iternext(mp_obj_t self_in) {
     return MP_OBJ_STOP_ITERATION;
 }
 
+#endif
+
 STATIC const mp_rom_map_elem_t poll_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_register), MP_ROM_PTR(&poll_register_obj) },
     { MP_ROM_QSTR(MP_QSTR_unregister), MP_ROM_PTR(&poll_unregister_obj) },
     { MP_ROM_QSTR(MP_QSTR_modify), MP_ROM_PTR(&poll_modify_obj) },
     { MP_ROM_QSTR(MP_QSTR_poll), MP_ROM_PTR(&poll_poll_obj) },
     { MP_ROM_QSTR(MP_QSTR_ipoll), MP_ROM_PTR(&poll_ipoll_obj) },
+    #if MICROPY_PY_USELECT_EPOLL
+    { MP_ROM_QSTR(MP_QSTR___del__), MP_ROM_PTR(&poll_close_obj) },
+    #endif
 };
 STATIC MP_DEFINE_CONST_DICT(poll_locals_dict, poll_locals_dict_table);
 
@@ -294,6 +540,26 @@ STATIC const mp_obj_type_t mp_type_poll = {
     .locals_dict = (void*)&poll_locals_dict,
 };
 
+#if MICROPY_PY_USELECT_EPOLL
+STATIC mp_obj_t select_poll(size_t n_args, const mp_obj_t *args) {
+    int alloc = 4;
+    if (n_args > 0) {
+        alloc = mp_obj_get_int(args[0]);
+    }
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    RAISE_ERRNO(epfd, errno);
+    mp_obj_poll_t *poll = m_new_obj_with_finaliser(mp_obj_poll_t);
+    poll->base.type = &mp_type_poll;
+    poll->epfd = epfd;
+    mp_map_init(&poll->fds, alloc);
+    mp_map_init(&poll->files, 0);
+    poll->ready_alloc = alloc < 4 ? 4 : alloc;
+    poll->ready = m_new(struct epoll_event, poll->ready_alloc);
+    poll->iter_cnt = 0;
+    poll->ret_tuple = MP_OBJ_NULL;
+    return MP_OBJ_FROM_PTR(poll);
+}
+#else
 STATIC mp_obj_t select_poll(size_t n_args, const mp_obj_t *args) {
     int alloc = 4;
     if (n_args > 0) {
@@ -309,6 +575,8 @@ STATIC mp_obj_t select_poll(size_t n_args, const mp_obj_t *args) {
     poll->ret_tuple = MP_OBJ_NULL;
     return MP_OBJ_FROM_PTR(poll);
 }
+
+#endif
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_select_poll_obj, 0, 1, select_poll);
 
 STATIC const mp_rom_map_elem_t mp_module_select_globals_table[] = {
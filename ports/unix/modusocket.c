@@ -25,6 +25,9 @@
  * THE SOFTWARE.
  */
 
+#ifdef __linux__
+#define _GNU_SOURCE // for recvmmsg and sendmmsg
+#endif
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
@@ -37,6 +40,8 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <errno.h>
+#include <poll.h>
+#include <sys/uio.h>
 
 #include "py/objtuple.h"
 #include "py/objstr.h"
@@ -108,6 +113,23 @@ STATIC mp_uint_t socket_write(mp_obj_t o_in, const void *buf, mp_uint_t size, in
     return r;
 }
 
+STATIC mp_uint_t socket_ioctl(mp_obj_t o_in, mp_uint_t request, uintptr_t arg, int *errcode) {
+    mp_obj_socket_t *o = MP_OBJ_TO_PTR(o_in);
+    if (request == MP_STREAM_POLL) {
+        // MP_STREAM_POLL_xxx flags are the same as POLLxxx ones
+        struct pollfd pfd = { .fd = o->fd, .events = arg };
+        if (poll(&pfd, 1, 0) == -1) {
+            *errcode = errno;
+            return MP_STREAM_ERROR;
+        }
+        return pfd.revents & (arg | POLLERR | POLLHUP);
+    } else if (request == MP_STREAM_GET_FILENO) {
+        return o->fd;
+    }
+    *errcode = EINVAL;
+    return MP_STREAM_ERROR;
+}
+
 STATIC mp_obj_t socket_close(mp_obj_t self_in) {
     mp_obj_socket_t *self = MP_OBJ_TO_PTR(self_in);
     // There's a POSIX drama regarding return value of close in general,
@@ -118,6 +140,7 @@ STATIC mp_obj_t socket_close(mp_obj_t self_in) {
     // file descriptor. If you're interested to catch I/O errors before
     // closing fd, fsync() it.
     close(self->fd);
+    self->fd = -1;
     return mp_const_none;
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_1(socket_close_obj, socket_close);
@@ -185,16 +208,42 @@ STATIC mp_obj_t socket_recv(size_t n_args, const mp_obj_t *args) {
         flags = MP_OBJ_SMALL_INT_VALUE(args[2]);
     }
 
-    byte *buf = m_new(byte, sz);
-    int out_sz = recv(self->fd, buf, sz, flags);
+    vstr_t vstr;
+    vstr_init_len(&vstr, sz);
+    int out_sz = recv(self->fd, vstr.buf, sz, flags);
     RAISE_ERRNO(out_sz, errno);
 
-    mp_obj_t ret = mp_obj_new_str_of_type(&mp_type_bytes, buf, out_sz);
-    m_del(char, buf, sz);
-    return ret;
+    vstr.len = out_sz;
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_obj, 2, 3, socket_recv);
 
+// Gets the buffer and the nbytes and flags arguments of recv_into and
+// recvfrom_into; nbytes of 0 or not given means the whole buffer.
+STATIC int socket_get_recv_into_args(size_t n_args, const mp_obj_t *args, mp_buffer_info_t *bufinfo) {
+    mp_get_buffer_raise(args[1], bufinfo, MP_BUFFER_WRITE);
+    if (n_args > 2) {
+        mp_int_t nbytes = mp_obj_get_int(args[2]);
+        if (nbytes < 0 || (size_t)nbytes > bufinfo->len) {
+            mp_raise_ValueError("nbytes is greater than the length of the buffer");
+        }
+        if (nbytes != 0) {
+            bufinfo->len = nbytes;
+        }
+    }
+    return n_args > 3 ? mp_obj_get_int(args[3]) : 0;
+}
+
+STATIC mp_obj_t socket_recv_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    int flags = socket_get_recv_into_args(n_args, args, &bufinfo);
+    int out_sz = recv(self->fd, bufinfo.buf, bufinfo.len, flags);
+    RAISE_ERRNO(out_sz, errno);
+    return MP_OBJ_NEW_SMALL_INT(out_sz);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_into_obj, 2, 4, socket_recv_into);
+
 STATIC mp_obj_t socket_recvfrom(size_t n_args, const mp_obj_t *args) {
     mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
     int sz = MP_OBJ_SMALL_INT_VALUE(args[1]);
@@ -207,21 +256,38 @@ STATIC mp_obj_t socket_recvfrom(size_t n_args, const mp_obj_t *args) {
     struct sockaddr_storage addr;
     socklen_t addr_len = sizeof(addr);
 
-    byte *buf = m_new(byte, sz);
-    int out_sz = recvfrom(self->fd, buf, sz, flags, (struct sockaddr*)&addr, &addr_len);
+    vstr_t vstr;
+    vstr_init_len(&vstr, sz);
+    int out_sz = recvfrom(self->fd, vstr.buf, sz, flags, (struct sockaddr*)&addr, &addr_len);
     RAISE_ERRNO(out_sz, errno);
 
-    mp_obj_t buf_o = mp_obj_new_str_of_type(&mp_type_bytes, buf, out_sz);
-    m_del(char, buf, sz);
-
+    vstr.len = out_sz;
     mp_obj_tuple_t *t = MP_OBJ_TO_PTR(mp_obj_new_tuple(2, NULL));
-    t->items[0] = buf_o;
+    t->items[0] = mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
     t->items[1] = mp_obj_from_sockaddr((struct sockaddr*)&addr, addr_len);
 
     return MP_OBJ_FROM_PTR(t);
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvfrom_obj, 2, 3, socket_recvfrom);
 
+STATIC mp_obj_t socket_recvfrom_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_buffer_info_t bufinfo;
+    int flags = socket_get_recv_into_args(n_args, args, &bufinfo);
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+    int out_sz = recvfrom(self->fd, bufinfo.buf, bufinfo.len, flags, (struct sockaddr*)&addr, &addr_len);
+    RAISE_ERRNO(out_sz, errno);
+
+    mp_obj_t tuple[2] = {
+        MP_OBJ_NEW_SMALL_INT(out_sz),
+        mp_obj_from_sockaddr((struct sockaddr*)&addr, addr_len),
+    };
+    return mp_obj_new_tuple(2, tuple);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recvfrom_into_obj, 2, 4, socket_recvfrom_into);
+
 // Note: besides flag param, this differs from write() in that
 // this does not swallow blocking errors (EAGAIN, EWOULDBLOCK) -
 // these would be thrown as exceptions.
@@ -263,6 +329,186 @@ STATIC mp_obj_t socket_sendto(size_t n_args, const mp_obj_t *args) {
 }
 STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendto_obj, 3, 4, socket_sendto);
 
+// sendmsg(buffers[, ancdata[, flags[, address]]]): sends the data of all the
+// buffers with one call; ancillary data isn't supported, so must be empty
+STATIC mp_obj_t socket_sendmsg(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    if (n_args > 2 && mp_obj_get_int(mp_obj_len(args[2])) != 0) {
+        mp_raise_NotImplementedError("ancdata");
+    }
+    int flags = n_args > 3 ? mp_obj_get_int(args[3]) : 0;
+
+    struct msghdr msg = {0};
+    mp_buffer_info_t addr_bi;
+    if (n_args > 4 && args[4] != mp_const_none) {
+        mp_get_buffer_raise(args[4], &addr_bi, MP_BUFFER_READ);
+        msg.msg_name = addr_bi.buf;
+        msg.msg_namelen = addr_bi.len;
+    }
+
+    size_t n_bufs;
+    mp_obj_t *bufs;
+    mp_obj_get_array(args[1], &n_bufs, &bufs);
+    struct iovec iov_stack[8];
+    struct iovec *iov = iov_stack;
+    if (n_bufs > MP_ARRAY_SIZE(iov_stack)) {
+        iov = m_new(struct iovec, n_bufs);
+    }
+    for (size_t i = 0; i < n_bufs; i++) {
+        mp_buffer_info_t bufinfo;
+        mp_get_buffer_raise(bufs[i], &bufinfo, MP_BUFFER_READ);
+        iov[i].iov_base = bufinfo.buf;
+        iov[i].iov_len = bufinfo.len;
+    }
+    msg.msg_iov = iov;
+    msg.msg_iovlen = n_bufs;
+
+    int out_sz = sendmsg(self->fd, &msg, flags);
+    if (iov != iov_stack) {
+        m_del(struct iovec, iov, n_bufs);
+    }
+    RAISE_ERRNO(out_sz, errno);
+
+    return MP_OBJ_NEW_SMALL_INT(out_sz);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_sendmsg_obj, 2, 5, socket_sendmsg);
+
+#if MICROPY_PY_USOCKET_MMSG
+
+// Messages handled by one recvmmsg/sendmmsg call, with their headers on the
+// C stack
+#define MMSG_BATCH (16)
+
+// Gets the items of the list lst, which needs at least n of them, or NULL if
+// lst is None
+STATIC mp_obj_t *socket_mmsg_list(mp_obj_t lst, size_t n) {
+    if (lst == mp_const_none) {
+        return NULL;
+    }
+    if (!MP_OBJ_IS_TYPE(lst, &mp_type_list)) {
+        mp_raise_TypeError(NULL);
+    }
+    size_t len;
+    mp_obj_t *items;
+    mp_obj_list_get(lst, &len, &items);
+    if (len < n) {
+        mp_raise_ValueError(NULL);
+    }
+    return items;
+}
+
+// recv_many(bufs[, sizes[, addrs[, addr_sizes[, flags]]]]): receives datagrams
+// into the buffers of the list bufs, waiting only for the first one, and
+// returns how many were received.  Their sizes are stored in the list sizes,
+// the addresses of their senders are written to the buffers of the list addrs,
+// and the full lengths of those addresses are stored in the list addr_sizes;
+// any of these can be None.
+STATIC mp_obj_t socket_recv_many(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t n_bufs;
+    mp_obj_t *bufs;
+    mp_obj_get_array(args[1], &n_bufs, &bufs);
+    mp_obj_t *sizes = socket_mmsg_list(n_args > 2 ? args[2] : mp_const_none, n_bufs);
+    mp_obj_t *addrs = socket_mmsg_list(n_args > 3 ? args[3] : mp_const_none, n_bufs);
+    mp_obj_t *addr_sizes = socket_mmsg_list(n_args > 4 ? args[4] : mp_const_none, n_bufs);
+    int flags = (n_args > 5 ? mp_obj_get_int(args[5]) : 0) | MSG_WAITFORONE;
+
+    struct mmsghdr msgs[MMSG_BATCH];
+    struct iovec iov[MMSG_BATCH];
+    size_t n_recv = 0;
+    while (n_recv < n_bufs) {
+        size_t n = MIN(n_bufs - n_recv, MMSG_BATCH);
+        memset(msgs, 0, n * sizeof(*msgs));
+        for (size_t i = 0; i < n; i++) {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(bufs[n_recv + i], &bufinfo, MP_BUFFER_WRITE);
+            iov[i].iov_base = bufinfo.buf;
+            iov[i].iov_len = bufinfo.len;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            if (addrs != NULL) {
+                mp_get_buffer_raise(addrs[n_recv + i], &bufinfo, MP_BUFFER_WRITE);
+                msgs[i].msg_hdr.msg_name = bufinfo.buf;
+                msgs[i].msg_hdr.msg_namelen = bufinfo.len;
+            }
+        }
+        int r = recvmmsg(self->fd, msgs, n, flags, NULL);
+        if (r == -1) {
+            if (n_recv != 0) {
+                // report what was received; a pending socket error is lost here
+                break;
+            }
+            RAISE_ERRNO(r, errno);
+        }
+        for (int i = 0; i < r; i++) {
+            if (sizes != NULL) {
+                sizes[n_recv + i] = MP_OBJ_NEW_SMALL_INT(msgs[i].msg_len);
+            }
+            if (addr_sizes != NULL) {
+                // larger than the buffer if the address was truncated, 0 if there is none
+                addr_sizes[n_recv + i] = MP_OBJ_NEW_SMALL_INT(msgs[i].msg_hdr.msg_namelen);
+            }
+        }
+        n_recv += r;
+        if ((size_t)r < n) {
+            break;
+        }
+        // only wait for the first datagram
+        flags |= MSG_DONTWAIT;
+    }
+    return MP_OBJ_NEW_SMALL_INT(n_recv);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_recv_many_obj, 2, 6, socket_recv_many);
+
+// send_many(bufs[, addrs[, flags]]): sends each buffer of the list bufs as a
+// datagram, to the address at the same index of the list addrs, or to the
+// connected address if addrs is None, and returns how many were sent.
+STATIC mp_obj_t socket_send_many(size_t n_args, const mp_obj_t *args) {
+    mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
+    size_t n_bufs;
+    mp_obj_t *bufs;
+    mp_obj_get_array(args[1], &n_bufs, &bufs);
+    mp_obj_t *addrs = socket_mmsg_list(n_args > 2 ? args[2] : mp_const_none, n_bufs);
+    int flags = n_args > 3 ? mp_obj_get_int(args[3]) : 0;
+
+    struct mmsghdr msgs[MMSG_BATCH];
+    struct iovec iov[MMSG_BATCH];
+    size_t n_sent = 0;
+    while (n_sent < n_bufs) {
+        size_t n = MIN(n_bufs - n_sent, MMSG_BATCH);
+        memset(msgs, 0, n * sizeof(*msgs));
+        for (size_t i = 0; i < n; i++) {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(bufs[n_sent + i], &bufinfo, MP_BUFFER_READ);
+            iov[i].iov_base = bufinfo.buf;
+            iov[i].iov_len = bufinfo.len;
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            if (addrs != NULL) {
+                mp_get_buffer_raise(addrs[n_sent + i], &bufinfo, MP_BUFFER_READ);
+                msgs[i].msg_hdr.msg_name = bufinfo.buf;
+                msgs[i].msg_hdr.msg_namelen = bufinfo.len;
+            }
+        }
+        int r = sendmmsg(self->fd, msgs, n, flags);
+        if (r == -1) {
+            if (n_sent != 0) {
+                // report what was sent; a pending socket error is lost here
+                break;
+            }
+            RAISE_ERRNO(r, errno);
+        }
+        n_sent += r;
+        if ((size_t)r < n) {
+            break;
+        }
+    }
+    return MP_OBJ_NEW_SMALL_INT(n_sent);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(socket_send_many_obj, 2, 4, socket_send_many);
+
+#endif // MICROPY_PY_USOCKET_MMSG
+
 STATIC mp_obj_t socket_setsockopt(size_t n_args, const mp_obj_t *args) {
     (void)n_args; // always 4
     mp_obj_socket_t *self = MP_OBJ_TO_PTR(args[0]);
@@ -355,8 +601,15 @@ STATIC const mp_rom_map_elem_t usocket_locals_dict_table[] = {
     { MP_ROM_QSTR(MP_QSTR_accept), MP_ROM_PTR(&socket_accept_obj) },
     { MP_ROM_QSTR(MP_QSTR_recv), MP_ROM_PTR(&socket_recv_obj) },
     { MP_ROM_QSTR(MP_QSTR_recvfrom), MP_ROM_PTR(&socket_recvfrom_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recv_into), MP_ROM_PTR(&socket_recv_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_recvfrom_into), MP_ROM_PTR(&socket_recvfrom_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_send), MP_ROM_PTR(&socket_send_obj) },
     { MP_ROM_QSTR(MP_QSTR_sendto), MP_ROM_PTR(&socket_sendto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_sendmsg), MP_ROM_PTR(&socket_sendmsg_obj) },
+    #if MICROPY_PY_USOCKET_MMSG
+    { MP_ROM_QSTR(MP_QSTR_recv_many), MP_ROM_PTR(&socket_recv_many_obj) },
+    { MP_ROM_QSTR(MP_QSTR_send_many), MP_ROM_PTR(&socket_send_many_obj) },
+    #endif
     { MP_ROM_QSTR(MP_QSTR_setsockopt), MP_ROM_PTR(&socket_setsockopt_obj) },
     { MP_ROM_QSTR(MP_QSTR_setblocking), MP_ROM_PTR(&socket_setblocking_obj) },
     { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&socket_close_obj) },
@@ -367,6 +620,7 @@ STATIC MP_DEFINE_CONST_DICT(usocket_locals_dict, usocket_locals_dict_table);
 STATIC const mp_stream_p_t usocket_stream_p = {
     .read = socket_read,
     .write = socket_write,
+    .ioctl = socket_ioctl,
 };
 
 const mp_obj_type_t mp_type_socket = {
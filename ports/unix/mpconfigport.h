@@ -70,9 +70,15 @@
 #ifndef MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (1)
 #endif
+#define MICROPY_OPT_INSTANCE_SHARED_KEYS (1)
+#define MICROPY_OPT_MPZ_KARATSUBA   (1)
+#define MICROPY_OPT_MPZ_MONTGOMERY  (1)
+#define MICROPY_OPT_MPZ_FAST_STR    (1)
+#define MICROPY_OPT_FLOAT_ROUNDTRIP (1)
 #define MICROPY_CAN_OVERRIDE_BUILTINS (1)
 #define MICROPY_PY_FUNCTION_ATTRS   (1)
 #define MICROPY_PY_DESCRIPTORS      (1)
+#define MICROPY_PY_SLOTS            (1)
 #define MICROPY_PY_BUILTINS_STR_UNICODE (1)
 #define MICROPY_PY_BUILTINS_STR_CENTER (1)
 #define MICROPY_PY_BUILTINS_STR_PARTITION (1)
@@ -87,6 +93,7 @@
 #define MICROPY_PY_ALL_SPECIAL_METHODS (1)
 #define MICROPY_PY_REVERSE_SPECIAL_METHODS (1)
 #define MICROPY_PY_ARRAY_SLICE_ASSIGN (1)
+#define MICROPY_PY_STRUCT_STRUCT    (1)
 #define MICROPY_PY_BUILTINS_SLICE_ATTRS (1)
 #define MICROPY_PY_SYS_EXIT         (1)
 #if defined(__APPLE__) && defined(__MACH__)
@@ -104,6 +111,13 @@
 #define MICROPY_PY_CMATH            (1)
 #define MICROPY_PY_IO_FILEIO        (1)
 #define MICROPY_PY_IO_RESOURCE_STREAM (1)
+#define MICROPY_PY_IO_BUFFEREDREADER (1)
+#define MICROPY_PY_IO_COPY          (1)
+// Files opened with open() are buffered, by default with this buffer size
+#ifndef MICROPY_PY_IO_FILE_BUFFERING
+#define MICROPY_PY_IO_FILE_BUFFERING (1)
+#endif
+#define MICROPY_PY_IO_FILE_BUFFER_SIZE (4096)
 #define MICROPY_PY_GC_COLLECT_RETVAL (1)
 #define MICROPY_MODULE_FROZEN_STR   (1)
 
@@ -115,21 +129,54 @@
 #define MICROPY_PY_UTIME_MP_HAL     (1)
 #define MICROPY_PY_UERRNO           (1)
 #define MICROPY_PY_UCTYPES          (1)
+#define MICROPY_PY_UCTYPES_COMPILE  (1)
 #define MICROPY_PY_UZLIB            (1)
+#define MICROPY_PY_UZLIB_COMPRESS   (1)
+#define MICROPY_PY_UZLIB_FAST_BITS  (9)
+#define MICROPY_PY_UZLIB_CRC32_SLICES (8)
 #define MICROPY_PY_UJSON            (1)
+#define MICROPY_PY_UJSON_ITERLOAD   (1)
 #define MICROPY_PY_URE              (1)
+#define MICROPY_PY_URE_PIKEVM       (1)
+#define MICROPY_PY_URE_MATCH_SPAN_START_END (1)
+#define MICROPY_PY_URE_SUB          (1)
+#define MICROPY_PY_URE_FINDITER     (1)
 #define MICROPY_PY_UHEAPQ           (1)
 #define MICROPY_PY_UTIMEQ           (1)
+#define MICROPY_PY_UASYNCIO         (1)
 #define MICROPY_PY_UHASHLIB         (1)
 #if MICROPY_PY_USSL && MICROPY_SSL_AXTLS
 #define MICROPY_PY_UHASHLIB_SHA1    (1)
 #endif
 #define MICROPY_PY_UBINASCII        (1)
 #define MICROPY_PY_UBINASCII_CRC32  (1)
+#define MICROPY_PY_UBINASCII_INTO   (1)
 #define MICROPY_PY_URANDOM          (1)
 #ifndef MICROPY_PY_USELECT_POSIX
 #define MICROPY_PY_USELECT_POSIX    (1)
 #endif
+// Whether uselect.poll is implemented with epoll, so that its methods don't
+// take time proportional to the number of registered fds
+#ifndef MICROPY_PY_USELECT_EPOLL
+#ifdef __linux__
+#define MICROPY_PY_USELECT_EPOLL    (1)
+#else
+#define MICROPY_PY_USELECT_EPOLL    (0)
+#endif
+#endif
+// Whether to also build the generic uselect module, with stream notifications
+#ifndef MICROPY_PY_USELECT_GENERIC
+#define MICROPY_PY_USELECT_GENERIC  (0)
+#endif
+#define MICROPY_PY_USELECT_NOTIFY   (MICROPY_PY_USELECT_GENERIC)
+// Whether sockets have recv_many and send_many, built on recvmmsg and sendmmsg
+#ifndef MICROPY_PY_USOCKET_MMSG
+#ifdef __linux__
+#define MICROPY_PY_USOCKET_MMSG     (1)
+#else
+#define MICROPY_PY_USOCKET_MMSG     (0)
+#endif
+#endif
 #define MICROPY_PY_WEBSOCKET        (1)
 #define MICROPY_PY_MACHINE          (1)
 #define MICROPY_PY_MACHINE_PULSE    (1)
@@ -274,6 +321,39 @@ void mp_unix_mark_exec(void);
 // with EINTR, updates remaining timeout value.
 #define MICROPY_SELECT_REMAINING_TIME (1)
 
+#if MICROPY_PY_USELECT_GENERIC
+// Streams may notify a poller from other threads
+#if MICROPY_PY_THREAD
+#define MICROPY_BEGIN_ATOMIC_SECTION() (mp_thread_unix_begin_atomic_section(), 0)
+#define MICROPY_END_ATOMIC_SECTION(x) (void)x; mp_thread_unix_end_atomic_section()
+void mp_thread_unix_begin_atomic_section(void);
+void mp_thread_unix_end_atomic_section(void);
+#endif
+
+// The generic uselect checks streams which can't notify it (files, sockets)
+// in a loop; sleep a little between rounds so that doesn't take a whole CPU
+#define MICROPY_EVENT_POLL_HOOK \
+    do { \
+        extern void mp_handle_pending(void); \
+        mp_handle_pending(); \
+        usleep(500); \
+    } while (0);
+
+// The generic uselect.poll sleeps until a stream notifies it
+#define MICROPY_PY_USELECT_WAIT(dirty_ptr, timeout_ms) \
+    do { \
+        extern void mp_handle_pending(void); \
+        mp_hal_poll_wait(dirty_ptr, timeout_ms); \
+        mp_handle_pending(); \
+    } while (0)
+#define MICROPY_PY_USELECT_WAKE() mp_hal_poll_wake()
+#endif
+
+#ifdef __linux__
+// uio.copy() between file descriptors uses sendfile() and splice()
+#define MICROPY_PY_IO_COPY_FD(src_fd, dst_fd, n, errcode) mp_hal_copy_fd(src_fd, dst_fd, n, errcode)
+#endif
+
 #ifdef __ANDROID__
 #include <android/api-level.h>
 #if __ANDROID_API__ < 4
@@ -291,6 +371,7 @@ void mp_unix_mark_exec(void);
 #define MICROPY_PORT_ROOT_POINTERS \
     const char *readline_hist[50]; \
     void *mmap_region_head; \
+    struct _mp_obj_fdfile_t *fdfile_dirty; \
 
 // We need to provide a declaration/definition of alloca()
 // unless support for it is disabled.
@@ -29,6 +29,7 @@
 
 #define MICROPY_VFS                    (1)
 #define MICROPY_PY_UOS_VFS             (1)
+#define MICROPY_PY_USELECT_GENERIC     (1)
 
 #include <mpconfigport.h>
 
@@ -53,6 +53,15 @@ static inline void mp_hal_delay_ms(mp_uint_t ms) { usleep((ms) * 1000); }
 static inline void mp_hal_delay_us(mp_uint_t us) { usleep(us); }
 #define mp_hal_ticks_cpu() 0
 
+// Wait until *ptr is set and mp_hal_poll_wake is called from another thread,
+// or for up to timeout_ms (-1 for no limit); may return early
+void mp_hal_poll_wait(void *volatile *ptr, int timeout_ms);
+void mp_hal_poll_wake(void);
+
+// Copy up to n bytes from src_fd to dst_fd within the kernel; sets *errcode
+// to MP_EOPNOTSUPP if this pair of descriptors doesn't allow that
+mp_uint_t mp_hal_copy_fd(int src_fd, int dst_fd, mp_uint_t n, int *errcode);
+
 #define RAISE_ERRNO(err_flag, error_val) \
     { if (err_flag == -1) \
         { mp_raise_OSError(error_val); } }
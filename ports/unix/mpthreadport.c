@@ -51,6 +51,11 @@ STATIC pthread_key_t tls_key;
 STATIC pthread_mutex_t thread_mutex = PTHREAD_MUTEX_INITIALIZER;
 STATIC thread_t *thread;
 
+#if MICROPY_PY_USELECT_GENERIC
+// the atomic section is recursive, so a notifier may be called from within one
+STATIC pthread_mutex_t atomic_mutex;
+#endif
+
 // this is used to synchronise the signal handler of the thread
 // it's needed because we can't use any pthread calls in a signal handler
 STATIC volatile int thread_signal_done;
@@ -74,6 +79,14 @@ void mp_thread_init(void) {
     pthread_key_create(&tls_key, NULL);
     pthread_setspecific(tls_key, &mp_state_ctx.thread);
 
+    #if MICROPY_PY_USELECT_GENERIC
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&atomic_mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    #endif
+
     // create first entry in linked list of all threads
     thread = malloc(sizeof(thread_t));
     thread->id = pthread_self();
@@ -224,4 +237,16 @@ void mp_thread_mutex_unlock(mp_thread_mutex_t *mutex) {
     // TODO check return value
 }
 
+#if MICROPY_PY_USELECT_GENERIC
+
+void mp_thread_unix_begin_atomic_section(void) {
+    pthread_mutex_lock(&atomic_mutex);
+}
+
+void mp_thread_unix_end_atomic_section(void) {
+    pthread_mutex_unlock(&atomic_mutex);
+}
+
+#endif
+
 #endif // MICROPY_PY_THREAD
@@ -24,13 +24,18 @@
  * THE SOFTWARE.
  */
 
+#ifdef __linux__
+#define _GNU_SOURCE // for splice
+#endif
 #include <unistd.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
+#include <time.h>
 
 #include "py/mphal.h"
 #include "py/runtime.h"
+#include "py/stream.h"
 #include "extmod/misc.h"
 
 #ifndef _WIN32
@@ -197,3 +202,100 @@ mp_uint_t mp_hal_ticks_us(void) {
     gettimeofday(&tv, NULL);
     return tv.tv_sec * 1000000 + tv.tv_usec;
 }
+
+#if MICROPY_PY_USELECT_NOTIFY
+// Waits are done in slices, so that a pending KeyboardInterrupt is seen
+#define POLL_WAIT_SLICE_MS (50)
+
+#if MICROPY_PY_THREAD
+STATIC pthread_mutex_t poll_wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+STATIC pthread_cond_t poll_wake_cond = PTHREAD_COND_INITIALIZER;
+#endif
+
+void mp_hal_poll_wait(void *volatile *ptr, int timeout_ms) {
+    if (timeout_ms < 0 || timeout_ms > POLL_WAIT_SLICE_MS) {
+        timeout_ms = POLL_WAIT_SLICE_MS;
+    }
+    #if MICROPY_PY_THREAD
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_nsec += timeout_ms * 1000000L;
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000L;
+    }
+    // the notifier sets *ptr before taking the mutex to wake us up
+    pthread_mutex_lock(&poll_wake_mutex);
+    while (*ptr == NULL) {
+        if (pthread_cond_timedwait(&poll_wake_cond, &poll_wake_mutex, &ts) != 0) {
+            break;
+        }
+    }
+    pthread_mutex_unlock(&poll_wake_mutex);
+    #else
+    // only another thread could notify
+    (void)ptr;
+    usleep(timeout_ms * 1000);
+    #endif
+}
+
+void mp_hal_poll_wake(void) {
+    #if MICROPY_PY_THREAD
+    pthread_mutex_lock(&poll_wake_mutex);
+    pthread_cond_broadcast(&poll_wake_cond);
+    pthread_mutex_unlock(&poll_wake_mutex);
+    #endif
+}
+#endif
+
+#if MICROPY_PY_IO_COPY && defined(MICROPY_PY_IO_COPY_FD)
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+
+// Most bytes moved by one system call, so that a KeyboardInterrupt is
+// handled between calls
+#define COPY_FD_CHUNK (1024 * 1024)
+
+mp_uint_t mp_hal_copy_fd(int src_fd, int dst_fd, mp_uint_t n, int *errcode) {
+    // sendfile() needs a source that can be mapped, such as a regular file;
+    // otherwise splice() works when either end is a pipe
+    bool use_splice = false;
+    mp_uint_t done = 0;
+    *errcode = 0;
+    while (n > 0) {
+        size_t len = MIN(n, COPY_FD_CHUNK);
+        ssize_t r;
+        if (use_splice) {
+            r = splice(src_fd, NULL, dst_fd, NULL, len, SPLICE_F_MOVE);
+        } else {
+            r = sendfile(dst_fd, src_fd, NULL, len);
+        }
+        if (r == -1) {
+            if (errno == EINTR) {
+                mp_handle_pending();
+                continue;
+            }
+            if (done == 0 && (errno == EINVAL || errno == ENOSYS)) {
+                if (!use_splice) {
+                    use_splice = true;
+                    continue;
+                }
+                *errcode = MP_EOPNOTSUPP;
+            } else {
+                *errcode = errno;
+            }
+            break;
+        }
+        if (r == 0) {
+            break;
+        }
+        done += r;
+        if (n != MP_STREAM_COPY_ALL) {
+            n -= r;
+        }
+        mp_handle_pending();
+    }
+    return done;
+}
+#endif
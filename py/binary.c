@@ -200,7 +200,11 @@ mp_obj_t mp_binary_get_val(char struct_type, char val_type, byte **ptr) {
     }
     *ptr = p + size;
 
-    long long val = mp_binary_get_int(size, is_signed(val_type), (struct_type == '>'), p);
+    return mp_binary_get_val_sized(val_type, size, struct_type == '>', p);
+}
+
+mp_obj_t mp_binary_get_val_sized(char val_type, size_t size, bool big_endian, const byte *p) {
+    long long val = mp_binary_get_int(size, is_signed(val_type), big_endian, p);
 
     if (val_type == 'O') {
         return (mp_obj_t)(mp_uint_t)val;
@@ -265,6 +269,10 @@ void mp_binary_set_val(char struct_type, char val_type, mp_obj_t val_in, byte **
     }
     *ptr = p + size;
 
+    mp_binary_set_val_sized(val_type, size, struct_type == '>', val_in, p);
+}
+
+void mp_binary_set_val_sized(char val_type, size_t size, bool big_endian, mp_obj_t val_in, byte *p) {
     mp_uint_t val;
     switch (val_type) {
         case 'O':
@@ -283,10 +291,9 @@ void mp_binary_set_val(char struct_type, char val_type, mp_obj_t val_in, byte **
             if (BYTES_PER_WORD == 8) {
                 val = fp_dp.i64;
             } else {
-                int be = struct_type == '>';
-                mp_binary_set_int(sizeof(uint32_t), be, p, fp_dp.i32[MP_ENDIANNESS_BIG ^ be]);
+                mp_binary_set_int(sizeof(uint32_t), big_endian, p, fp_dp.i32[MP_ENDIANNESS_BIG ^ big_endian]);
                 p += sizeof(uint32_t);
-                val = fp_dp.i32[MP_ENDIANNESS_LITTLE ^ be];
+                val = fp_dp.i32[MP_ENDIANNESS_LITTLE ^ big_endian];
             }
             break;
         }
@@ -294,7 +301,7 @@ void mp_binary_set_val(char struct_type, char val_type, mp_obj_t val_in, byte **
         default:
             #if MICROPY_LONGINT_IMPL != MICROPY_LONGINT_IMPL_NONE
             if (MP_OBJ_IS_TYPE(val_in, &mp_type_int)) {
-                mp_obj_int_to_bytes_impl(val_in, struct_type == '>', size, p);
+                mp_obj_int_to_bytes_impl(val_in, big_endian, size, p);
                 return;
             } else
             #endif
@@ -304,14 +311,14 @@ void mp_binary_set_val(char struct_type, char val_type, mp_obj_t val_in, byte **
                 if (BYTES_PER_WORD < 8 && size > sizeof(val)) {
                     int c = (is_signed(val_type) && (mp_int_t)val < 0) ? 0xff : 0x00;
                     memset(p, c, size);
-                    if (struct_type == '>') {
+                    if (big_endian) {
                         p += size - sizeof(val);
                     }
                 }
             }
     }
 
-    mp_binary_set_int(MIN((size_t)size, sizeof(val)), struct_type == '>', p, val);
+    mp_binary_set_int(MIN((size_t)size, sizeof(val)), big_endian, p, val);
 }
 
 void mp_binary_set_val_array(char typecode, void *p, mp_uint_t index, mp_obj_t val_in) {
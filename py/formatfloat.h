@@ -30,6 +30,39 @@
 
 #if MICROPY_PY_BUILTINS_FLOAT
 int mp_format_float(mp_float_t f, char *buf, size_t bufSize, char fmt, int prec, char sign);
+
+#if MICROPY_OPT_FLOAT_ROUNDTRIP
+// Normalised powers of 5, shared by the shortest float formatter and the exact
+// decimal parser.  Entry q - MP_FLOAT_POW5_MIN holds the significand of 5**q,
+// and so also of 10**q, truncated to 128 bits for double and 64 bits for float.
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+#define MP_FLOAT_POW5_MIN (-342)
+#define MP_FLOAT_POW5_MAX (325)
+extern const uint64_t mp_float_pow5[][2];
+#else
+#define MP_FLOAT_POW5_MIN (-64)
+#define MP_FLOAT_POW5_MAX (47)
+extern const uint64_t mp_float_pow5[];
+#endif
+
+// Returns the low 64 bits of a * b and stores the high 64 bits in *hi.
+static inline uint64_t mp_float_umul128(uint64_t a, uint64_t b, uint64_t *hi) {
+    #if defined(__SIZEOF_INT128__)
+    unsigned __int128 p = (unsigned __int128)a * b;
+    *hi = (uint64_t)(p >> 64);
+    return (uint64_t)p;
+    #else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t p0 = a_lo * b_lo;
+    uint64_t p1 = a_lo * b_hi;
+    uint64_t p2 = a_hi * b_lo;
+    uint64_t mid = (p0 >> 32) + (uint32_t)p1 + (uint32_t)p2;
+    *hi = a_hi * b_hi + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+    return (mid << 32) | (uint32_t)p0;
+    #endif
+}
+#endif
 #endif
 
 #endif // MICROPY_INCLUDED_PY_FORMATFLOAT_H
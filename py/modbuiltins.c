@@ -209,6 +209,19 @@ STATIC mp_obj_t mp_builtin_dir(size_t n_args, const mp_obj_t *args) {
             }
         }
     }
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+    mp_obj_t *values;
+    size_t n;
+    if (members != NULL && mp_obj_instance_get_values(MP_OBJ_TO_PTR(args[0]), &values, &n)) {
+        const qstr *keys = mp_obj_instance_keys((mp_obj_instance_t*)MP_OBJ_TO_PTR(args[0]));
+        for (size_t i = 0; i < n; i++) {
+            if (values[i] != MP_OBJ_NULL) {
+                mp_obj_list_append(dir, MP_OBJ_NEW_QSTR(keys[i]));
+            }
+        }
+        members = NULL;
+    }
+    #endif
     if (members != NULL) {
         for (size_t i = 0; i < members->alloc; i++) {
             if (MP_MAP_SLOT_IS_FILLED(members, i)) {
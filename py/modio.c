@@ -131,6 +131,196 @@ STATIC const mp_obj_type_t bufwriter_type = {
 };
 #endif // MICROPY_PY_IO_BUFFEREDWRITER
 
+#if MICROPY_PY_IO_BUFFEREDREADER
+typedef struct _mp_obj_bufreader_t {
+    mp_obj_base_t base;
+    mp_obj_t stream;
+    size_t alloc;
+    // buffered data not yet consumed is buf[pos:len]
+    size_t pos;
+    size_t len;
+    byte buf[0];
+} mp_obj_bufreader_t;
+
+STATIC mp_obj_t bufreader_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 2, false);
+    mp_get_stream_raise(args[0], MP_STREAM_OP_READ);
+    mp_int_t alloc = MICROPY_PY_IO_BUFFEREDREADER_SIZE;
+    if (n_args > 1) {
+        alloc = mp_obj_get_int(args[1]);
+        if (alloc <= 0) {
+            mp_raise_ValueError(NULL);
+        }
+    }
+    mp_obj_bufreader_t *o = m_new_obj_var(mp_obj_bufreader_t, byte, alloc);
+    o->base.type = type;
+    o->stream = args[0];
+    o->alloc = alloc;
+    o->pos = 0;
+    o->len = 0;
+    return o;
+}
+
+// Refills the buffer with a single read of the underlying stream if it is
+// empty; returns the number of bytes available, 0 at EOF
+STATIC mp_uint_t bufreader_fill(mp_obj_bufreader_t *self, int *errcode) {
+    if (self->pos == self->len) {
+        self->pos = 0;
+        self->len = 0;
+        mp_uint_t out_sz = mp_stream_rw(self->stream, self->buf, self->alloc, errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+        if (*errcode != 0) {
+            return MP_STREAM_ERROR;
+        }
+        self->len = out_sz;
+    }
+    return self->len - self->pos;
+}
+
+STATIC mp_uint_t bufreader_read(mp_obj_t self_in, void *buf, mp_uint_t size, int *errcode) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+
+    if (self->pos == self->len && size >= self->alloc) {
+        // Nothing is buffered and the request is at least as big as the
+        // buffer, so read straight into the caller's buffer
+        mp_uint_t out_sz = mp_stream_rw(self->stream, buf, size, errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+        if (*errcode != 0) {
+            return MP_STREAM_ERROR;
+        }
+        return out_sz;
+    }
+
+    mp_uint_t avail = bufreader_fill(self, errcode);
+    if (avail == MP_STREAM_ERROR) {
+        return MP_STREAM_ERROR;
+    }
+    if (size > avail) {
+        size = avail;
+    }
+    memcpy(buf, self->buf + self->pos, size);
+    self->pos += size;
+    return size;
+}
+
+STATIC mp_obj_t bufreader_readline(size_t n_args, const mp_obj_t *args) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(args[0]);
+
+    mp_int_t max_size = -1;
+    if (n_args > 1) {
+        max_size = mp_obj_get_int(args[1]);
+    }
+
+    vstr_t vstr;
+    vstr_init(&vstr, 16);
+    while (max_size < 0 || vstr.len < (size_t)max_size) {
+        int error;
+        mp_uint_t avail = bufreader_fill(self, &error);
+        if (avail == MP_STREAM_ERROR) {
+            if (mp_is_nonblocking_error(error)) {
+                // Like the unbuffered readline(), return None if nothing was
+                // read, otherwise the part of the line read so far
+                if (vstr.len == 0) {
+                    vstr_clear(&vstr);
+                    return mp_const_none;
+                }
+                break;
+            }
+            mp_raise_OSError(error);
+        }
+        if (avail == 0) {
+            break;
+        }
+        if (max_size >= 0 && avail > max_size - vstr.len) {
+            avail = max_size - vstr.len;
+        }
+        const byte *start = self->buf + self->pos;
+        const byte *nl = memchr(start, '\n', avail);
+        if (nl != NULL) {
+            avail = nl - start + 1;
+        }
+        vstr_add_strn(&vstr, (const char*)start, avail);
+        self->pos += avail;
+        if (nl != NULL) {
+            break;
+        }
+    }
+
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bufreader_readline_obj, 1, 2, bufreader_readline);
+
+STATIC mp_obj_t bufreader_readlines(mp_obj_t self_in) {
+    mp_obj_t lines = mp_obj_new_list(0, NULL);
+    for (;;) {
+        mp_obj_t line = bufreader_readline(1, &self_in);
+        if (!mp_obj_is_true(line)) {
+            break;
+        }
+        mp_obj_list_append(lines, line);
+    }
+    return lines;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(bufreader_readlines_obj, bufreader_readlines);
+
+STATIC mp_obj_t bufreader_iternext(mp_obj_t self_in) {
+    mp_obj_t line = bufreader_readline(1, &self_in);
+    if (mp_obj_is_true(line)) {
+        return line;
+    }
+    return MP_OBJ_STOP_ITERATION;
+}
+
+// Returns the buffered data without consuming it, reading from the
+// underlying stream (once) only if nothing is buffered.  As in CPython,
+// the size argument is accepted but doesn't limit the result.
+STATIC mp_obj_t bufreader_peek(size_t n_args, const mp_obj_t *args) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(args[0]);
+    (void)n_args;
+    int error;
+    mp_uint_t avail = bufreader_fill(self, &error);
+    if (avail == MP_STREAM_ERROR) {
+        if (mp_is_nonblocking_error(error)) {
+            return mp_const_none;
+        }
+        mp_raise_OSError(error);
+    }
+    return mp_obj_new_bytes(self->buf + self->pos, avail);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(bufreader_peek_obj, 1, 2, bufreader_peek);
+
+STATIC mp_obj_t bufreader_close(mp_obj_t self_in) {
+    mp_obj_bufreader_t *self = MP_OBJ_TO_PTR(self_in);
+    self->pos = 0;
+    self->len = 0;
+    return mp_stream_close(self->stream);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_1(bufreader_close_obj, bufreader_close);
+
+STATIC const mp_rom_map_elem_t bufreader_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_read), MP_ROM_PTR(&mp_stream_read_obj) },
+    { MP_ROM_QSTR(MP_QSTR_read1), MP_ROM_PTR(&mp_stream_read1_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readinto), MP_ROM_PTR(&mp_stream_readinto_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readline), MP_ROM_PTR(&bufreader_readline_obj) },
+    { MP_ROM_QSTR(MP_QSTR_readlines), MP_ROM_PTR(&bufreader_readlines_obj) },
+    { MP_ROM_QSTR(MP_QSTR_peek), MP_ROM_PTR(&bufreader_peek_obj) },
+    { MP_ROM_QSTR(MP_QSTR_close), MP_ROM_PTR(&bufreader_close_obj) },
+};
+STATIC MP_DEFINE_CONST_DICT(bufreader_locals_dict, bufreader_locals_dict_table);
+
+STATIC const mp_stream_p_t bufreader_stream_p = {
+    .read = bufreader_read,
+};
+
+STATIC const mp_obj_type_t bufreader_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_BufferedReader,
+    .make_new = bufreader_make_new,
+    .getiter = mp_identity_getiter,
+    .iternext = bufreader_iternext,
+    .protocol = &bufreader_stream_p,
+    .locals_dict = (mp_obj_dict_t*)&bufreader_locals_dict,
+};
+#endif // MICROPY_PY_IO_BUFFEREDREADER
+
 #if MICROPY_MODULE_FROZEN_STR
 STATIC mp_obj_t resource_stream(mp_obj_t package_in, mp_obj_t path_in) {
     VSTR_FIXED(path_buf, MICROPY_ALLOC_PATH_MAX);
@@ -203,6 +393,12 @@ STATIC const mp_rom_map_elem_t mp_module_io_globals_table[] = {
     #if MICROPY_PY_IO_BUFFEREDWRITER
     { MP_ROM_QSTR(MP_QSTR_BufferedWriter), MP_ROM_PTR(&bufwriter_type) },
     #endif
+    #if MICROPY_PY_IO_BUFFEREDREADER
+    { MP_ROM_QSTR(MP_QSTR_BufferedReader), MP_ROM_PTR(&bufreader_type) },
+    #endif
+    #if MICROPY_PY_IO_COPY
+    { MP_ROM_QSTR(MP_QSTR_copy), MP_ROM_PTR(&mp_stream_copy_obj) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_io_globals, mp_module_io_globals_table);
@@ -248,6 +248,247 @@ STATIC mp_obj_t struct_pack_into(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_pack_into);
 
+#if MICROPY_PY_STRUCT_STRUCT
+
+// A Struct object holds its format parsed into an array of fields, each of
+// them a run of values of one typecode (or the data of one 's' value) at an
+// offset already resolved, so packing and unpacking needn't parse the format.
+// Unlike the module-level functions, native alignment with '@' is relative to
+// the start of the structure (as for calcsize), not to the absolute address.
+
+typedef struct _struct_field_t {
+    size_t offset;
+    size_t count; // number of values, or number of bytes for 's'
+    char type;
+    byte size; // size of each value
+} struct_field_t;
+
+typedef struct _mp_obj_struct_t {
+    mp_obj_base_t base;
+    mp_obj_t format;
+    bool big_endian;
+    size_t size;
+    size_t num_items;
+    size_t num_fields;
+    struct_field_t fields[];
+} mp_obj_struct_t;
+
+STATIC mp_obj_t struct_make_new(const mp_obj_type_t *type, size_t n_args, size_t n_kw, const mp_obj_t *args) {
+    mp_arg_check_num(n_args, n_kw, 1, 1, false);
+    const char *fmt = mp_obj_str_get_str(args[0]);
+
+    // count the fields
+    const char *f = fmt;
+    char fmt_type = get_fmt_type(&f);
+    size_t num_fields = 0;
+    for (; *f; f++) {
+        if (unichar_isdigit(*f)) {
+            get_fmt_num(&f);
+        }
+        num_fields++;
+        if (*f == '\0') {
+            // count without typecode, it's caught below
+            break;
+        }
+    }
+
+    mp_obj_struct_t *o = m_new_obj_var(mp_obj_struct_t, struct_field_t, num_fields);
+    o->base.type = type;
+    o->format = args[0];
+    o->big_endian = fmt_type == '>' || (fmt_type == '@' && MP_ENDIANNESS_BIG);
+    o->num_items = 0;
+    o->num_fields = num_fields;
+
+    size_t size = 0;
+    f = fmt;
+    get_fmt_type(&f);
+    for (struct_field_t *field = o->fields; field < o->fields + num_fields; field++, f++) {
+        mp_uint_t cnt = 1;
+        if (unichar_isdigit(*f)) {
+            cnt = get_fmt_num(&f);
+        }
+        if (*f == 's') {
+            field->size = 1;
+            o->num_items += 1;
+        } else {
+            mp_uint_t align;
+            field->size = mp_binary_get_size(fmt_type, *f, &align);
+            size = (size + align - 1) & ~(align - 1);
+            o->num_items += cnt;
+        }
+        field->type = *f;
+        field->count = cnt;
+        field->offset = size;
+        size += cnt * field->size;
+    }
+    o->size = size;
+
+    return MP_OBJ_FROM_PTR(o);
+}
+
+// Returns a pointer to a region of self->size bytes in the given buffer, starting
+// at offset (where a negative offset is relative to the end of the buffer).
+STATIC byte *struct_get_buffer(mp_obj_struct_t *self, mp_obj_t buf_in, mp_int_t offset, mp_uint_t flags) {
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, flags);
+    if (offset < 0) {
+        offset += bufinfo.len;
+    }
+    if (offset < 0 || (size_t)offset + self->size > bufinfo.len) {
+        mp_raise_ValueError("buffer too small");
+    }
+    return (byte*)bufinfo.buf + offset;
+}
+
+STATIC mp_obj_t struct_unpack_internal(mp_obj_struct_t *self, const byte *p) {
+    mp_obj_tuple_t *res = MP_OBJ_TO_PTR(mp_obj_new_tuple(self->num_items, NULL));
+    mp_obj_t *item = res->items;
+    for (const struct_field_t *field = self->fields; field < self->fields + self->num_fields; field++) {
+        const byte *q = p + field->offset;
+        if (field->type == 's') {
+            *item++ = mp_obj_new_bytes(q, field->count);
+        } else {
+            for (size_t n = field->count; n > 0; n--, q += field->size) {
+                *item++ = mp_binary_get_val_sized(field->type, field->size, self->big_endian, q);
+            }
+        }
+    }
+    return MP_OBJ_FROM_PTR(res);
+}
+
+// This function assumes there is room for self->size bytes at p
+STATIC void struct_pack_internal(mp_obj_struct_t *self, byte *p, size_t n_args, const mp_obj_t *args) {
+    if (n_args != self->num_items) {
+        mp_raise_ValueError("wrong number of values");
+    }
+    for (const struct_field_t *field = self->fields; field < self->fields + self->num_fields; field++) {
+        byte *q = p + field->offset;
+        if (field->type == 's') {
+            mp_buffer_info_t bufinfo;
+            mp_get_buffer_raise(*args++, &bufinfo, MP_BUFFER_READ);
+            size_t to_copy = MIN(field->count, bufinfo.len);
+            memcpy(q, bufinfo.buf, to_copy);
+            memset(q + to_copy, 0, field->count - to_copy);
+        } else {
+            for (size_t n = field->count; n > 0; n--, q += field->size) {
+                mp_binary_set_val_sized(field->type, field->size, self->big_endian, *args++, q);
+            }
+        }
+    }
+}
+
+STATIC mp_obj_t struct_obj_pack(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    vstr_t vstr;
+    vstr_init_len(&vstr, self->size);
+    memset(vstr.buf, 0, self->size);
+    struct_pack_internal(self, (byte*)vstr.buf, n_args - 1, &args[1]);
+    return mp_obj_new_str_from_vstr(&mp_type_bytes, &vstr);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_obj, 1, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack);
+
+STATIC mp_obj_t struct_obj_pack_into(size_t n_args, const mp_obj_t *args) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    byte *p = struct_get_buffer(self, args[1], mp_obj_get_int(args[2]), MP_BUFFER_WRITE);
+    struct_pack_internal(self, p, n_args - 3, &args[3]);
+    return mp_const_none;
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_pack_into_obj, 3, MP_OBJ_FUN_ARGS_MAX, struct_obj_pack_into);
+
+STATIC mp_obj_t struct_obj_unpack_from(size_t n_args, const mp_obj_t *args) {
+    // as for the module-level functions, unpack only requires the buffer to be big enough
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(args[0]);
+    mp_int_t offset = 0;
+    if (n_args > 2) {
+        offset = mp_obj_get_int(args[2]);
+    }
+    return struct_unpack_internal(self, struct_get_buffer(self, args[1], offset, MP_BUFFER_READ));
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(struct_obj_unpack_from_obj, 2, 3, struct_obj_unpack_from);
+
+typedef struct _mp_obj_struct_iter_t {
+    mp_obj_base_t base;
+    mp_obj_struct_t *st;
+    mp_obj_t buf;
+    size_t offset;
+} mp_obj_struct_iter_t;
+
+STATIC mp_obj_t struct_iter_iternext(mp_obj_t self_in) {
+    mp_obj_struct_iter_t *self = MP_OBJ_TO_PTR(self_in);
+    // get the buffer each time in case the underlying object was resized
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(self->buf, &bufinfo, MP_BUFFER_READ);
+    if (self->offset + self->st->size > bufinfo.len) {
+        return MP_OBJ_STOP_ITERATION;
+    }
+    mp_obj_t res = struct_unpack_internal(self->st, (byte*)bufinfo.buf + self->offset);
+    self->offset += self->st->size;
+    return res;
+}
+
+STATIC const mp_obj_type_t struct_iter_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_iterator,
+    .getiter = mp_identity_getiter,
+    .iternext = struct_iter_iternext,
+};
+
+STATIC mp_obj_t struct_obj_iter_unpack(mp_obj_t self_in, mp_obj_t buf_in) {
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    mp_buffer_info_t bufinfo;
+    mp_get_buffer_raise(buf_in, &bufinfo, MP_BUFFER_READ);
+    if (self->size == 0 || bufinfo.len % self->size != 0) {
+        mp_raise_ValueError("buffer size must be a multiple of struct size");
+    }
+    mp_obj_struct_iter_t *o = m_new_obj(mp_obj_struct_iter_t);
+    o->base.type = &struct_iter_type;
+    o->st = self;
+    o->buf = buf_in;
+    o->offset = 0;
+    return MP_OBJ_FROM_PTR(o);
+}
+STATIC MP_DEFINE_CONST_FUN_OBJ_2(struct_obj_iter_unpack_obj, struct_obj_iter_unpack);
+
+STATIC const mp_rom_map_elem_t struct_locals_dict_table[] = {
+    { MP_ROM_QSTR(MP_QSTR_pack), MP_ROM_PTR(&struct_obj_pack_obj) },
+    { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_obj_pack_into_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_obj_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_obj_unpack_from_obj) },
+    { MP_ROM_QSTR(MP_QSTR_iter_unpack), MP_ROM_PTR(&struct_obj_iter_unpack_obj) },
+};
+
+STATIC MP_DEFINE_CONST_DICT(struct_locals_dict, struct_locals_dict_table);
+
+STATIC void struct_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest) {
+    if (dest[0] != MP_OBJ_NULL) {
+        // not load attribute
+        return;
+    }
+    mp_obj_struct_t *self = MP_OBJ_TO_PTR(self_in);
+    if (attr == MP_QSTR_size) {
+        dest[0] = MP_OBJ_NEW_SMALL_INT(self->size);
+    } else if (attr == MP_QSTR_format) {
+        dest[0] = self->format;
+    } else {
+        // a type with an attr handler doesn't get its locals looked up, so do it here
+        mp_map_elem_t *elem = mp_map_lookup((mp_map_t*)&struct_locals_dict.map, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+        if (elem != NULL) {
+            dest[0] = elem->value;
+            dest[1] = self_in;
+        }
+    }
+}
+
+STATIC const mp_obj_type_t struct_type = {
+    { &mp_type_type },
+    .name = MP_QSTR_Struct,
+    .make_new = struct_make_new,
+    .attr = struct_attr,
+    .locals_dict = (mp_obj_dict_t*)&struct_locals_dict,
+};
+
+#endif // MICROPY_PY_STRUCT_STRUCT
+
 STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR___name__), MP_ROM_QSTR(MP_QSTR_ustruct) },
     { MP_ROM_QSTR(MP_QSTR_calcsize), MP_ROM_PTR(&struct_calcsize_obj) },
@@ -255,6 +496,9 @@ STATIC const mp_rom_map_elem_t mp_module_struct_globals_table[] = {
     { MP_ROM_QSTR(MP_QSTR_pack_into), MP_ROM_PTR(&struct_pack_into_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack), MP_ROM_PTR(&struct_unpack_from_obj) },
     { MP_ROM_QSTR(MP_QSTR_unpack_from), MP_ROM_PTR(&struct_unpack_from_obj) },
+    #if MICROPY_PY_STRUCT_STRUCT
+    { MP_ROM_QSTR(MP_QSTR_Struct), MP_ROM_PTR(&struct_type) },
+    #endif
 };
 
 STATIC MP_DEFINE_CONST_DICT(mp_module_struct_globals, mp_module_struct_globals_table);
@@ -396,12 +396,51 @@
 #define MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE (0)
 #endif
 
+// Whether instances of a user class share a table of attribute names, with each
+// instance storing just an array of values while it assigns its attributes in
+// the same order as other instances of the class.  Reduces RAM per instance and
+// gives the bytecode cache an index to use for attribute lookups.
+#ifndef MICROPY_OPT_INSTANCE_SHARED_KEYS
+#define MICROPY_OPT_INSTANCE_SHARED_KEYS (0)
+#endif
+
 // Whether to use fast versions of bitwise operations (and, or, xor) when the
 // arguments are both positive.  Increases Thumb2 code size by about 250 bytes.
 #ifndef MICROPY_OPT_MPZ_BITWISE
 #define MICROPY_OPT_MPZ_BITWISE (0)
 #endif
 
+// Whether to multiply large mpz integers with Karatsuba's algorithm, and square
+// them with a dedicated routine, rather than always using schoolbook
+// multiplication.  Speeds up multiplication from about 32 digits, and squaring
+// of any size.
+#ifndef MICROPY_OPT_MPZ_KARATSUBA
+#define MICROPY_OPT_MPZ_KARATSUBA (0)
+#endif
+
+// Whether 3-arg pow() with an odd modulus uses Montgomery multiplication and a
+// fixed window exponent, which needs no division in the main loop.  Uses RAM
+// for a table of up to 32 powers of the base.
+#ifndef MICROPY_OPT_MPZ_MONTGOMERY
+#define MICROPY_OPT_MPZ_MONTGOMERY (0)
+#endif
+
+// Whether conversion of mpz integers to and from strings splits large numbers
+// at powers of the base, recursively, rather than converting one digit at a
+// time.  Converting numbers with thousands of digits is then much faster, more
+// so with MICROPY_OPT_MPZ_KARATSUBA.
+#ifndef MICROPY_OPT_MPZ_FAST_STR
+#define MICROPY_OPT_MPZ_FAST_STR (0)
+#endif
+
+// Whether repr() of a float gives the shortest digits that read back as the
+// same value (Ryu), and parsing of decimal numbers is correctly rounded
+// (Eisel-Lemire with an exact fallback).  Both use a table of powers of 5,
+// about 10k for double and 1k for float.
+#ifndef MICROPY_OPT_FLOAT_ROUNDTRIP
+#define MICROPY_OPT_FLOAT_ROUNDTRIP (0)
+#endif
+
 /*****************************************************************************/
 /* Python internal features                                                  */
 
@@ -677,6 +716,12 @@ typedef double mp_float_t;
 #define MICROPY_PY_DESCRIPTORS (0)
 #endif
 
+// Whether to support __slots__ in class definitions, giving instances a fixed
+// set of attributes stored inline with no members map
+#ifndef MICROPY_PY_SLOTS
+#define MICROPY_PY_SLOTS (0)
+#endif
+
 // Whether to support class __delattr__ and __setattr__ methods
 // This costs some code size and makes all del attrs and store attrs slow
 #ifndef MICROPY_PY_DELATTR_SETATTR
@@ -946,11 +991,39 @@ typedef double mp_float_t;
 #define MICROPY_PY_IO_BUFFEREDWRITER (0)
 #endif
 
+// Whether to provide "io.BufferedReader" class, and its default buffer size
+#ifndef MICROPY_PY_IO_BUFFEREDREADER
+#define MICROPY_PY_IO_BUFFEREDREADER (0)
+#endif
+#ifndef MICROPY_PY_IO_BUFFEREDREADER_SIZE
+#define MICROPY_PY_IO_BUFFEREDREADER_SIZE (512)
+#endif
+
+// Whether to provide "uio.copy()" function to copy between two streams in C.
+// A port may define MICROPY_PY_IO_COPY_FD(src_fd, dst_fd, n, errcode) to let
+// the OS copy between streams backed by file descriptors (see
+// MP_STREAM_GET_FILENO); it returns the number of bytes copied, and sets
+// *errcode to MP_EOPNOTSUPP if the pair can't be handled that way.
+#ifndef MICROPY_PY_IO_COPY
+#define MICROPY_PY_IO_COPY (0)
+#endif
+
+// Default size of the buffer used by "uio.copy()"
+#ifndef MICROPY_PY_IO_COPY_BUFSIZE
+#define MICROPY_PY_IO_COPY_BUFSIZE (512)
+#endif
+
 // Whether to provide "struct" module
 #ifndef MICROPY_PY_STRUCT
 #define MICROPY_PY_STRUCT (1)
 #endif
 
+// Whether to provide the "ustruct.Struct" class, a format string parsed once
+// for repeated packing and unpacking
+#ifndef MICROPY_PY_STRUCT_STRUCT
+#define MICROPY_PY_STRUCT_STRUCT (0)
+#endif
+
 // Whether to provide "sys" module
 #ifndef MICROPY_PY_SYS
 #define MICROPY_PY_SYS (1)
@@ -1008,6 +1081,18 @@ typedef double mp_float_t;
 #define MICROPY_PY_USELECT (0)
 #endif
 
+// Whether to build the baremetal "uselect" as "_uselect_generic", for testing
+// it alongside a port's own uselect module
+#ifndef MICROPY_PY_USELECT_GENERIC
+#define MICROPY_PY_USELECT_GENERIC (0)
+#endif
+
+// Whether uselect.poll only polls streams that notified it of a possible change
+// of readiness, and waits with MICROPY_PY_USELECT_WAIT when all streams do that
+#ifndef MICROPY_PY_USELECT_NOTIFY
+#define MICROPY_PY_USELECT_NOTIFY (0)
+#endif
+
 // Whether to provide "utime" module functions implementation
 // in terms of mp_hal_* functions.
 #ifndef MICROPY_PY_UTIME_MP_HAL
@@ -1047,18 +1132,85 @@ typedef double mp_float_t;
 #define MICROPY_PY_UCTYPES (0)
 #endif
 
+// Whether to provide "uctypes.compile", which pre-decodes a descriptor for
+// faster field access
+#ifndef MICROPY_PY_UCTYPES_COMPILE
+#define MICROPY_PY_UCTYPES_COMPILE (0)
+#endif
+
 #ifndef MICROPY_PY_UZLIB
 #define MICROPY_PY_UZLIB (0)
 #endif
 
+// Huffman codes of up to this many bits are decompressed by uzlib with one
+// table lookup, which takes 4 << MICROPY_PY_UZLIB_FAST_BITS bytes of heap per
+// decompressor; 0 decodes codes bit by bit
+#ifndef MICROPY_PY_UZLIB_FAST_BITS
+#define MICROPY_PY_UZLIB_FAST_BITS (0)
+#endif
+
+// Number of bytes that uzlib and ubinascii.crc32 compute CRC32 over at a time,
+// with a 1KB constant table per byte: 1, 4 or 8; 0 uses a 64 byte table and
+// computes 4 bits at a time
+#ifndef MICROPY_PY_UZLIB_CRC32_SLICES
+#define MICROPY_PY_UZLIB_CRC32_SLICES (0)
+#endif
+
+// Whether to provide uzlib.compress and uzlib.CompressIO
+#ifndef MICROPY_PY_UZLIB_COMPRESS
+#define MICROPY_PY_UZLIB_COMPRESS (0)
+#endif
+
+// Size of the buffer of uzlib.CompressIO for data to write to its stream
+#ifndef MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE
+#define MICROPY_PY_UZLIB_COMPRESS_BUF_SIZE (256)
+#endif
+
 #ifndef MICROPY_PY_UJSON
 #define MICROPY_PY_UJSON (0)
 #endif
 
+// Size of the buffer that ujson.load and ujson.iterload read streams into
+#ifndef MICROPY_PY_UJSON_READ_BUF_SIZE
+#define MICROPY_PY_UJSON_READ_BUF_SIZE (128)
+#endif
+
+// Size of the buffer that ujson.dump collects output in before writing it
+#ifndef MICROPY_PY_UJSON_WRITE_BUF_SIZE
+#define MICROPY_PY_UJSON_WRITE_BUF_SIZE (128)
+#endif
+
+// Whether to provide "ujson.iterload", which parses a stream incrementally
+// and yields the values at a given path without building the whole document
+#ifndef MICROPY_PY_UJSON_ITERLOAD
+#define MICROPY_PY_UJSON_ITERLOAD (0)
+#endif
+
 #ifndef MICROPY_PY_URE
 #define MICROPY_PY_URE (0)
 #endif
 
+// Whether ure.compile accepts the PIKEVM and DFA flags, which select a
+// matcher that runs in time linear in the subject instead of backtracking
+#ifndef MICROPY_PY_URE_PIKEVM
+#define MICROPY_PY_URE_PIKEVM (0)
+#endif
+
+// Whether to provide the start, end and span methods of ure match objects
+#ifndef MICROPY_PY_URE_MATCH_SPAN_START_END
+#define MICROPY_PY_URE_MATCH_SPAN_START_END (0)
+#endif
+
+// Whether to provide "ure.sub" and the sub method of compiled patterns
+#ifndef MICROPY_PY_URE_SUB
+#define MICROPY_PY_URE_SUB (0)
+#endif
+
+// Whether to provide "ure.finditer" and the finditer method of compiled patterns
+#ifndef MICROPY_PY_URE_FINDITER
+#define MICROPY_PY_URE_FINDITER (0)
+#endif
+
 #ifndef MICROPY_PY_UHEAPQ
 #define MICROPY_PY_UHEAPQ (0)
 #endif
@@ -1068,6 +1220,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_UTIMEQ (0)
 #endif
 
+// Core of an event loop for uasyncio; needs utimeq and a uselect module
+#ifndef MICROPY_PY_UASYNCIO
+#define MICROPY_PY_UASYNCIO (0)
+#endif
+
 #ifndef MICROPY_PY_UHASHLIB
 #define MICROPY_PY_UHASHLIB (0)
 #endif
@@ -1076,6 +1233,11 @@ typedef double mp_float_t;
 #define MICROPY_PY_UBINASCII (0)
 #endif
 
+// Whether to provide the ubinascii *_into functions, which write to a buffer
+#ifndef MICROPY_PY_UBINASCII_INTO
+#define MICROPY_PY_UBINASCII_INTO (0)
+#endif
+
 // Depends on MICROPY_PY_UZLIB
 #ifndef MICROPY_PY_UBINASCII_CRC32
 #define MICROPY_PY_UBINASCII_CRC32 (0)
@@ -449,6 +449,256 @@ STATIC size_t mpn_mul(mpz_dig_t *idig, mpz_dig_t *jdig, size_t jlen, mpz_dig_t *
     return ilen;
 }
 
+#if MICROPY_OPT_MPZ_KARATSUBA || MICROPY_OPT_MPZ_MONTGOMERY
+
+// The functions below work on fixed-length digit arrays (which need not be
+// normalised), and are used for Karatsuba multiplication and for Montgomery
+// reduction.  MPZ_KARATSUBA_THRESHOLD is the number of digits below which
+// schoolbook multiplication is used; it must be at least 4.
+#if !MICROPY_OPT_MPZ_KARATSUBA
+#undef MPZ_KARATSUBA_THRESHOLD
+#define MPZ_KARATSUBA_THRESHOLD ((size_t)-1)
+#elif !defined(MPZ_KARATSUBA_THRESHOLD)
+#define MPZ_KARATSUBA_THRESHOLD (32)
+#endif
+
+/* computes i += j, where i has ilen digits and j has jlen <= ilen digits
+   returns the carry out of the top digit of i
+*/
+STATIC mpz_dig_t mpn_add_n_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_t carry = 0;
+    size_t n = 0;
+
+    for (; n < jlen; ++n) {
+        carry += (mpz_dbl_dig_t)idig[n] + (mpz_dbl_dig_t)jdig[n];
+        idig[n] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    for (; carry != 0 && n < ilen; ++n) {
+        carry += idig[n];
+        idig[n] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    return carry;
+}
+
+/* computes i -= j, where i has ilen digits and j has jlen <= ilen digits
+   assumes i >= j
+*/
+STATIC void mpn_sub_n_inpl(mpz_dig_t *idig, size_t ilen, const mpz_dig_t *jdig, size_t jlen) {
+    mpz_dbl_dig_signed_t borrow = 0;
+    size_t n = 0;
+
+    for (; n < jlen; ++n) {
+        borrow += (mpz_dbl_dig_t)idig[n] - (mpz_dbl_dig_t)jdig[n];
+        idig[n] = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+
+    for (; borrow != 0 && n < ilen; ++n) {
+        borrow += idig[n];
+        idig[n] = borrow & DIG_MASK;
+        borrow >>= DIG_SIZE;
+    }
+}
+
+/* computes i = j * k, writing all jlen + klen digits of i
+   i must not overlap j or k
+*/
+STATIC void mpn_mul_basecase(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen) {
+    memset(idig, 0, (jlen + klen) * sizeof(mpz_dig_t));
+
+    for (size_t k = 0; k < klen; ++k) {
+        mpz_dig_t *id = idig + k;
+        mpz_dbl_dig_t kd = kdig[k];
+        mpz_dbl_dig_t carry = 0;
+
+        for (size_t j = 0; j < jlen; ++j, ++id) {
+            carry += (mpz_dbl_dig_t)*id + (mpz_dbl_dig_t)jdig[j] * kd; // will never overflow so long as DIG_SIZE <= 8*sizeof(mpz_dbl_dig_t)/2
+            *id = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+
+        *id = carry;
+    }
+}
+
+/* computes i = j * j, writing all 2 * jlen digits of i
+   i must not overlap j
+*/
+STATIC void mpn_sqr_basecase(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen) {
+    memset(idig, 0, 2 * jlen * sizeof(mpz_dig_t));
+
+    // sum of the products j[a] * j[b] with a < b, each of which appears twice in the square
+    for (size_t a = 0; a + 1 < jlen; ++a) {
+        mpz_dig_t *id = idig + 2 * a + 1;
+        mpz_dbl_dig_t ja = jdig[a];
+        mpz_dbl_dig_t carry = 0;
+
+        for (size_t b = a + 1; b < jlen; ++b, ++id) {
+            carry += (mpz_dbl_dig_t)*id + (mpz_dbl_dig_t)jdig[b] * ja;
+            *id = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+
+        *id = carry;
+    }
+
+    // double it
+    mpz_dbl_dig_t carry = 0;
+    for (size_t a = 0; a < 2 * jlen; ++a) {
+        carry += (mpz_dbl_dig_t)idig[a] << 1;
+        idig[a] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+
+    // add the squares j[a] * j[a]
+    carry = 0;
+    for (size_t a = 0; a < jlen; ++a) {
+        mpz_dbl_dig_t sq = (mpz_dbl_dig_t)jdig[a] * (mpz_dbl_dig_t)jdig[a];
+        carry += (mpz_dbl_dig_t)idig[2 * a] + (sq & DIG_MASK);
+        idig[2 * a] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+        carry += (mpz_dbl_dig_t)idig[2 * a + 1] + (sq >> DIG_SIZE);
+        idig[2 * a + 1] = carry & DIG_MASK;
+        carry >>= DIG_SIZE;
+    }
+}
+
+/* returns the number of digits of scratch memory needed by mpn_mul_n (and mpn_sqr_n)
+   assumes jlen >= klen
+*/
+STATIC size_t mpn_mul_tmp_len(size_t jlen, size_t klen) {
+    size_t tmp_len = 0;
+    if (klen >= MPZ_KARATSUBA_THRESHOLD && klen <= (jlen + 1) / 2) {
+        // unbalanced, multiplied in chunks of klen digits
+        tmp_len = 2 * klen;
+        jlen = klen;
+    }
+    while (jlen >= MPZ_KARATSUBA_THRESHOLD) {
+        jlen = (jlen + 1) / 2 + 1;
+        tmp_len += 4 * jlen;
+    }
+    return tmp_len;
+}
+
+/* computes i = j * k, writing all jlen + klen digits of i
+   assumes jlen >= klen; i must not overlap j or k
+   tmp must have mpn_mul_tmp_len(jlen, klen) digits of scratch memory
+*/
+STATIC void mpn_mul_n(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen, mpz_dig_t *tmp) {
+    if (klen < MPZ_KARATSUBA_THRESHOLD) {
+        mpn_mul_basecase(idig, jdig, jlen, kdig, klen);
+        return;
+    }
+
+    size_t m = (jlen + 1) / 2;
+    size_t ilen = jlen + klen;
+
+    if (klen <= m) {
+        // unbalanced: multiply k by successive chunks of klen digits of j
+        memset(idig, 0, ilen * sizeof(mpz_dig_t));
+        for (size_t off = 0; off < jlen; off += klen) {
+            size_t clen = MIN(klen, jlen - off);
+            if (clen < klen) {
+                mpn_mul_n(tmp, kdig, klen, jdig + off, clen, tmp + clen + klen);
+            } else {
+                mpn_mul_n(tmp, jdig + off, clen, kdig, klen, tmp + clen + klen);
+            }
+            mpn_add_n_inpl(idig + off, ilen - off, tmp, clen + klen);
+        }
+        return;
+    }
+
+    // Karatsuba: with j = j1*B^m + j0 and k = k1*B^m + k0 this computes
+    // z0 = j0*k0 and z2 = j1*k1 into the low and high parts of i, and then
+    // z1 = (j0+j1)*(k0+k1) - z0 - z2, which is added to i at digit m
+    mpn_mul_n(idig, jdig, m, kdig, m, tmp);
+    mpn_mul_n(idig + 2 * m, jdig + m, jlen - m, kdig + m, klen - m, tmp);
+
+    mpz_dig_t *sj = tmp;
+    mpz_dig_t *sk = tmp + m + 1;
+    mpz_dig_t *z1 = tmp + 2 * (m + 1);
+    memcpy(sj, jdig, m * sizeof(mpz_dig_t));
+    sj[m] = mpn_add_n_inpl(sj, m, jdig + m, jlen - m);
+    memcpy(sk, kdig, m * sizeof(mpz_dig_t));
+    sk[m] = mpn_add_n_inpl(sk, m, kdig + m, klen - m);
+
+    mpn_mul_n(z1, sj, m + 1, sk, m + 1, z1 + 2 * (m + 1));
+    mpn_sub_n_inpl(z1, 2 * (m + 1), idig, 2 * m);
+    mpn_sub_n_inpl(z1, 2 * (m + 1), idig + 2 * m, ilen - 2 * m);
+    // the top digits of z1 may not fit in i, but they are zero
+    mpn_add_n_inpl(idig + m, ilen - m, z1, MIN(2 * (m + 1), ilen - m));
+}
+
+/* computes i = j * j, writing all 2 * jlen digits of i
+   i must not overlap j
+   tmp must have mpn_mul_tmp_len(jlen, jlen) digits of scratch memory
+*/
+STATIC void mpn_sqr_n(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, mpz_dig_t *tmp) {
+    if (jlen < MPZ_KARATSUBA_THRESHOLD) {
+        mpn_sqr_basecase(idig, jdig, jlen);
+        return;
+    }
+
+    // as for mpn_mul_n, with z1 = (j0+j1)^2 - z0 - z2
+    size_t m = (jlen + 1) / 2;
+    mpn_sqr_n(idig, jdig, m, tmp);
+    mpn_sqr_n(idig + 2 * m, jdig + m, jlen - m, tmp);
+
+    mpz_dig_t *sj = tmp;
+    mpz_dig_t *z1 = tmp + m + 1;
+    memcpy(sj, jdig, m * sizeof(mpz_dig_t));
+    sj[m] = mpn_add_n_inpl(sj, m, jdig + m, jlen - m);
+
+    mpn_sqr_n(z1, sj, m + 1, z1 + 2 * (m + 1));
+    mpn_sub_n_inpl(z1, 2 * (m + 1), idig, 2 * m);
+    mpn_sub_n_inpl(z1, 2 * (m + 1), idig + 2 * m, 2 * (jlen - m));
+    mpn_add_n_inpl(idig + m, 2 * jlen - m, z1, MIN(2 * (m + 1), 2 * jlen - m));
+}
+
+#endif // MICROPY_OPT_MPZ_KARATSUBA || MICROPY_OPT_MPZ_MONTGOMERY
+
+#if MICROPY_OPT_MPZ_KARATSUBA
+
+/* computes i = j * k, using Karatsuba multiplication for large j and k, and
+   a dedicated squaring routine if j and k are the same
+   returns number of digits in i
+   assumes enough memory in i; assumes normalised j, k; i must not overlap j or k
+*/
+STATIC size_t mpn_mul_karatsuba(mpz_dig_t *idig, const mpz_dig_t *jdig, size_t jlen, const mpz_dig_t *kdig, size_t klen) {
+    if (jlen < klen) {
+        const mpz_dig_t *d = jdig; jdig = kdig; kdig = d;
+        size_t l = jlen; jlen = klen; klen = l;
+    }
+
+    size_t tmp_len = mpn_mul_tmp_len(jlen, klen);
+    mpz_dig_t *tmp = NULL;
+    if (tmp_len != 0) {
+        tmp = m_new(mpz_dig_t, tmp_len);
+    }
+
+    if (jdig == kdig && jlen == klen) {
+        mpn_sqr_n(idig, jdig, jlen, tmp);
+    } else {
+        mpn_mul_n(idig, jdig, jlen, kdig, klen, tmp);
+    }
+
+    if (tmp != NULL) {
+        m_del(mpz_dig_t, tmp, tmp_len);
+    }
+
+    size_t ilen = jlen + klen;
+    while (ilen > 0 && idig[ilen - 1] == 0) {
+        --ilen;
+    }
+    return ilen;
+}
+
+#endif
+
 /* natural_div - quo * den + new_num = old_num (ie num is replaced with rem)
    assumes den != 0
    assumes num_dig has enough memory to be extended by 1 digit
@@ -869,6 +1119,178 @@ typedef uint32_t mp_float_int_t;
 }
 #endif
 
+#if MICROPY_OPT_MPZ_FAST_STR
+
+// Conversion between mpz and strings of more than MPZ_STR_DC_THRESHOLD digits
+// splits the number (or string) in two at a power of the base, recursively,
+// so with Karatsuba multiplication it takes less than quadratic time.  The
+// powers are computed once per conversion, each the square of the previous.
+#ifndef MPZ_STR_DC_THRESHOLD
+#define MPZ_STR_DC_THRESHOLD (64)
+#endif
+
+typedef struct _mpz_str_level_t {
+    mpz_t pow; // base ** nchars
+    mpz_t inv; // floor(B ** (2 * pow.len) / pow), computed when needed for division
+    size_t nchars;
+} mpz_str_level_t;
+
+// returns the number of chars of the given base that fit in a digit, and that power of the base
+STATIC size_t mpz_str_chunk(unsigned int base, mpz_dig_t *chunk_pow) {
+    mpz_dbl_dig_t pow = base;
+    size_t nchars = 1;
+    while (pow * base <= DIG_MASK) {
+        pow *= base;
+        ++nchars;
+    }
+    *chunk_pow = pow;
+    return nchars;
+}
+
+// returns floor(log2(base))
+STATIC unsigned int mpz_str_log2(unsigned int base) {
+    unsigned int bits = 0;
+    while ((2u << bits) <= base) {
+        ++bits;
+    }
+    return bits;
+}
+
+// returns log2(base) if base is a power of 2, otherwise 0
+STATIC unsigned int mpz_str_pow2_bits(unsigned int base) {
+    if ((base & (base - 1)) != 0) {
+        return 0;
+    }
+    return mpz_str_log2(base);
+}
+
+// allocates and computes levels[i].pow = base ** (nchars * 2 ** i) for
+// i < num_levels, with num_levels as small as possible such that the last
+// power has at least min_chars chars
+STATIC mpz_str_level_t *mpz_str_levels_new(unsigned int base, size_t min_chars, size_t *num_levels) {
+    mpz_dig_t chunk_pow;
+    size_t nchars = mpz_str_chunk(base, &chunk_pow);
+    size_t n = 1;
+    for (size_t c = nchars; c < min_chars; c *= 2) {
+        ++n;
+    }
+    mpz_str_level_t *levels = m_new(mpz_str_level_t, n);
+    for (size_t i = 0; i < n; ++i) {
+        mpz_init_zero(&levels[i].pow);
+        mpz_init_zero(&levels[i].inv);
+        if (i == 0) {
+            mpz_set_from_int(&levels[i].pow, chunk_pow);
+            levels[i].nchars = nchars;
+        } else {
+            mpz_mul_inpl(&levels[i].pow, &levels[i - 1].pow, &levels[i - 1].pow);
+            levels[i].nchars = 2 * levels[i - 1].nchars;
+        }
+    }
+    *num_levels = n;
+    return levels;
+}
+
+STATIC void mpz_str_levels_free(mpz_str_level_t *levels, size_t num_levels) {
+    for (size_t i = 0; i < num_levels; ++i) {
+        mpz_deinit(&levels[i].pow);
+        mpz_deinit(&levels[i].inv);
+    }
+    m_del(mpz_str_level_t, levels, num_levels);
+}
+
+// returns the value of the char c, or a value not less than 36 if it's not a digit
+STATIC mp_uint_t mpz_char_value(mp_uint_t c) {
+    if ('0' <= c && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20; // lower case
+    if ('a' <= c && c <= 'z') {
+        return c - ('a' - 10);
+    }
+    return 36;
+}
+
+// sets z to the value of the n (valid) chars in str
+STATIC void mpz_set_from_str_dc(mpz_t *z, const char *str, size_t n, unsigned int base, const mpz_str_level_t *levels, size_t level) {
+    while (level > 0 && levels[level].nchars >= n) {
+        --level;
+    }
+    if (level == 0 || n <= levels[0].nchars * MPZ_STR_DC_THRESHOLD) {
+        // accumulate the chars in groups which fit in a digit
+        mpz_need_dig(z, n / levels[0].nchars + 1);
+        z->len = 0;
+        z->neg = 0;
+        size_t group = n % levels[0].nchars;
+        if (group == 0) {
+            group = levels[0].nchars;
+        }
+        mpz_dig_t group_pow = base;
+        for (size_t i = 1; i < group; ++i) {
+            group_pow *= base;
+        }
+        const char *top = str + n;
+        while (str < top) {
+            mpz_dig_t v = 0;
+            for (size_t i = 0; i < group; ++i) {
+                v = v * base + mpz_char_value(*str++);
+            }
+            z->len = mpn_mul_dig_add_dig(z->dig, z->len, group_pow, v);
+            group = levels[0].nchars;
+            group_pow = levels[0].pow.dig[0];
+        }
+        return;
+    }
+
+    // z = hi * base ** nchars + lo, where lo is the last nchars chars
+    size_t nchars = levels[level].nchars;
+    mpz_t lo;
+    mpz_init_zero(&lo);
+    mpz_set_from_str_dc(z, str, n - nchars, base, levels, level - 1);
+    mpz_set_from_str_dc(&lo, str + n - nchars, nchars, base, levels, level - 1);
+    mpz_mul_inpl(z, z, &levels[level].pow);
+    mpz_add_inpl(z, z, &lo);
+    mpz_deinit(&lo);
+}
+
+// returns number of bytes from str that were processed
+size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
+    assert(base <= 36);
+
+    // find the length of the valid digits
+    size_t n = 0;
+    while (n < len && mpz_char_value((byte)str[n]) < base) {
+        ++n;
+    }
+
+    unsigned int bits = mpz_str_pow2_bits(base);
+    if (bits != 0) {
+        // each char gives the same number of bits, so fill the digits from the end
+        mpz_need_dig(z, (n * bits + DIG_SIZE - 1) / DIG_SIZE + 1);
+        memset(z->dig, 0, z->alloc * sizeof(mpz_dig_t));
+        size_t bit = 0;
+        for (const char *cur = str + n; cur > str; bit += bits) {
+            mpz_dbl_dig_t v = mpz_char_value((byte)*--cur);
+            v <<= bit % DIG_SIZE;
+            z->dig[bit / DIG_SIZE] |= v & DIG_MASK;
+            if ((v >> DIG_SIZE) != 0) {
+                z->dig[bit / DIG_SIZE + 1] |= v >> DIG_SIZE;
+            }
+        }
+        z->len = mpn_remove_trailing_zeros(z->dig, z->dig + (n * bits + DIG_SIZE - 1) / DIG_SIZE);
+    } else {
+        size_t num_levels;
+        mpz_str_level_t *levels = mpz_str_levels_new(base, n, &num_levels);
+        mpz_set_from_str_dc(z, str, n, base, levels, num_levels - 1);
+        mpz_str_levels_free(levels, num_levels);
+    }
+
+    z->neg = neg;
+
+    return n;
+}
+
+#else
+
 // returns number of bytes from str that were processed
 size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigned int base) {
     assert(base <= 36);
@@ -906,6 +1328,8 @@ size_t mpz_set_from_str(mpz_t *z, const char *str, size_t len, bool neg, unsigne
     return cur - str;
 }
 
+#endif
+
 void mpz_set_from_bytes(mpz_t *z, bool big_endian, size_t len, const byte *buf) {
     int delta = 1;
     if (big_endian) {
@@ -1340,8 +1764,15 @@ void mpz_mul_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
     }
 
     mpz_need_dig(dest, lhs->len + rhs->len); // min mem l+r-1, max mem l+r
-    memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
-    dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    #if MICROPY_OPT_MPZ_KARATSUBA
+    if (lhs == rhs || MIN(lhs->len, rhs->len) >= MPZ_KARATSUBA_THRESHOLD) {
+        dest->len = mpn_mul_karatsuba(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    } else
+    #endif
+    {
+        memset(dest->dig, 0, dest->alloc * sizeof(mpz_dig_t));
+        dest->len = mpn_mul(dest->dig, lhs->dig, lhs->len, rhs->dig, rhs->len);
+    }
 
     if (lhs->neg == rhs->neg) {
         dest->neg = 0;
@@ -1386,6 +1817,165 @@ void mpz_pow_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs) {
     mpz_free(n);
 }
 
+#if MICROPY_OPT_MPZ_MONTGOMERY
+
+// State for multiplication modulo m of numbers in Montgomery form, that is
+// x*R mod m with R = B^n where m has n digits.  Multiplying two such numbers
+// and then reducing the product by R (REDC) gives the result in Montgomery
+// form as well, without doing any division.
+typedef struct _mpz_montgomery_t {
+    const mpz_dig_t *mdig;
+    size_t mlen;
+    mpz_dig_t minv; // -1/m mod B
+    mpz_dig_t *tdig; // 2 * mlen + 1 digits for the product
+    mpz_dig_t *tmp; // scratch memory for mpn_mul_n
+} mpz_montgomery_t;
+
+/* computes a = a * b / R mod m
+   a and b have mlen digits, and are less than m; can have a, b the same
+*/
+STATIC void mpz_montgomery_mul(const mpz_montgomery_t *mont, mpz_dig_t *adig, const mpz_dig_t *bdig) {
+    size_t mlen = mont->mlen;
+    mpz_dig_t *tdig = mont->tdig;
+
+    if (adig == bdig) {
+        mpn_sqr_n(tdig, adig, mlen, mont->tmp);
+    } else {
+        mpn_mul_n(tdig, adig, mlen, bdig, mlen, mont->tmp);
+    }
+    tdig[2 * mlen] = 0;
+
+    // add multiples of m to t to make its lower mlen digits zero
+    for (size_t i = 0; i < mlen; ++i) {
+        mpz_dbl_dig_t u = ((mpz_dbl_dig_t)tdig[i] * (mpz_dbl_dig_t)mont->minv) & DIG_MASK;
+        mpz_dig_t *td = tdig + i;
+        mpz_dbl_dig_t carry = 0;
+
+        for (size_t j = 0; j < mlen; ++j, ++td) {
+            carry += (mpz_dbl_dig_t)*td + u * (mpz_dbl_dig_t)mont->mdig[j];
+            *td = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+
+        for (; carry != 0; ++td) {
+            carry += *td;
+            *td = carry & DIG_MASK;
+            carry >>= DIG_SIZE;
+        }
+    }
+
+    // the result, t / R, is less than 2*m
+    tdig += mlen;
+    bool ge = tdig[mlen] != 0;
+    if (!ge) {
+        ge = true;
+        for (size_t i = mlen; i > 0; --i) {
+            if (tdig[i - 1] != mont->mdig[i - 1]) {
+                ge = tdig[i - 1] > mont->mdig[i - 1];
+                break;
+            }
+        }
+    }
+    if (ge) {
+        mpn_sub_n_inpl(tdig, mlen + 1, mont->mdig, mlen);
+    }
+    memcpy(adig, tdig, mlen * sizeof(mpz_dig_t));
+}
+
+/* computes dest = (lhs ** rhs) % mod using Montgomery multiplication
+   assumes mod is positive and odd, and rhs is positive
+   can have dest, lhs, rhs the same; mod can't be the same as dest
+*/
+STATIC void mpz_pow3_montgomery(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t *mod) {
+    size_t mlen = mod->len;
+
+    mpz_montgomery_t mont;
+    mont.mdig = mod->dig;
+    mont.mlen = mlen;
+
+    // Newton iteration for 1/m mod B, each step doubling the number of correct bits.
+    // Both factors of each product are reduced to one digit, so that it can't
+    // overflow when small digit types are promoted to signed int.
+    mpz_dbl_dig_t m0 = mod->dig[0];
+    mpz_dbl_dig_t inv = m0; // correct to 3 bits for odd m
+    for (int bits = 3; bits < DIG_SIZE; bits *= 2) {
+        mpz_dbl_dig_t e = (2 - m0 * inv) & DIG_MASK;
+        inv = (inv * e) & DIG_MASK;
+    }
+    mont.minv = (DIG_BASE - inv) & DIG_MASK;
+
+    // bit length of the exponent, which is positive, and the window size to use
+    size_t ebits = (rhs->len - 1) * DIG_SIZE;
+    for (mpz_dig_t d = rhs->dig[rhs->len - 1]; d != 0; d >>= 1) {
+        ++ebits;
+    }
+    size_t wbits = ebits > 256 ? 5 : ebits > 64 ? 4 : ebits > 16 ? 3 : 1;
+
+    // table[i] = lhs**i * R mod m, for 0 < i < 2**wbits; the base is reduced
+    // modulo m first, and converted to Montgomery form with a division
+    size_t table_len = mlen << wbits;
+    mpz_dig_t *table = m_new0(mpz_dig_t, table_len);
+    mpz_t x; mpz_init_zero(&x);
+    mpz_t quo; mpz_init_zero(&quo);
+    mpz_divmod_inpl(&quo, &x, lhs, mod);
+    mpz_shl_inpl(&x, &x, mlen * DIG_SIZE);
+    mpz_divmod_inpl(&quo, &x, &x, mod);
+    memcpy(table + mlen, x.dig, x.len * sizeof(mpz_dig_t));
+    mpz_deinit(&x);
+    mpz_deinit(&quo);
+
+    size_t tmp_len = mpn_mul_tmp_len(mlen, mlen);
+    mont.tdig = m_new(mpz_dig_t, 2 * mlen + 1 + tmp_len);
+    mont.tmp = mont.tdig + 2 * mlen + 1;
+
+    for (size_t i = 2; i < ((size_t)1 << wbits); ++i) {
+        memcpy(table + i * mlen, table + (i - 1) * mlen, mlen * sizeof(mpz_dig_t));
+        mpz_montgomery_mul(&mont, table + i * mlen, table + mlen);
+    }
+
+    // fixed window exponentiation, from the most significant window; the
+    // first window contains the top bit of the exponent so is never zero
+    mpz_dig_t *acc = m_new(mpz_dig_t, mlen);
+    bool first = true;
+    for (size_t w = (ebits + wbits - 1) / wbits; w-- > 0;) {
+        size_t idx = 0;
+        for (size_t b = wbits; b-- > 0;) {
+            size_t bit = w * wbits + b;
+            idx <<= 1;
+            if (bit < ebits) {
+                idx |= (rhs->dig[bit / DIG_SIZE] >> (bit % DIG_SIZE)) & 1;
+            }
+        }
+        if (first) {
+            memcpy(acc, table + idx * mlen, mlen * sizeof(mpz_dig_t));
+            first = false;
+            continue;
+        }
+        for (size_t i = 0; i < wbits; ++i) {
+            mpz_montgomery_mul(&mont, acc, acc);
+        }
+        if (idx != 0) {
+            mpz_montgomery_mul(&mont, acc, table + idx * mlen);
+        }
+    }
+
+    // convert out of Montgomery form by multiplying by 1
+    memset(table, 0, mlen * sizeof(mpz_dig_t));
+    table[0] = 1;
+    mpz_montgomery_mul(&mont, acc, table);
+
+    mpz_need_dig(dest, mlen);
+    memcpy(dest->dig, acc, mlen * sizeof(mpz_dig_t));
+    dest->len = mpn_remove_trailing_zeros(dest->dig, dest->dig + mlen);
+    dest->neg = 0;
+
+    m_del(mpz_dig_t, acc, mlen);
+    m_del(mpz_dig_t, mont.tdig, 2 * mlen + 1 + tmp_len);
+    m_del(mpz_dig_t, table, table_len);
+}
+
+#endif
+
 /* computes dest = (lhs ** rhs) % mod
    can have dest, lhs, rhs the same; mod can't be the same as dest
 */
@@ -1400,6 +1990,13 @@ void mpz_pow3_inpl(mpz_t *dest, const mpz_t *lhs, const mpz_t *rhs, const mpz_t
         return;
     }
 
+    #if MICROPY_OPT_MPZ_MONTGOMERY
+    if (mod->len != 0 && mod->neg == 0 && (mod->dig[0] & 1) != 0) {
+        mpz_pow3_montgomery(dest, lhs, rhs, mod);
+        return;
+    }
+    #endif
+
     mpz_t *x = mpz_clone(lhs);
     mpz_t *n = mpz_clone(rhs);
     mpz_t quo; mpz_init_zero(&quo);
@@ -1674,6 +2271,218 @@ char *mpz_as_str(const mpz_t *i, unsigned int base) {
 }
 #endif
 
+#if MICROPY_OPT_MPZ_FAST_STR
+
+// writes the number in dig[0..len) in the given base, as chars going backwards
+// from end, padded with zeros to at least width chars; the digits are destroyed
+// returns a pointer to the first char
+STATIC char *mpn_as_str_basecase(char *end, mpz_dig_t *dig, size_t len, unsigned int base, char base_char, size_t width) {
+    mpz_dig_t chunk_pow;
+    size_t nchars = mpz_str_chunk(base, &chunk_pow);
+    char *s = end;
+
+    while (len > 0) {
+        // divide by the largest power of the base that fits in a digit
+        mpz_dbl_dig_t a = 0;
+        for (mpz_dig_t *d = dig + len; --d >= dig;) {
+            a = (a << DIG_SIZE) | *d;
+            *d = a / chunk_pow;
+            a %= chunk_pow;
+        }
+        len = mpn_remove_trailing_zeros(dig, dig + len);
+
+        // convert the remainder to chars, all of them unless this is the top chunk
+        for (size_t i = 0; i < nchars && (len > 0 || a != 0); ++i) {
+            mpz_dig_t v = a % base;
+            a /= base;
+            *--s = v < 10 ? '0' + v : base_char + v - 10;
+        }
+    }
+
+    while ((size_t)(end - s) < width) {
+        *--s = '0';
+    }
+    return s;
+}
+
+// computes levels[level].inv, needed for division by levels[level].pow
+STATIC void mpz_str_level_inv(mpz_str_level_t *levels, size_t level) {
+    mpz_str_level_t *lvl = &levels[level];
+    if (lvl->inv.len != 0) {
+        return;
+    }
+    size_t m = lvl->pow.len;
+
+    // b2m = B ** 2m
+    mpz_t b2m; mpz_init_from_int(&b2m, 1);
+    mpz_shl_inpl(&b2m, &b2m, 2 * m * DIG_SIZE);
+    mpz_t r; mpz_init_zero(&r);
+
+    if (level == 0 || m < 2 * MPZ_STR_DC_THRESHOLD) {
+        mpz_divmod_inpl(&lvl->inv, &r, &b2m, &lvl->pow);
+    } else {
+        // Start from the square of the inverse of the previous level, which is
+        // correct to about half the digits, and do a Newton step:
+        // y = y + y * (B ** 2m - pow * y) / B ** 2m
+        mpz_str_level_inv(levels, level - 1);
+        mpz_t *y = &lvl->inv;
+        mpz_mul_inpl(y, &levels[level - 1].inv, &levels[level - 1].inv);
+        mpz_shr_inpl(y, y, (4 * levels[level - 1].pow.len - 2 * m) * DIG_SIZE);
+        mpz_mul_inpl(&r, &lvl->pow, y);
+        mpz_sub_inpl(&r, &b2m, &r);
+        mpz_mul_inpl(&r, &r, y);
+        mpz_shr_inpl(&r, &r, 2 * m * DIG_SIZE);
+        mpz_add_inpl(y, y, &r);
+
+        // correct the remaining error of a few units
+        mpz_t one; mpz_dig_t one_dig[MPZ_NUM_DIG_FOR_INT];
+        mpz_init_fixed_from_int(&one, one_dig, MPZ_NUM_DIG_FOR_INT, 1);
+        mpz_mul_inpl(&r, &lvl->pow, y);
+        mpz_sub_inpl(&r, &b2m, &r);
+        while (mpz_is_neg(&r)) {
+            mpz_sub_inpl(y, y, &one);
+            mpz_add_inpl(&r, &r, &lvl->pow);
+        }
+        while (mpz_cmp(&r, &lvl->pow) >= 0) {
+            mpz_add_inpl(y, y, &one);
+            mpz_sub_inpl(&r, &r, &lvl->pow);
+        }
+    }
+
+    mpz_deinit(&b2m);
+    mpz_deinit(&r);
+}
+
+// computes quo, rem = divmod(x, levels[level].pow), by Barrett reduction
+// assumes 0 <= x < levels[level].pow ** 2
+STATIC void mpz_str_divmod(mpz_t *quo, mpz_t *rem, const mpz_t *x, mpz_str_level_t *levels, size_t level) {
+    mpz_str_level_inv(levels, level);
+    const mpz_t *pow = &levels[level].pow;
+    size_t m = pow->len;
+
+    mpz_shr_inpl(quo, x, (m - 1) * DIG_SIZE);
+    mpz_mul_inpl(quo, quo, &levels[level].inv);
+    mpz_shr_inpl(quo, quo, (m + 1) * DIG_SIZE);
+    mpz_mul_inpl(rem, quo, pow);
+    mpz_sub_inpl(rem, x, rem);
+
+    // the estimate of the quotient is at most 2 too small
+    mpz_t one; mpz_dig_t one_dig[MPZ_NUM_DIG_FOR_INT];
+    mpz_init_fixed_from_int(&one, one_dig, MPZ_NUM_DIG_FOR_INT, 1);
+    while (mpz_cmp(rem, pow) >= 0) {
+        mpz_add_inpl(quo, quo, &one);
+        mpz_sub_inpl(rem, rem, pow);
+    }
+}
+
+// writes x (non-negative) as chars going backwards from end, padded with zeros
+// to at least width chars; returns a pointer to the first char
+STATIC char *mpz_as_str_dc(char *end, const mpz_t *x, unsigned int base, char base_char, size_t width, mpz_str_level_t *levels, size_t level) {
+    // x is less than the power at the next level up, so use this level if x is too
+    while (level > 0 && levels[level].pow.len > x->len) {
+        --level;
+    }
+    if (level == 0 || x->len <= MPZ_STR_DC_THRESHOLD) {
+        mpz_dig_t *dig = m_new(mpz_dig_t, x->len);
+        memcpy(dig, x->dig, x->len * sizeof(mpz_dig_t));
+        char *s = mpn_as_str_basecase(end, dig, x->len, base, base_char, width);
+        m_del(mpz_dig_t, dig, x->len);
+        return s;
+    }
+
+    // x = quo * base ** nchars + rem, where rem gives the last nchars chars
+    size_t nchars = levels[level].nchars;
+    mpz_t quo; mpz_init_zero(&quo);
+    mpz_t rem; mpz_init_zero(&rem);
+    mpz_str_divmod(&quo, &rem, x, levels, level);
+    char *s = mpz_as_str_dc(end, &rem, base, base_char, nchars, levels, level - 1);
+    mpz_deinit(&rem);
+    s = mpz_as_str_dc(s, &quo, base, base_char, width > nchars ? width - nchars : 0, levels, level - 1);
+    mpz_deinit(&quo);
+    return s;
+}
+
+// assumes enough space as calculated by mp_int_format_size
+// returns length of string, not including null byte
+size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, char base_char, char comma, char *str) {
+    if (str == NULL) {
+        return 0;
+    }
+    if (base < 2 || base > 32) {
+        str[0] = 0;
+        return 0;
+    }
+
+    size_t ilen = i->len;
+
+    char *s = str;
+    if (i->neg != 0 && ilen != 0) {
+        *s++ = '-';
+    }
+    if (prefix) {
+        while (*prefix)
+            *s++ = *prefix++;
+    }
+    if (ilen == 0) {
+        *s++ = '0';
+        *s = '\0';
+        return s - str;
+    }
+
+    // convert the magnitude into a temporary buffer, from the end
+    size_t buf_len;
+    unsigned int bits = mpz_str_pow2_bits(base);
+    char *buf;
+    char *digits;
+    if (bits != 0) {
+        // each char takes the same number of bits, so needs no division
+        buf_len = (ilen * DIG_SIZE + bits - 1) / bits;
+        buf = m_new(char, buf_len);
+        digits = buf + buf_len;
+        mp_uint_t mask = base - 1;
+        for (size_t bit = 0; bit < ilen * DIG_SIZE; bit += bits) {
+            mpz_dbl_dig_t v = i->dig[bit / DIG_SIZE] >> (bit % DIG_SIZE);
+            if (bit / DIG_SIZE + 1 < ilen) {
+                v |= (mpz_dbl_dig_t)i->dig[bit / DIG_SIZE + 1] << (DIG_SIZE - bit % DIG_SIZE);
+            }
+            v &= mask;
+            *--digits = v < 10 ? '0' + v : base_char + v - 10;
+        }
+    } else {
+        // the top level is such that the square of its power is at least B ** ilen
+        unsigned int log2_base = mpz_str_log2(base);
+        size_t max_chars = ilen * DIG_SIZE / log2_base + 1;
+        size_t num_levels;
+        mpz_str_level_t *levels = mpz_str_levels_new(base, (max_chars + 1) / 2, &num_levels);
+        // lower parts are padded with zeros, up to twice the chars of the top level
+        buf_len = MAX(max_chars, 2 * levels[num_levels - 1].nchars);
+        buf = m_new(char, buf_len);
+        mpz_t abs = *i;
+        abs.neg = 0;
+        digits = mpz_as_str_dc(buf + buf_len, &abs, base, base_char, 0, levels, num_levels - 1);
+        mpz_str_levels_free(levels, num_levels);
+    }
+
+    // skip leading zeros, then copy with the separators
+    char *top = buf + buf_len;
+    while (digits < top - 1 && *digits == '0') {
+        ++digits;
+    }
+    for (size_t n = top - digits; n > 0; --n) {
+        *s++ = *digits++;
+        if (comma && n > 1 && (n - 1) % 3 == 0) {
+            *s++ = comma;
+        }
+    }
+    *s = '\0';
+
+    m_del(char, buf, buf_len);
+
+    return s - str;
+}
+
+#else
+
 // assumes enough space as calculated by mp_int_format_size
 // returns length of string, not including null byte
 size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, char base_char, char comma, char *str) {
@@ -1731,7 +2540,7 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
                 break;
             }
         }
-        if (comma && (s - last_comma) == 3) {
+        if (comma && !done && (s - last_comma) == 3) {
             *s++ = comma;
             last_comma = s;
         }
@@ -1763,4 +2572,6 @@ size_t mpz_as_str_inpl(const mpz_t *i, unsigned int base, const char *prefix, ch
     return s - str;
 }
 
+#endif
+
 #endif // MICROPY_LONGINT_IMPL == MICROPY_LONGINT_IMPL_MPZ
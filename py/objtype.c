@@ -47,13 +47,166 @@ STATIC mp_obj_t static_class_method_make_new(const mp_obj_type_t *self_in, size_
 // instance object
 
 STATIC mp_obj_t mp_obj_new_instance(const mp_obj_type_t *class, size_t subobjs) {
+    #if MICROPY_PY_SLOTS
+    const mp_obj_instance_type_t *type = (const mp_obj_instance_type_t*)class;
+    if (type->has_slots) {
+        mp_obj_slots_instance_t *o = m_new_obj_var(mp_obj_slots_instance_t, mp_obj_t, type->keys_len);
+        o->base.type = class;
+        mp_seq_clear(o->slots, 0, type->keys_len, sizeof(*o->slots));
+        return MP_OBJ_FROM_PTR(o);
+    }
+    #endif
     mp_obj_instance_t *o = m_new_obj_var(mp_obj_instance_t, mp_obj_t, subobjs);
     o->base.type = class;
     mp_map_init(&o->members, 0);
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS
+    // start out with the values laid out by the shared key table of the class
+    o->members.is_fixed = 1;
+    #endif
     mp_seq_clear(o->subobj, 0, subobjs, sizeof(*o->subobj));
     return MP_OBJ_FROM_PTR(o);
 }
 
+#if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+
+size_t mp_obj_instance_key_index(const mp_obj_type_t *type, size_t n, qstr attr) {
+    const qstr *keys = ((const mp_obj_instance_type_t*)type)->keys;
+    for (size_t i = 0; i < n; ++i) {
+        if (keys[i] == attr) {
+            return i;
+        }
+    }
+    return n;
+}
+
+STATIC void type_append_key(mp_obj_instance_type_t *self, qstr attr) {
+    if (self->keys_len == self->keys_alloc) {
+        self->keys = m_renew(qstr, self->keys, self->keys_alloc, self->keys_alloc + 4);
+        self->keys_alloc += 4;
+    }
+    self->keys[self->keys_len++] = attr;
+}
+
+#endif
+
+#if MICROPY_OPT_INSTANCE_SHARED_KEYS
+
+// Once the key table of a class reaches this size any new attributes are
+// stored in the private map of an instance, instead of adding to the table.
+#define INSTANCE_SHARED_KEYS_MAX (64)
+
+// convert a split instance to one that stores its attributes in its own map
+STATIC void instance_unsplit(mp_obj_instance_t *self) {
+    const qstr *keys = mp_obj_instance_keys(self);
+    mp_obj_t *values = mp_obj_instance_split_values(self);
+    size_t used = self->members.used;
+    size_t alloc = self->members.alloc;
+    mp_map_init(&self->members, 0);
+    for (size_t i = 0; i < used; ++i) {
+        if (values[i] != MP_OBJ_NULL) {
+            mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(keys[i]), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = values[i];
+        }
+    }
+    m_del(mp_obj_t, values, alloc);
+}
+
+// Try to store value as the attribute attr of a split instance, by following
+// (and possibly extending) the key table of its class.  Returns false if the
+// instance must be converted to a map to hold the new attribute.
+STATIC bool instance_split_store(mp_obj_instance_t *self, qstr attr, mp_obj_t value) {
+    mp_obj_instance_type_t *type = (mp_obj_instance_type_t*)self->base.type;
+    size_t used = self->members.used;
+    size_t new_alloc;
+    if (used < type->keys_len) {
+        if (type->keys[used] != attr) {
+            // layout diverges from the class
+            return false;
+        }
+        // grow to hold all the attributes other instances of the class have
+        new_alloc = type->keys_len;
+    } else {
+        if (type->keys_len >= INSTANCE_SHARED_KEYS_MAX) {
+            return false;
+        }
+        // extend the layout of the class with a new key
+        type_append_key(type, attr);
+        new_alloc = used + 4;
+    }
+    mp_obj_t *values = mp_obj_instance_split_values(self);
+    if (used == self->members.alloc) {
+        values = m_renew(mp_obj_t, values, self->members.alloc, new_alloc);
+        mp_seq_clear(values, used, new_alloc, sizeof(*values));
+        self->members.alloc = new_alloc;
+        self->members.table = (mp_map_elem_t*)values;
+    }
+    values[used] = value;
+    self->members.used = used + 1;
+    return true;
+}
+
+#endif
+
+// returns the value of the instance member attr, or MP_OBJ_NULL if there isn't one
+STATIC mp_obj_t instance_load_member(mp_obj_instance_t *self, qstr attr) {
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+    mp_obj_t *values;
+    size_t n;
+    if (mp_obj_instance_get_values(self, &values, &n)) {
+        size_t i = mp_obj_instance_key_index(self->base.type, n, attr);
+        if (i < n) {
+            return values[i];
+        }
+        return MP_OBJ_NULL;
+    }
+    #endif
+    mp_map_elem_t *elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
+    if (elem != NULL) {
+        return elem->value;
+    }
+    return MP_OBJ_NULL;
+}
+
+// Stores value as the instance member attr, or deletes the member if value is
+// MP_OBJ_NULL.  Returns false if the member to delete doesn't exist, or if the
+// instance can't have an attribute of that name.
+STATIC bool instance_store_member(mp_obj_instance_t *self, qstr attr, mp_obj_t value) {
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+    mp_obj_t *values;
+    size_t n;
+    if (mp_obj_instance_get_values(self, &values, &n)) {
+        size_t i = mp_obj_instance_key_index(self->base.type, n, attr);
+        if (i < n) {
+            if (value == MP_OBJ_NULL && values[i] == MP_OBJ_NULL) {
+                return false;
+            }
+            values[i] = value;
+            return true;
+        }
+        if (value == MP_OBJ_NULL) {
+            return false;
+        }
+        #if MICROPY_PY_SLOTS
+        if (mp_obj_instance_has_slots(self)) {
+            // not one of the slots
+            return false;
+        }
+        #endif
+        #if MICROPY_OPT_INSTANCE_SHARED_KEYS
+        if (instance_split_store(self, attr, value)) {
+            return true;
+        }
+        instance_unsplit(self);
+        #endif
+    }
+    #endif
+    if (value == MP_OBJ_NULL) {
+        mp_map_elem_t *elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
+        return elem != NULL;
+    }
+    mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
+    return true;
+}
+
 STATIC int instance_count_native_bases(const mp_obj_type_t *type, const mp_obj_type_t **last_native_base) {
     int count = 0;
     for (;;) {
@@ -358,8 +511,20 @@ STATIC mp_obj_t instance_unary_op(mp_unary_op_t op, mp_obj_t self_in) {
         const mp_obj_type_t *native_base;
         size_t num_native_bases = instance_count_native_bases(mp_obj_get_type(self_in), &native_base);
 
-        size_t sz = sizeof(*self) + sizeof(*self->subobj) * num_native_bases
-            + sizeof(*self->members.table) * self->members.alloc;
+        size_t sz = sizeof(*self) + sizeof(*self->subobj) * num_native_bases;
+        #if MICROPY_PY_SLOTS
+        if (mp_obj_instance_has_slots(self)) {
+            sz = sizeof(mp_obj_slots_instance_t) + sizeof(mp_obj_t) * ((mp_obj_instance_type_t*)self->base.type)->keys_len;
+        } else
+        #endif
+        #if MICROPY_OPT_INSTANCE_SHARED_KEYS
+        if (mp_obj_instance_is_split(self)) {
+            sz += sizeof(mp_obj_t) * self->members.alloc;
+        } else
+        #endif
+        {
+            sz += sizeof(*self->members.table) * self->members.alloc;
+        }
         return MP_OBJ_NEW_SMALL_INT(sz);
     }
     #endif
@@ -530,20 +695,38 @@ STATIC void mp_obj_instance_load_attr(mp_obj_t self_in, qstr attr, mp_obj_t *des
     assert(mp_obj_is_instance_type(mp_obj_get_type(self_in)));
     mp_obj_instance_t *self = MP_OBJ_TO_PTR(self_in);
 
-    mp_map_elem_t *elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP);
-    if (elem != NULL) {
+    mp_obj_t member = instance_load_member(self, attr);
+    if (member != MP_OBJ_NULL) {
         // object member, always treated as a value
         // TODO should we check for properties?
-        dest[0] = elem->value;
+        dest[0] = member;
         return;
     }
 #if MICROPY_CPYTHON_COMPAT
-    if (attr == MP_QSTR___dict__) {
+    if (attr == MP_QSTR___dict__
+        #if MICROPY_PY_SLOTS
+        // an instance with __slots__ doesn't have a __dict__
+        && !mp_obj_instance_has_slots(self)
+        #endif
+        ) {
         // Create a new dict with a copy of the instance's map items.
         // This creates, unlike CPython, a 'read-only' __dict__: modifying
         // it will not result in modifications to the actual instance members.
         mp_map_t *map = &self->members;
         mp_obj_t attr_dict = mp_obj_new_dict(map->used);
+        #if MICROPY_OPT_INSTANCE_SHARED_KEYS
+        if (mp_obj_instance_is_split(self)) {
+            const qstr *keys = mp_obj_instance_keys(self);
+            const mp_obj_t *values = mp_obj_instance_split_values(self);
+            for (size_t i = 0; i < map->used; ++i) {
+                if (values[i] != MP_OBJ_NULL) {
+                    mp_obj_dict_store(attr_dict, MP_OBJ_NEW_QSTR(keys[i]), values[i]);
+                }
+            }
+            dest[0] = attr_dict;
+            return;
+        }
+        #endif
         for (size_t i = 0; i < map->alloc; ++i) {
             if (MP_MAP_SLOT_IS_FILLED(map, i)) {
                 mp_obj_dict_store(attr_dict, map->table[i].key, map->table[i].value);
@@ -561,7 +744,7 @@ STATIC void mp_obj_instance_load_attr(mp_obj_t self_in, qstr attr, mp_obj_t *des
         .is_type = false,
     };
     mp_obj_class_lookup(&lookup, self->base.type);
-    mp_obj_t member = dest[0];
+    member = dest[0];
     if (member != MP_OBJ_NULL) {
         #if MICROPY_PY_BUILTINS_PROPERTY
         if (MP_OBJ_IS_TYPE(member, &mp_type_property)) {
@@ -714,8 +897,7 @@ STATIC bool mp_obj_instance_store_attr(mp_obj_t self_in, qstr attr, mp_obj_t val
         }
         #endif
 
-        mp_map_elem_t *elem = mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_REMOVE_IF_FOUND);
-        return elem != NULL;
+        return instance_store_member(self, attr, MP_OBJ_NULL);
     } else {
         // store attribute
         #if MICROPY_PY_DELATTR_SETATTR
@@ -731,8 +913,7 @@ STATIC bool mp_obj_instance_store_attr(mp_obj_t self_in, qstr attr, mp_obj_t val
         }
         #endif
 
-        mp_map_lookup(&self->members, MP_OBJ_NEW_QSTR(attr), MP_MAP_LOOKUP_ADD_IF_NOT_FOUND)->value = value;
-        return true;
+        return instance_store_member(self, attr, value);
     }
 }
 
@@ -976,6 +1157,73 @@ const mp_obj_type_t mp_type_type = {
     .attr = type_attr,
 };
 
+#if MICROPY_PY_SLOTS
+// Resolve the __slots__ of a new class into its key table, with the slots of
+// its bases first.  The class only gets instances with a fixed layout if all
+// its bases also have __slots__, and if __dict__ isn't one of the slots.
+// Like in CPython, the slots of all bases must be those of one base and its
+// own bases, so that the layout of each base is a prefix of the new one.
+STATIC void type_init_slots(mp_obj_instance_type_t *self, size_t n_bases, const mp_obj_t *bases) {
+    const mp_obj_instance_type_t *widest = NULL;
+    bool all_slots = true;
+    for (size_t i = 0; i < n_bases; i++) {
+        const mp_obj_instance_type_t *base = MP_OBJ_TO_PTR(bases[i]);
+        if (&base->type == &mp_type_object) {
+            continue;
+        }
+        if (!base->has_slots) {
+            all_slots = false;
+            continue;
+        }
+        if (base->keys_len == 0) {
+            continue;
+        }
+        if (widest == NULL) {
+            widest = base;
+            continue;
+        }
+        size_t n = MIN(widest->keys_len, base->keys_len);
+        if (memcmp(widest->keys, base->keys, n * sizeof(qstr)) != 0) {
+            mp_raise_TypeError("multiple bases have instance lay-out conflict");
+        }
+        if (base->keys_len > widest->keys_len) {
+            widest = base;
+        }
+    }
+
+    mp_map_elem_t *elem = mp_map_lookup(&self->type.locals_dict->map, MP_OBJ_NEW_QSTR(MP_QSTR___slots__), MP_MAP_LOOKUP);
+    if (elem == NULL || !all_slots) {
+        return;
+    }
+    if (widest != NULL) {
+        for (size_t j = 0; j < widest->keys_len; j++) {
+            type_append_key(self, widest->keys[j]);
+        }
+    }
+    mp_obj_t iterable = elem->value;
+    if (MP_OBJ_IS_STR(iterable)) {
+        // a single slot name
+        iterable = mp_obj_new_tuple(1, &iterable);
+    }
+    mp_obj_t iter = mp_getiter(iterable, NULL);
+    mp_obj_t item;
+    while ((item = mp_iternext(iter)) != MP_OBJ_STOP_ITERATION) {
+        qstr attr = mp_obj_str_get_qstr(item);
+        if (attr == MP_QSTR___dict__) {
+            goto no_slots;
+        }
+        if (mp_obj_instance_key_index(&self->type, self->keys_len, attr) == self->keys_len) {
+            type_append_key(self, attr);
+        }
+    }
+    self->has_slots = true;
+    return;
+
+no_slots:
+    self->keys_len = 0;
+}
+#endif
+
 mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict) {
     assert(MP_OBJ_IS_TYPE(bases_tuple, &mp_type_tuple)); // MicroPython restriction, for now
     assert(MP_OBJ_IS_TYPE(locals_dict, &mp_type_dict)); // MicroPython restriction, for now
@@ -1000,7 +1248,11 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         }
     }
 
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+    mp_obj_type_t *o = &m_new0(mp_obj_instance_type_t, 1)->type;
+    #else
     mp_obj_type_t *o = m_new0(mp_obj_type_t, 1);
+    #endif
     o->base.type = &mp_type_type;
     o->name = name;
     o->print = instance_print;
@@ -1046,6 +1298,13 @@ mp_obj_t mp_obj_new_type(qstr name, mp_obj_t bases_tuple, mp_obj_t locals_dict)
         }
     }
 
+    #if MICROPY_PY_SLOTS
+    // instances with a native sub-object need the full instance layout
+    if (num_native_bases == 0) {
+        type_init_slots((mp_obj_instance_type_t*)o, len, items);
+    }
+    #endif
+
     return MP_OBJ_FROM_PTR(o);
 }
 
@@ -37,6 +37,74 @@ typedef struct _mp_obj_instance_t {
     // TODO maybe cache __getattr__ and __setattr__ for efficient lookup of them
 } mp_obj_instance_t;
 
+#if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+// A user-defined class, with a table of instance attribute names that is shared
+// by all instances of the class.  Names are added to the table in the order in
+// which instances first assign them, or are fixed by __slots__.
+typedef struct _mp_obj_instance_type_t {
+    mp_obj_type_t type;
+    #if MICROPY_PY_SLOTS
+    bool has_slots;
+    #endif
+    size_t keys_len;
+    size_t keys_alloc;
+    qstr *keys;
+} mp_obj_instance_type_t;
+
+#define mp_obj_instance_keys(o) (((mp_obj_instance_type_t*)(o)->base.type)->keys)
+
+// returns the index of attr in the first n keys of the class type, or n if it's not there
+size_t mp_obj_instance_key_index(const mp_obj_type_t *type, size_t n, qstr attr);
+#endif
+
+#if MICROPY_OPT_INSTANCE_SHARED_KEYS
+// An instance starts out "split": its members map is marked as fixed but not
+// ordered (a combination which is not otherwise used) and members.table points
+// to an array of members.alloc values, instead of key/value pairs.  The first
+// members.used values belong to the first keys of the class's key table, with
+// MP_OBJ_NULL marking an attribute that was deleted.  If an instance assigns
+// its attributes in a different order to its class then it is converted to a
+// normal hash-table map.
+#define mp_obj_instance_is_split(o) ((o)->members.is_fixed && !(o)->members.is_ordered)
+#define mp_obj_instance_split_values(o) ((mp_obj_t*)(o)->members.table)
+#endif
+
+#if MICROPY_PY_SLOTS
+// An instance of a class with __slots__ has no members map, and as such a class
+// can't have a native base it has no sub-object either: the values of the slots,
+// in the order of the key table of the class, follow the base directly.
+typedef struct _mp_obj_slots_instance_t {
+    mp_obj_base_t base;
+    mp_obj_t slots[];
+} mp_obj_slots_instance_t;
+
+#define mp_obj_instance_has_slots(o) (((mp_obj_instance_type_t*)(o)->base.type)->has_slots)
+#define mp_obj_instance_slots(o) (((mp_obj_slots_instance_t*)(o))->slots)
+#endif
+
+#if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+// If the attributes of instance o are laid out by the key table of its class then
+// sets *values to their values (MP_OBJ_NULL for an unset one) and *n to the number
+// of them, and returns true.  Returns false if o stores its attributes in a map.
+static inline bool mp_obj_instance_get_values(mp_obj_instance_t *o, mp_obj_t **values, size_t *n) {
+    #if MICROPY_PY_SLOTS
+    if (mp_obj_instance_has_slots(o)) {
+        *values = mp_obj_instance_slots(o);
+        *n = ((mp_obj_instance_type_t*)o->base.type)->keys_len;
+        return true;
+    }
+    #endif
+    #if MICROPY_OPT_INSTANCE_SHARED_KEYS
+    if (mp_obj_instance_is_split(o)) {
+        *values = mp_obj_instance_split_values(o);
+        *n = o->members.used;
+        return true;
+    }
+    #endif
+    return false;
+}
+#endif
+
 // this needs to be exposed for MICROPY_OPT_CACHE_MAP_LOOKUP_IN_BYTECODE to work
 void mp_obj_instance_attr(mp_obj_t self_in, qstr attr, mp_obj_t *dest);
 
@@ -34,6 +34,11 @@
 
 #if MICROPY_PY_BUILTINS_FLOAT
 #include <math.h>
+#if MICROPY_OPT_FLOAT_ROUNDTRIP
+#include <float.h>
+#include <string.h>
+#include "py/formatfloat.h"
+#endif
 #endif
 
 STATIC NORETURN void raise_exc(mp_obj_t exc, mp_lexer_t *lex) {
@@ -162,6 +167,330 @@ value_error:
     }
 }
 
+#if MICROPY_PY_BUILTINS_FLOAT && MICROPY_OPT_FLOAT_ROUNDTRIP
+
+// Correctly rounded conversion of decimal strings to floats.  Most numbers are
+// exact in a single float operation (Clinger's fast path), or are decided by a
+// truncated 128-bit product with a power of 10 (the Eisel-Lemire algorithm).
+// What's left (ties, subnormals) is done exactly on a big decimal.
+
+#if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+#define FP_MANT_BITS (52)
+#define FP_EXP_BITS (11)
+#define FP_EXP10_MAX (308)
+#define FP_EXACT_POW10_MAX (22)
+#define DEC_BIG_MAX_DIGITS (800)
+typedef uint64_t fp_bits_t;
+#else
+#define FP_MANT_BITS (23)
+#define FP_EXP_BITS (8)
+#define FP_EXP10_MAX (38)
+#define FP_EXACT_POW10_MAX (10)
+#define DEC_BIG_MAX_DIGITS (128)
+typedef uint32_t fp_bits_t;
+#endif
+#define FP_EXP_BIAS ((1 << (FP_EXP_BITS - 1)) - 1)
+#define FP_EL_SHIFT (64 - FP_MANT_BITS - 3)
+#define FP_EL_MASK (((uint64_t)1 << FP_EL_SHIFT) - 1)
+
+// The powers of 10 that are exact as floats
+STATIC const mp_float_t fp_exact_pow10[] = {
+    MICROPY_FLOAT_CONST(1e0), MICROPY_FLOAT_CONST(1e1), MICROPY_FLOAT_CONST(1e2),
+    MICROPY_FLOAT_CONST(1e3), MICROPY_FLOAT_CONST(1e4), MICROPY_FLOAT_CONST(1e5),
+    MICROPY_FLOAT_CONST(1e6), MICROPY_FLOAT_CONST(1e7), MICROPY_FLOAT_CONST(1e8),
+    MICROPY_FLOAT_CONST(1e9), MICROPY_FLOAT_CONST(1e10),
+    #if FP_EXACT_POW10_MAX > 10
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    #endif
+};
+
+STATIC mp_float_t fp_from_bits(fp_bits_t bits) {
+    union { mp_float_t f; fp_bits_t u; } fb;
+    fb.u = bits;
+    return fb.f;
+}
+
+// Computes the bits of w * 10**q for w != 0, or returns false if the truncated
+// product is too close to a rounding boundary, or the result is subnormal or
+// overflows.
+STATIC bool fp_eisel_lemire(uint64_t w, int q, fp_bits_t *bits) {
+    int clz = 0;
+    for (int sh = 32; sh > 0; sh >>= 1) {
+        if ((w >> (64 - sh)) == 0) {
+            w <<= sh;
+            clz += sh;
+        }
+    }
+    // 217706 / 2**16 is log2(10) to enough places for the table's range
+    int exp2 = ((217706 * q) >> 16) + 64 + FP_EXP_BIAS - clz;
+
+    // The table is truncated, so the exact product is in [p, p + w)
+    uint64_t hi;
+    #if MICROPY_FLOAT_IMPL == MICROPY_FLOAT_IMPL_DOUBLE
+    const uint64_t *pow10 = mp_float_pow5[q - MP_FLOAT_POW5_MIN];
+    uint64_t lo = mp_float_umul128(w, pow10[0], &hi);
+    if ((hi & FP_EL_MASK) == FP_EL_MASK && lo + w < w) {
+        // A carry into the kept bits is possible, so use the low 64 bits too
+        uint64_t y_hi;
+        uint64_t y_lo = mp_float_umul128(w, pow10[1], &y_hi);
+        uint64_t merged_lo = lo + y_hi;
+        uint64_t merged_hi = hi + (merged_lo < lo);
+        if ((merged_hi & FP_EL_MASK) == FP_EL_MASK && merged_lo + 1 == 0 && y_lo + w < w) {
+            return false;
+        }
+        hi = merged_hi;
+        lo = merged_lo;
+    }
+    #else
+    uint64_t lo = mp_float_umul128(w, mp_float_pow5[q - MP_FLOAT_POW5_MIN], &hi);
+    if ((hi & FP_EL_MASK) == FP_EL_MASK && lo + w < w) {
+        return false;
+    }
+    #endif
+
+    // Keep the significand plus one bit for rounding
+    int msb = hi >> 63;
+    uint64_t mant = hi >> (msb + FP_EL_SHIFT);
+    exp2 -= 1 ^ msb;
+    if (lo == 0 && (hi & FP_EL_MASK) == 0 && (mant & 3) == 1) {
+        // Possibly exactly half way
+        return false;
+    }
+    mant += mant & 1;
+    mant >>= 1;
+    if (mant >> (FP_MANT_BITS + 1)) {
+        mant >>= 1;
+        exp2 += 1;
+    }
+    if (exp2 <= 0 || exp2 >= (1 << FP_EXP_BITS) - 1) {
+        return false;
+    }
+    *bits = ((fp_bits_t)exp2 << FP_MANT_BITS) | ((fp_bits_t)mant & (((fp_bits_t)1 << FP_MANT_BITS) - 1));
+    return true;
+}
+
+// A decimal number 0.d[0]d[1]...d[nd-1] * 10**dp, with one digit per byte.
+// Only as many digits are kept as can affect rounding; trunc records whether
+// any of those dropped was nonzero.
+typedef struct _dec_big_t {
+    int nd;
+    int dp;
+    bool trunc;
+    uint8_t d[DEC_BIG_MAX_DIGITS + 10];
+} dec_big_t;
+
+STATIC void dec_big_trim(dec_big_t *a) {
+    while (a->nd > 0 && a->d[a->nd - 1] == 0) {
+        --a->nd;
+    }
+    if (a->nd == 0) {
+        a->dp = 0;
+    }
+}
+
+// a /= 2**k, for k <= 27
+STATIC void dec_big_shift_right(dec_big_t *a, int k) {
+    int r = 0;
+    int w = 0;
+    uint32_t n = 0;
+    for (; (n >> k) == 0; ++r) {
+        if (r >= a->nd) {
+            if (n == 0) {
+                a->nd = 0;
+                return;
+            }
+            while ((n >> k) == 0) {
+                n *= 10;
+                ++r;
+            }
+            break;
+        }
+        n = n * 10 + a->d[r];
+    }
+    a->dp -= r - 1;
+    uint32_t mask = ((uint32_t)1 << k) - 1;
+    for (; r < a->nd; ++r) {
+        a->d[w++] = n >> k;
+        n = (n & mask) * 10 + a->d[r];
+    }
+    while (n > 0) {
+        uint32_t dig = n >> k;
+        n &= mask;
+        if (w < DEC_BIG_MAX_DIGITS) {
+            a->d[w++] = dig;
+        } else if (dig > 0) {
+            a->trunc = true;
+        }
+        n *= 10;
+    }
+    a->nd = w;
+    dec_big_trim(a);
+}
+
+// a *= 2**k, for k <= 27
+STATIC void dec_big_shift_left(dec_big_t *a, int k) {
+    // At most this many new leading digits, so write the result that far along
+    int delta = ((k * 1233) >> 12) + 1;
+    int w = a->nd - 1 + delta;
+    uint32_t n = 0;
+    for (int r = a->nd - 1; r >= 0; --r) {
+        n += (uint32_t)a->d[r] << k;
+        a->d[w--] = n % 10;
+        n /= 10;
+    }
+    while (n > 0) {
+        a->d[w--] = n % 10;
+        n /= 10;
+    }
+    int shift = w + 1;
+    int nd = a->nd + delta - shift;
+    memmove(a->d, a->d + shift, nd);
+    a->dp += delta - shift;
+    for (; nd > DEC_BIG_MAX_DIGITS; --nd) {
+        a->trunc |= a->d[nd - 1] != 0;
+    }
+    a->nd = nd;
+    dec_big_trim(a);
+}
+
+STATIC void dec_big_shift(dec_big_t *a, int k) {
+    for (; k > 27; k -= 27) {
+        dec_big_shift_left(a, 27);
+    }
+    for (; k < -27; k += 27) {
+        dec_big_shift_right(a, 27);
+    }
+    if (k > 0) {
+        dec_big_shift_left(a, k);
+    } else if (k < 0) {
+        dec_big_shift_right(a, -k);
+    }
+}
+
+// The integer part of a, rounded half to even
+STATIC uint64_t dec_big_rounded_integer(const dec_big_t *a) {
+    uint64_t n = 0;
+    int i = 0;
+    for (; i < a->dp && i < a->nd; ++i) {
+        n = n * 10 + a->d[i];
+    }
+    for (; i < a->dp; ++i) {
+        n *= 10;
+    }
+    if (a->dp >= 0 && a->dp < a->nd) {
+        int dig = a->d[a->dp];
+        if (dig == 5 && a->dp + 1 == a->nd && !a->trunc) {
+            n += n & 1;
+        } else if (dig >= 5) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+// The float nearest to the decimal digits (and '.') at str, times 10**exp
+STATIC mp_float_t dec_big_to_float(const char *str, const char *top, int exp) {
+    dec_big_t a;
+    a.nd = 0;
+    a.dp = 0;
+    a.trunc = false;
+    bool frac = false;
+    for (; str < top && (unichar_isdigit(*str) || *str == '.'); ++str) {
+        if (*str == '.') {
+            frac = true;
+            continue;
+        }
+        int dig = *str - '0';
+        if (a.nd == 0 && dig == 0) {
+            a.dp -= frac;
+            continue;
+        }
+        a.dp += !frac;
+        if (a.nd < DEC_BIG_MAX_DIGITS) {
+            a.d[a.nd++] = dig;
+        } else if (dig != 0) {
+            a.trunc = true;
+        }
+    }
+    a.dp += exp;
+    dec_big_trim(&a);
+    if (a.nd == 0 || a.dp < -330) {
+        return 0;
+    }
+    if (a.dp > 310) {
+        return INFINITY;
+    }
+
+    // Scale by powers of 2 into [0.5, 1), with binary exponent exp2
+    static const uint8_t pow2_for_digits[] = {1, 3, 6, 9, 13, 16, 19, 23, 26};
+    int exp2 = 0;
+    while (a.dp > 0) {
+        int n = a.dp >= 9 ? 27 : pow2_for_digits[a.dp];
+        dec_big_shift(&a, -n);
+        exp2 += n;
+    }
+    while (a.dp < 0 || (a.dp == 0 && a.d[0] < 5)) {
+        int n = -a.dp >= 9 ? 27 : pow2_for_digits[-a.dp];
+        dec_big_shift(&a, n);
+        exp2 -= n;
+    }
+    // Floats are in [1, 2), and below the smallest normal exponent are subnormal
+    exp2 += FP_EXP_BIAS - 1;
+    if (exp2 < 1) {
+        dec_big_shift(&a, exp2 - 1);
+        exp2 = 1;
+    }
+    if (exp2 >= (1 << FP_EXP_BITS) - 1) {
+        return INFINITY;
+    }
+    dec_big_shift(&a, FP_MANT_BITS + 1);
+    uint64_t mant = dec_big_rounded_integer(&a);
+    if (mant == (uint64_t)2 << FP_MANT_BITS) {
+        mant >>= 1;
+        if (++exp2 >= (1 << FP_EXP_BITS) - 1) {
+            return INFINITY;
+        }
+    }
+    if (!(mant & ((uint64_t)1 << FP_MANT_BITS))) {
+        exp2 = 0;
+    }
+    return fp_from_bits(((fp_bits_t)exp2 << FP_MANT_BITS) | ((fp_bits_t)mant & (((fp_bits_t)1 << FP_MANT_BITS) - 1)));
+}
+
+// The float nearest to w * 10**q, where w holds the leading significant digits
+// of the number at str and trunc says whether nonzero digits followed them.
+// exp is the number's own exponent, for the exact fallback.
+STATIC mp_float_t fp_decimal_to_float(uint64_t w, int q, bool trunc, const char *str, const char *top, int exp) {
+    if (w == 0) {
+        return 0;
+    }
+    #if FLT_EVAL_METHOD == 0
+    if (!trunc && w <= (uint64_t)1 << (FP_MANT_BITS + 1) && -FP_EXACT_POW10_MAX <= q && q <= FP_EXACT_POW10_MAX) {
+        // Both w and 10**q are exact, so a single operation rounds correctly
+        mp_float_t f = (mp_float_t)w;
+        if (q < 0) {
+            return f / fp_exact_pow10[-q];
+        } else {
+            return f * fp_exact_pow10[q];
+        }
+    }
+    #endif
+    if (q < MP_FLOAT_POW5_MIN) {
+        return 0;
+    }
+    if (q > FP_EXP10_MAX) {
+        return INFINITY;
+    }
+    fp_bits_t bits, bits_up;
+    if (fp_eisel_lemire(w, q, &bits)
+        && (!trunc || (fp_eisel_lemire(w + 1, q, &bits_up) && bits == bits_up))) {
+        return fp_from_bits(bits);
+    }
+    return dec_big_to_float(str, top, exp);
+}
+
+#endif
+
 typedef enum {
     PARSE_DEC_IN_INTG,
     PARSE_DEC_IN_FRAC,
@@ -214,21 +543,44 @@ mp_obj_t mp_parse_num_decimal(const char *str, size_t len, bool allow_imag, bool
         // string should be a decimal number
         parse_dec_in_t in = PARSE_DEC_IN_INTG;
         bool exp_neg = false;
+        #if MICROPY_OPT_FLOAT_ROUNDTRIP
+        // The first 19 significant digits, which fit in 64 bits, and the power
+        // of 10 they scale by; more digits only matter in rare cases
+        uint64_t dig_val = 0;
+        int dig_num = 0;
+        int dig_exp = 0;
+        bool dig_trunc = false;
+        #else
         mp_float_t frac_mult = 0.1;
+        #endif
         mp_int_t exp_val = 0;
         while (str < top) {
             mp_uint_t dig = *str++;
             if ('0' <= dig && dig <= '9') {
                 dig -= '0';
                 if (in == PARSE_DEC_IN_EXP) {
-                    exp_val = 10 * exp_val + dig;
+                    // limit the exponent so it can't overflow; the value is 0 or inf by then
+                    if (exp_val < 100000000) {
+                        exp_val = 10 * exp_val + dig;
+                    }
                 } else {
+                    #if MICROPY_OPT_FLOAT_ROUNDTRIP
+                    if (dig_num < 19) {
+                        dig_val = 10 * dig_val + dig;
+                        dig_num += dig_val != 0;
+                        dig_exp -= in == PARSE_DEC_IN_FRAC;
+                    } else {
+                        dig_exp += in == PARSE_DEC_IN_INTG;
+                        dig_trunc |= dig != 0;
+                    }
+                    #else
                     if (in == PARSE_DEC_IN_FRAC) {
                         dec_val += dig * frac_mult;
                         frac_mult *= MICROPY_FLOAT_CONST(0.1);
                     } else {
                         dec_val = 10 * dec_val + dig;
                     }
+                    #endif
                 }
             } else if (in == PARSE_DEC_IN_INTG && dig == '.') {
                 in = PARSE_DEC_IN_FRAC;
@@ -261,7 +613,11 @@ mp_obj_t mp_parse_num_decimal(const char *str, size_t len, bool allow_imag, bool
         }
 
         // apply the exponent
+        #if MICROPY_OPT_FLOAT_ROUNDTRIP
+        dec_val = fp_decimal_to_float(dig_val, dig_exp + exp_val, dig_trunc, str_val_start, top, exp_val);
+        #else
         dec_val *= MICROPY_FLOAT_C_FUN(pow)(10, exp_val);
+        #endif
     }
 
     // negate value if needed
@@ -31,6 +31,7 @@
 #include "py/objstr.h"
 #include "py/stream.h"
 #include "py/runtime.h"
+#include "py/mphal.h"
 
 #if MICROPY_STREAMS_NON_BLOCK
 #include <errno.h>
@@ -263,6 +264,27 @@ void mp_stream_write_adaptor(void *self, const char *buf, size_t len) {
     mp_stream_write(MP_OBJ_FROM_PTR(self), buf, len, MP_STREAM_RW_WRITE);
 }
 
+mp_uint_t mp_stream_poll_notify_ioctl(mp_stream_poll_notify_t **slot, mp_uint_t request, uintptr_t arg) {
+    mp_stream_poll_notify_t *n = (mp_stream_poll_notify_t*)arg;
+    mp_stream_poll_notify_t *old;
+    mp_uint_t atomic_state = MICROPY_BEGIN_ATOMIC_SECTION();
+    old = *slot;
+    if (request == MP_STREAM_SET_POLL_NOTIFY) {
+        n->attached = true;
+        *slot = n;
+    } else if (old == n) {
+        n->attached = false;
+        *slot = NULL;
+    }
+    MICROPY_END_ATOMIC_SECTION(atomic_state);
+    if (request == MP_STREAM_SET_POLL_NOTIFY && old != NULL && old != n) {
+        // let the previous owner know that it has to poll the stream again
+        old->attached = false;
+        old->notify(old);
+    }
+    return 0;
+}
+
 STATIC mp_obj_t stream_write_method(size_t n_args, const mp_obj_t *args) {
     mp_buffer_info_t bufinfo;
     mp_get_buffer_raise(args[1], &bufinfo, MP_BUFFER_READ);
@@ -503,6 +525,126 @@ STATIC mp_obj_t stream_ioctl(size_t n_args, const mp_obj_t *args) {
 }
 MP_DEFINE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_ioctl_obj, 2, 3, stream_ioctl);
 
+#if MICROPY_PY_IO_COPY
+#ifdef MICROPY_PY_IO_COPY_FD
+// Returns the OS file descriptor behind a stream, or -1 if it has none
+STATIC int stream_get_fileno(mp_obj_t stream) {
+    const mp_stream_p_t *stream_p = mp_get_stream_raise(stream, 0);
+    if (stream_p->ioctl == NULL) {
+        return -1;
+    }
+    int error;
+    mp_uint_t res = stream_p->ioctl(stream, MP_STREAM_GET_FILENO, 0, &error);
+    if (res == MP_STREAM_ERROR) {
+        return -1;
+    }
+    return res;
+}
+#endif
+
+// Writes all of buf, waiting for a non-blocking stream to accept more data,
+// so that nothing already read from the source is dropped
+STATIC mp_uint_t stream_copy_write(mp_obj_t dst, const byte *buf, mp_uint_t size, int *errcode) {
+    mp_uint_t done = 0;
+    for (;;) {
+        done += mp_stream_write_exactly(dst, buf + done, size - done, errcode);
+        if (done == size || !mp_is_nonblocking_error(*errcode)) {
+            return done;
+        }
+        #ifdef MICROPY_EVENT_POLL_HOOK
+        MICROPY_EVENT_POLL_HOOK;
+        #else
+        mp_hal_delay_ms(1);
+        #endif
+    }
+}
+
+mp_uint_t mp_stream_copy(mp_obj_t src, mp_obj_t dst, mp_uint_t n, size_t bufsize, int *errcode) {
+    *errcode = 0;
+    mp_uint_t done = 0;
+
+    #ifdef MICROPY_PY_IO_COPY_FD
+    // Let the OS move the data when both streams are file descriptors
+    int src_fd = stream_get_fileno(src);
+    int dst_fd = stream_get_fileno(dst);
+    if (src_fd >= 0 && dst_fd >= 0) {
+        done = MICROPY_PY_IO_COPY_FD(src_fd, dst_fd, n, errcode);
+        if (*errcode != MP_EOPNOTSUPP) {
+            return done;
+        }
+        // This pair of descriptors can't be copied between by the OS, so
+        // copy the rest through a buffer
+        *errcode = 0;
+        if (n != MP_STREAM_COPY_ALL) {
+            n -= done;
+        }
+    }
+    #endif
+
+    byte *buf = m_new(byte, bufsize);
+    while (n > 0) {
+        mp_uint_t len = MIN(n, bufsize);
+        mp_uint_t out_sz = mp_stream_rw(src, buf, len, errcode, MP_STREAM_RW_READ | MP_STREAM_RW_ONCE);
+        if (*errcode != 0 || out_sz == 0) {
+            break;
+        }
+        mp_uint_t wr_sz = stream_copy_write(dst, buf, out_sz, errcode);
+        done += wr_sz;
+        if (*errcode != 0) {
+            break;
+        }
+        if (wr_sz < out_sz) {
+            // the write made no progress
+            *errcode = MP_EIO;
+            break;
+        }
+        if (n != MP_STREAM_COPY_ALL) {
+            n -= out_sz;
+        }
+    }
+    m_del(byte, buf, bufsize);
+    return done;
+}
+
+STATIC mp_obj_t stream_copy(size_t n_args, const mp_obj_t *pos_args, mp_map_t *kw_args) {
+    enum { ARG_src, ARG_dst, ARG_n, ARG_bufsize };
+    static const mp_arg_t allowed_args[] = {
+        { MP_QSTR_src, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_dst, MP_ARG_REQUIRED | MP_ARG_OBJ, {.u_obj = MP_OBJ_NULL} },
+        { MP_QSTR_n, MP_ARG_INT, {.u_int = -1} },
+        { MP_QSTR_bufsize, MP_ARG_INT, {.u_int = MICROPY_PY_IO_COPY_BUFSIZE} },
+    };
+    mp_arg_val_t args[MP_ARRAY_SIZE(allowed_args)];
+    mp_arg_parse_all(n_args, pos_args, kw_args, MP_ARRAY_SIZE(allowed_args), allowed_args, args);
+
+    mp_get_stream_raise(args[ARG_src].u_obj, MP_STREAM_OP_READ);
+    mp_get_stream_raise(args[ARG_dst].u_obj, MP_STREAM_OP_WRITE);
+    mp_uint_t n = MP_STREAM_COPY_ALL;
+    if (args[ARG_n].u_int >= 0) {
+        n = args[ARG_n].u_int;
+    }
+    if (args[ARG_bufsize].u_int <= 0) {
+        mp_raise_ValueError(NULL);
+    }
+
+    int error;
+    mp_uint_t done = mp_stream_copy(args[ARG_src].u_obj, args[ARG_dst].u_obj, n, args[ARG_bufsize].u_int, &error);
+    if (error != 0) {
+        if (mp_is_nonblocking_error(error)) {
+            // The source has no more data for now; like read(), return None
+            // if nothing was copied
+            if (done == 0) {
+                return mp_const_none;
+            }
+        } else {
+            mp_raise_OSError(error);
+        }
+    }
+    return mp_obj_new_int_from_uint(done);
+}
+MP_DEFINE_CONST_FUN_OBJ_KW(mp_stream_copy_obj, 2, stream_copy);
+#endif
+
 #if MICROPY_STREAMS_POSIX_API
 /*
  * POSIX-like functions
@@ -41,6 +41,9 @@
 #define MP_STREAM_SET_OPTS      (7)  // Set stream options
 #define MP_STREAM_GET_DATA_OPTS (8)  // Get data/message options
 #define MP_STREAM_SET_DATA_OPTS (9)  // Set data/message options
+#define MP_STREAM_SET_POLL_NOTIFY (10) // Attach a readiness notifier
+#define MP_STREAM_CLR_POLL_NOTIFY (11) // Detach a readiness notifier
+#define MP_STREAM_GET_FILENO    (12) // Get underlying OS file descriptor
 
 // These poll ioctl values are compatible with Linux
 #define MP_STREAM_POLL_RD  (0x0001)
@@ -57,6 +60,24 @@ struct mp_stream_seek_t {
     int whence;
 };
 
+// Argument structure for MP_STREAM_SET/CLR_POLL_NOTIFY.  A stream which
+// supports these keeps the attached notifier and calls mp_stream_poll_notify
+// on it whenever it may have become ready (eg from the callback or ISR that
+// received data), so a poller only needs to issue MP_STREAM_POLL after that.
+// notify may be called from an ISR.  A stream keeps one notifier; attaching
+// another one detaches the previous one, which is then notified once with
+// attached set to false.
+typedef struct _mp_stream_poll_notify_t {
+    void (*notify)(struct _mp_stream_poll_notify_t *self);
+    volatile bool attached;
+} mp_stream_poll_notify_t;
+
+static inline void mp_stream_poll_notify(mp_stream_poll_notify_t *n) {
+    if (n != NULL) {
+        n->notify(n);
+    }
+}
+
 // seek ioctl "whence" values
 #define MP_SEEK_SET (0)
 #define MP_SEEK_CUR (1)
@@ -73,6 +94,7 @@ MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_seek_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(mp_stream_tell_obj);
 MP_DECLARE_CONST_FUN_OBJ_1(mp_stream_flush_obj);
 MP_DECLARE_CONST_FUN_OBJ_VAR_BETWEEN(mp_stream_ioctl_obj);
+MP_DECLARE_CONST_FUN_OBJ_KW(mp_stream_copy_obj);
 
 // these are for mp_get_stream_raise and can be or'd together
 #define MP_STREAM_OP_READ (1)
@@ -95,8 +117,16 @@ mp_uint_t mp_stream_rw(mp_obj_t stream, void *buf, mp_uint_t size, int *errcode,
 #define mp_stream_write_exactly(stream, buf, size, err) mp_stream_rw(stream, (byte*)buf, size, err, MP_STREAM_RW_WRITE)
 #define mp_stream_read_exactly(stream, buf, size, err) mp_stream_rw(stream, buf, size, err, MP_STREAM_RW_READ)
 
+// Copy up to n bytes (MP_STREAM_COPY_ALL for all until EOF) from src to dst
+// via a buffer of bufsize bytes, returning the number of bytes written to dst
+#define MP_STREAM_COPY_ALL ((mp_uint_t)-1)
+mp_uint_t mp_stream_copy(mp_obj_t src, mp_obj_t dst, mp_uint_t n, size_t bufsize, int *errcode);
+
 void mp_stream_write_adaptor(void *self, const char *buf, size_t len);
 
+// Implements MP_STREAM_SET/CLR_POLL_NOTIFY for a stream keeping its notifier in *slot
+mp_uint_t mp_stream_poll_notify_ioctl(mp_stream_poll_notify_t **slot, mp_uint_t request, uintptr_t arg);
+
 #if MICROPY_STREAMS_POSIX_API
 // Functions with POSIX-compatible signatures
 ssize_t mp_stream_posix_write(mp_obj_t stream, const void *buf, size_t len);
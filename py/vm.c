@@ -347,6 +347,22 @@ dispatch_loop:
                     if (mp_obj_get_type(top)->attr == mp_obj_instance_attr) {
                         mp_obj_instance_t *self = MP_OBJ_TO_PTR(top);
                         mp_uint_t x = *ip;
+                        #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+                        mp_obj_t *values;
+                        size_t n;
+                        if (mp_obj_instance_get_values(self, &values, &n)) {
+                            if (!(x < n && mp_obj_instance_keys(self)[x] == qst)) {
+                                x = mp_obj_instance_key_index(self->base.type, n, qst);
+                                *(byte*)ip = x;
+                            }
+                            if (x == n || values[x] == MP_OBJ_NULL) {
+                                goto load_attr_cache_fail;
+                            }
+                            SET_TOP(values[x]);
+                            ip++;
+                            DISPATCH();
+                        }
+                        #endif
                         mp_obj_t key = MP_OBJ_NEW_QSTR(qst);
                         mp_map_elem_t *elem;
                         if (x < self->members.alloc && self->members.table[x].key == key) {
@@ -445,6 +461,23 @@ dispatch_loop:
                     if (mp_obj_get_type(top)->attr == mp_obj_instance_attr && sp[-1] != MP_OBJ_NULL) {
                         mp_obj_instance_t *self = MP_OBJ_TO_PTR(top);
                         mp_uint_t x = *ip;
+                        #if MICROPY_OPT_INSTANCE_SHARED_KEYS || MICROPY_PY_SLOTS
+                        mp_obj_t *values;
+                        size_t n;
+                        if (mp_obj_instance_get_values(self, &values, &n)) {
+                            if (!(x < n && mp_obj_instance_keys(self)[x] == qst)) {
+                                x = mp_obj_instance_key_index(self->base.type, n, qst);
+                                *(byte*)ip = x;
+                            }
+                            if (x == n || values[x] == MP_OBJ_NULL) {
+                                goto store_attr_cache_fail;
+                            }
+                            values[x] = sp[-1];
+                            sp -= 2;
+                            ip++;
+                            DISPATCH();
+                        }
+                        #endif
                         mp_obj_t key = MP_OBJ_NEW_QSTR(qst);
                         mp_map_elem_t *elem;
                         if (x < self->members.alloc && self->members.table[x].key == key) {
@@ -0,0 +1,65 @@
+# test instance attributes, assigned in the same and different orders
+
+class A:
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+a1 = A(1, 2)
+a2 = A(3, 4)
+print(a1.x, a1.y, a2.x, a2.y)
+
+# add an attribute past the common layout
+a1.z = 5
+a2.z = 6
+print(a1.z, a2.z)
+
+# store to existing attributes
+a1.x += 10
+a2.y += 10
+print(a1.x, a1.y, a2.x, a2.y)
+
+# delete and re-add an attribute
+del a1.y
+print(hasattr(a1, 'y'), a1.x, a1.z)
+try:
+    del a1.y
+except AttributeError:
+    print('AttributeError')
+a1.y = 7
+print(a1.x, a1.y, a1.z)
+
+# assign attributes in a different order to the other instances
+a3 = object.__new__(A)
+a3.z = 8
+a3.x = 9
+print(a3.x, a3.z, hasattr(a3, 'y'))
+a3.y = 10
+del a3.z
+print(a3.x, a3.y, hasattr(a3, 'z'))
+
+# dir and __dict__ reflect the instance attributes
+print(sorted([k for k in dir(a1) if not k.startswith('_')]))
+print(sorted([k for k in dir(a3) if not k.startswith('_')]))
+print(sorted(a1.__dict__.items()))
+print(sorted(a3.__dict__.items()))
+
+# many attributes, added dynamically
+class B:
+    pass
+
+bs = [B() for i in range(3)]
+for j, b in enumerate(bs):
+    for i in range(100):
+        setattr(b, 'attr%d' % ((i + j * 10) % 100), i)
+for b in bs:
+    print(sum([getattr(b, 'attr%d' % i) for i in range(100)]))
+
+# attribute access in a loop uses the cache in the bytecode
+def f(objs):
+    s = 0
+    for o in objs:
+        o.x = o.y
+        s += o.x
+    return s
+print(f([A(i, i * 2) for i in range(10)] + [a3]))
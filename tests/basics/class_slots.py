@@ -0,0 +1,114 @@
+# test classes with __slots__
+
+class A:
+    __slots__ = ()
+try:
+    A().x = 1
+except AttributeError:
+    pass
+else:
+    print("SKIP")
+    raise SystemExit
+
+class Point:
+    __slots__ = ('x', 'y')
+
+    def __init__(self, x, y):
+        self.x = x
+        self.y = y
+
+p = Point(1, 2)
+print(p.x, p.y)
+p.x += 10
+print(p.x, p.y)
+
+# only the slots can be assigned
+try:
+    p.z = 3
+except AttributeError:
+    print('AttributeError')
+
+# an unassigned slot has no value
+del p.y
+try:
+    p.y
+except AttributeError:
+    print('AttributeError')
+try:
+    del p.y
+except AttributeError:
+    print('AttributeError')
+p.y = 4
+print(p.x, p.y)
+
+# no __dict__
+print(hasattr(p, '__dict__'))
+
+# a single slot given as a string
+class C:
+    __slots__ = 'a'
+c = C()
+c.a = 5
+print(c.a)
+
+# subclasses with and without their own __slots__
+class Point3(Point):
+    __slots__ = ('z',)
+
+    def __init__(self, x, y, z):
+        super().__init__(x, y)
+        self.z = z
+
+p3 = Point3(1, 2, 3)
+print(p3.x, p3.y, p3.z)
+try:
+    p3.w = 4
+except AttributeError:
+    print('AttributeError')
+
+class PointAny(Point):
+    pass
+
+pa = PointAny(1, 2)
+pa.w = 3
+print(pa.x, pa.y, pa.w)
+
+# __dict__ in __slots__ allows other attributes
+class D:
+    __slots__ = ('a', '__dict__')
+d = D()
+d.a = 1
+d.b = 2
+print(d.a, d.b)
+
+# methods and properties of the class still work
+class E:
+    __slots__ = ('_v',)
+
+    def __init__(self):
+        self._v = 0
+
+    def inc(self):
+        self._v += 1
+        return self._v
+
+    @property
+    def v(self):
+        return self._v
+
+e = E()
+e.inc()
+print(e.inc(), e.v)
+
+# multiple bases, whose layouts must extend one another
+class F(Point3, Point):
+    __slots__ = ('f',)
+f = F(1, 2, 3)
+f.f = 4
+print(f.x, f.y, f.z, f.f)
+
+try:
+    class G(Point, E):
+        pass
+except TypeError:
+    print('TypeError')
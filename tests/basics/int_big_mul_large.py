@@ -0,0 +1,24 @@
+# test multiplication and squaring of large integers, with sizes on both sides
+# of the threshold for Karatsuba multiplication
+
+def check(a, b):
+    # verify the product against (a+b)^2 - (a-b)^2 == 4ab, and print a digest
+    p = a * b
+    print(p % 1000000007, (a + b) * (a + b) - (a - b) * (a - b) == 4 * p, len(hex(p)))
+
+for bits in (100, 500, 1000, 1030, 2047, 3000, 10000):
+    a = (1 << bits) // 3
+    b = (1 << bits) - 1
+    check(a, b)
+    check(a, -a)
+    check(b, b)
+    check(a, (1 << (bits // 3)) // 7)
+    check(b, (1 << (bits * 2)) // 11)
+
+# 3-arg pow with large odd, even and negative moduli
+x = (1 << 2048) // 3 | 1
+y = (1 << 2000) // 7
+for m in (x, x + 1, -x, (1 << 1024) + 1, 3):
+    print(pow(y, x - 2, m) % 1000000007)
+    print(pow(-y, 65537, m) % 1000000007)
+    print(pow(y + 5 * m, 3, m) == pow(y, 3, m))
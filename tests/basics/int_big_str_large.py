@@ -0,0 +1,19 @@
+# test conversion of large integers to and from strings, with sizes on both
+# sides of the threshold for splitting the conversion (CPython limits this to
+# 4300 digits by default)
+
+for n in (100, 620, 700, 1300, 2500, 4000):
+    for x in (10 ** n, 10 ** n - 1, 7 ** (n * 100 // 85), -(2 ** (n * 3)) // 3):
+        s = str(x)
+        print(len(s), s[:20], s[-20:], int(s) == x)
+        print(int(hex(x), 16) == x, int(oct(x), 8) == x, int(bin(x), 2) == x)
+        print(hex(x)[-20:], '{:,}'.format(x)[-20:])
+
+# other bases, and leading zeros
+print(int('12' * 1000, 3) % 1000000007)
+print(int('zy' * 1000, 36) % 1000000007)
+print(int('0' * 1000 + '9' * 1000) == 10 ** 1000 - 1)
+
+# thousands separators
+print('{:,}'.format(123), '{:,}'.format(1234), '{:,}'.format(-123456))
+print('{:,}'.format(10 ** 30), '{:,}'.format(-10 ** 32))
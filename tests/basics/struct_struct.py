@@ -0,0 +1,70 @@
+# test ustruct.Struct
+
+try:
+    import ustruct as struct
+except:
+    try:
+        import struct
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+try:
+    struct.Struct
+except AttributeError:
+    print("SKIP")
+    raise SystemExit
+
+s = struct.Struct('<hHb3s2I')
+print(s.size, s.format)
+b = s.pack(-2, 3, 4, b'ab', 5, 6)
+print(b)
+print(s.unpack(b))
+print(s.unpack_from(b'xx' + b, 2))
+print(s.unpack_from(b + b'xx'))
+
+# pack_into, with negative offset
+buf = bytearray(s.size + 4)
+s.pack_into(buf, 2, 1, 2, 3, b'xyz', 4, 5)
+print(buf)
+s.pack_into(buf, -s.size, 1, 2, 3, b'xyz', 4, 5)
+print(buf)
+
+# native alignment is from the start of the structure
+s = struct.Struct('bi')
+print(s.size == struct.calcsize('bi'))
+print(s.unpack(s.pack(1, 2)))
+
+# big endian and empty format
+print(struct.Struct('>I').pack(0x01020304))
+print(struct.Struct('!h').unpack(b'\xff\xfe'))
+s = struct.Struct('')
+print(s.size, s.pack(), s.unpack(b''))
+
+# iter_unpack
+s = struct.Struct('<BH')
+for v in s.iter_unpack(b'\x01\x02\x00\x03\x04\x00'):
+    print(v)
+print(list(s.iter_unpack(b'')))
+
+# errors; CPython raises struct.error
+error = getattr(struct, 'error', ValueError)
+try:
+    s.pack(1)
+except (ValueError, error):
+    print('ValueError')
+try:
+    s.pack_into(bytearray(2), 0, 1, 2)
+except (ValueError, error):
+    print('ValueError')
+try:
+    s.unpack_from(b'12', 0)
+except (ValueError, error):
+    print('ValueError')
+try:
+    s.iter_unpack(b'1234')
+except (ValueError, error):
+    print('ValueError')
+try:
+    struct.Struct('2')
+except (ValueError, error):
+    print('ValueError')
@@ -8,3 +8,57 @@ def run(f):
     f(ITERS)
     t = time.time() - t
     print(t)
+
+# Memory benchmarks report heap bytes used per object, for N objects created by
+# f and still referenced when it returns.
+N_OBJS = 10000
+
+def run_mem(f):
+    import gc
+    gc.collect()
+    m = gc.mem_free()
+    objs = f(N_OBJS)
+    gc.collect()
+    print((m - gc.mem_free()) / N_OBJS)
+
+# Peak memory benchmarks report the most heap bytes still in use while the
+# items of the iterable returned by f(N_OBJS) are consumed one at a time.
+def run_peak(f):
+    import gc
+    gc.collect()
+    m = gc.mem_free()
+    peak = 0
+    for x in f(N_OBJS):
+        gc.collect()
+        peak = max(peak, m - gc.mem_free())
+    print(peak)
+
+# Ratio benchmarks report the size of the output of f relative to its input,
+# for f returning both sizes.
+def run_ratio(f):
+    out_len, in_len = f()
+    print(out_len / in_len)
+
+# CPU benchmarks report the processor time used by f, which spends most of
+# its time waiting.  This needs /proc/self/stat, so is for Linux only.
+def run_cpu(f):
+    def cpu():
+        with open('/proc/self/stat') as st:
+            fields = st.read().split()
+        return int(fields[13]) + int(fields[14])
+    c = cpu()
+    f(ITERS)
+    print((cpu() - c) / 100)
+
+# Allocation benchmarks report the heap bytes allocated per item, for f
+# handling N_OBJS // 10 items with the garbage collector disabled; this is
+# what makes the collector run in a long lived program.
+def run_alloc(f):
+    import gc
+    n = N_OBJS // 10
+    gc.collect()
+    gc.disable()
+    m = gc.mem_alloc()
+    f(n)
+    print((gc.mem_alloc() - m) / n)
+    gc.enable()
@@ -0,0 +1,9 @@
+# Parsing a 1000-digit decimal string to an integer
+import bench
+
+def test(num):
+    s = "1234567890" * (1000 // 10)
+    for i in iter(range(num // 10000)):
+        int(s)
+
+bench.run(test)
@@ -0,0 +1,9 @@
+# Parsing a 100000-digit decimal string to an integer
+import bench
+
+def test(num):
+    s = "1234567890" * (100000 // 10)
+    for i in iter(range(num // 5000000)):
+        int(s)
+
+bench.run(test)
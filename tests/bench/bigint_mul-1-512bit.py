@@ -0,0 +1,11 @@
+# Multiplying and squaring 512-bit integers
+import bench
+
+def test(num):
+    a = (1 << 512) // 3
+    b = (1 << 512) // 7
+    for i in iter(range(num // 64)):
+        a * b
+        a * a
+
+bench.run(test)
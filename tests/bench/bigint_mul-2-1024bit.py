@@ -0,0 +1,11 @@
+# Multiplying and squaring 1024-bit integers
+import bench
+
+def test(num):
+    a = (1 << 1024) // 3
+    b = (1 << 1024) // 7
+    for i in iter(range(num // 128)):
+        a * b
+        a * a
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Multiplying and squaring 2048-bit integers
+import bench
+
+def test(num):
+    a = (1 << 2048) // 3
+    b = (1 << 2048) // 7
+    for i in iter(range(num // 256)):
+        a * b
+        a * a
+
+bench.run(test)
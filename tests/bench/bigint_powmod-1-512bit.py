@@ -0,0 +1,12 @@
+# Modular exponentiation with a 512-bit odd modulus and a full-size exponent, as
+# for an RSA private key operation
+import bench
+
+def test(num):
+    m = (1 << 512) // 3 | 1
+    x = (1 << 512) // 7
+    e = m - 2
+    for i in iter(range(num // (512 * 512 // 8))):
+        pow(x, e, m)
+
+bench.run(test)
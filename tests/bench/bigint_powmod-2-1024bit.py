@@ -0,0 +1,12 @@
+# Modular exponentiation with a 1024-bit odd modulus and a full-size exponent, as
+# for an RSA private key operation
+import bench
+
+def test(num):
+    m = (1 << 1024) // 3 | 1
+    x = (1 << 1024) // 7
+    e = m - 2
+    for i in iter(range(num // (1024 * 1024 // 8))):
+        pow(x, e, m)
+
+bench.run(test)
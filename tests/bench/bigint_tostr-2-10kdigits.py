@@ -0,0 +1,9 @@
+# Converting a 10000-digit integer to a decimal string
+import bench
+
+def test(num):
+    x = 7 ** (10000 * 100 // 85)
+    for i in iter(range(num // 200000)):
+        str(x)
+
+bench.run(test)
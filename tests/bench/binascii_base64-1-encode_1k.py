@@ -0,0 +1,11 @@
+# Base64-encoding 1KB with ubinascii.b2a_base64
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 4
+
+def test(num):
+    for i in iter(range(num // 300)):
+        ubinascii.b2a_base64(DATA)
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Base64-encoding 64KB with ubinascii.b2a_base64
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 256
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.b2a_base64(DATA)
+
+bench.run(test)
@@ -0,0 +1,15 @@
+# Base64-encoding 1MB, 48KB at a time into one buffer with
+# ubinascii.b2a_base64_into, as when streaming it to a server
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 4096
+OUT = bytearray(65537)
+
+def test(num):
+    data = memoryview(DATA)
+    for i in iter(range(num // 300000)):
+        for j in range(0, len(DATA), 49152):
+            ubinascii.b2a_base64_into(data[j:j + 49152], OUT)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# Base64-encoding 64KB into a preallocated buffer with ubinascii.b2a_base64_into
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 256
+OUT = bytearray(len(ubinascii.b2a_base64(DATA)))
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.b2a_base64_into(DATA, OUT)
+
+bench.run(test)
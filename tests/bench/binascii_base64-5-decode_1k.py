@@ -0,0 +1,11 @@
+# Base64-decoding 1KB of data with ubinascii.a2b_base64
+import bench
+import ubinascii
+
+DATA = ubinascii.b2a_base64(bytes(range(256)) * 4)
+
+def test(num):
+    for i in iter(range(num // 300)):
+        ubinascii.a2b_base64(DATA)
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Base64-decoding 64KB of data with ubinascii.a2b_base64
+import bench
+import ubinascii
+
+DATA = ubinascii.b2a_base64(bytes(range(256)) * 256)
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.a2b_base64(DATA)
+
+bench.run(test)
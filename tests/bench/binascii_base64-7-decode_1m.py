@@ -0,0 +1,18 @@
+# Base64-decoding 1MB of data, 64KB at a time into one buffer with
+# ubinascii.a2b_base64_into, as when streaming it from a server
+import bench
+import ubinascii
+
+CHUNK = ubinascii.b2a_base64(bytes(range(256)) * 192)[:-1]
+DATA = bytearray(21 * len(CHUNK))
+for i in range(21):
+    DATA[i * len(CHUNK):(i + 1) * len(CHUNK)] = CHUNK
+OUT = bytearray(49152)
+
+def test(num):
+    data = memoryview(DATA)
+    for i in iter(range(num // 300000)):
+        for j in range(0, len(DATA), 65536):
+            ubinascii.a2b_base64_into(data[j:j + 65536], OUT)
+
+bench.run(test)
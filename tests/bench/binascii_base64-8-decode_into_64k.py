@@ -0,0 +1,13 @@
+# Base64-decoding 64KB of data into a preallocated buffer with
+# ubinascii.a2b_base64_into
+import bench
+import ubinascii
+
+DATA = ubinascii.b2a_base64(bytes(range(256)) * 256)
+OUT = bytearray(65536)
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.a2b_base64_into(DATA, OUT)
+
+bench.run(test)
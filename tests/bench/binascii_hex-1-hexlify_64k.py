@@ -0,0 +1,11 @@
+# Hex-encoding 64KB with ubinascii.hexlify
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 256
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.hexlify(DATA)
+
+bench.run(test)
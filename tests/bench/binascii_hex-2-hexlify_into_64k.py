@@ -0,0 +1,12 @@
+# Hex-encoding 64KB into a preallocated buffer with ubinascii.hexlify_into
+import bench
+import ubinascii
+
+DATA = bytes(range(256)) * 256
+OUT = bytearray(2 * len(DATA))
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.hexlify_into(DATA, OUT)
+
+bench.run(test)
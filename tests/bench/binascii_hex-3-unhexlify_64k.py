@@ -0,0 +1,11 @@
+# Hex-decoding 64KB of data with ubinascii.unhexlify
+import bench
+import ubinascii
+
+DATA = ubinascii.hexlify(bytes(range(256)) * 256)
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.unhexlify(DATA)
+
+bench.run(test)
@@ -0,0 +1,13 @@
+# Hex-decoding 64KB of data into a preallocated buffer with
+# ubinascii.unhexlify_into
+import bench
+import ubinascii
+
+DATA = ubinascii.hexlify(bytes(range(256)) * 256)
+OUT = bytearray(65536)
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.unhexlify_into(DATA, OUT)
+
+bench.run(test)
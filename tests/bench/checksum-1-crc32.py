@@ -0,0 +1,12 @@
+# CRC32 of 64KB with ubinascii.crc32
+import bench
+import corpus
+import ubinascii
+
+DATA = corpus.text()
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        ubinascii.crc32(DATA)
+
+bench.run(test)
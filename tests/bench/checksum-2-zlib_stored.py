@@ -0,0 +1,24 @@
+# Decompressing 64KB of stored zlib data, which is mostly the Adler-32 check
+import bench
+import corpus
+import uzlib
+
+def stored(data):
+    out = bytearray()
+    for i in range(0, len(data), 65535):
+        block = data[i:i + 65535]
+        n = len(block)
+        out.append(i + n == len(data))
+        out.extend(bytes((n & 0xff, n >> 8, ~n & 0xff, ~n >> 8 & 0xff)))
+        out.extend(block)
+    return out
+
+TEXT = corpus.text()
+# the Adler-32 trailer is the same whatever the compressed data
+DATA = b'\x78\x01' + stored(TEXT) + uzlib.compress(TEXT)[-4:]
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        uzlib.decompress(DATA)
+
+bench.run(test)
@@ -0,0 +1,24 @@
+# Decompressing 64KB of stored gzip data, which is mostly the CRC32 check
+import bench
+import corpus
+import uzlib
+
+def stored(data):
+    out = bytearray()
+    for i in range(0, len(data), 65535):
+        block = data[i:i + 65535]
+        n = len(block)
+        out.append(i + n == len(data))
+        out.extend(bytes((n & 0xff, n >> 8, ~n & 0xff, ~n >> 8 & 0xff)))
+        out.extend(block)
+    return out
+
+TEXT = corpus.text()
+# the CRC32 and size trailer is the same whatever the compressed data
+DATA = b'\x1f\x8b\x08\x00\x00\x00\x00\x00\x00\xff' + stored(TEXT) + uzlib.compress(TEXT, 6, 31)[-8:]
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        uzlib.decompress(DATA, 31)
+
+bench.run(test)
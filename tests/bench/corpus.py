@@ -0,0 +1,23 @@
+# Reference corpus for the compression benchmarks: 64KB of log lines and
+# JSON telemetry, like a device would upload, generated deterministically.
+
+WORDS = (b'wifi', b'connected', b'sensor', b'temp', b'humidity', b'retry',
+    b'timeout', b'mqtt', b'publish', b'ok', b'error', b'battery', b'low', b'boot')
+
+def text(size=65536):
+    out = bytearray()
+    x = 1
+    t = 0
+    while len(out) < size:
+        x = (x * 1103515245 + 12345) & 0x7fffffff
+        t += x % 1000
+        if x & 0x100:
+            out.extend(b'%d.%03d I ' % (t // 1000, t % 1000))
+            for i in range(2 + x % 5):
+                out.extend(WORDS[(x >> (3 * i + 9)) % len(WORDS)])
+                out.extend(b' ')
+            out.extend(b'\n')
+        else:
+            out.extend(b'{"t": %d, "temp": %d.%d, "rh": %d, "v": %d}\n'
+                % (t, 15 + x % 20, x % 10, 30 + (x >> 8) % 50, 3000 + (x >> 4) % 1200))
+    return bytes(out[:size])
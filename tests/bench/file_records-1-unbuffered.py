@@ -0,0 +1,16 @@
+# Writing and then reading back 16 byte records in an unbuffered file
+import bench
+import uos
+
+def test(num):
+    rec = b'0123456789abcde\n'
+    n = num // 200
+    with open('file_records.tmp', 'wb', buffering=0) as f:
+        for i in iter(range(n)):
+            f.write(rec)
+    with open('file_records.tmp', 'rb', buffering=0) as f:
+        for i in iter(range(n)):
+            f.read(16)
+    uos.unlink('file_records.tmp')
+
+bench.run(test)
@@ -0,0 +1,17 @@
+# Writing and then reading back 16 byte records in a file opened with the
+# default buffering
+import bench
+import uos
+
+def test(num):
+    rec = b'0123456789abcde\n'
+    n = num // 200
+    with open('file_records.tmp', 'wb') as f:
+        for i in iter(range(n)):
+            f.write(rec)
+    with open('file_records.tmp', 'rb') as f:
+        for i in iter(range(n)):
+            f.read(16)
+    uos.unlink('file_records.tmp')
+
+bench.run(test)
@@ -0,0 +1,10 @@
+# Formatting 1M floats with repr
+import bench
+
+def test(num):
+    vals = [7.0 / (i + 3) * 10.0 ** (i % 40 - 20) for i in range(1000)]
+    for i in iter(range(num // 20000)):
+        for x in vals:
+            repr(x)
+
+bench.run(test)
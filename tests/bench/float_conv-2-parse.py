@@ -0,0 +1,10 @@
+# Parsing 1M floats from their repr
+import bench
+
+def test(num):
+    strs = [repr(7.0 / (i + 3) * 10.0 ** (i % 40 - 20)) for i in range(1000)]
+    for i in iter(range(num // 20000)):
+        for s in strs:
+            float(s)
+
+bench.run(test)
@@ -0,0 +1,13 @@
+import bench
+
+class Reading:
+
+    def __init__(self, t, x, y):
+        self.t = t
+        self.x = x
+        self.y = y
+
+def test(num):
+    return [Reading(i, 0, 0) for i in range(num)]
+
+bench.run_mem(test)
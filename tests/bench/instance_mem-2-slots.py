@@ -0,0 +1,14 @@
+import bench
+
+class Reading:
+    __slots__ = ('t', 'x', 'y')
+
+    def __init__(self, t, x, y):
+        self.t = t
+        self.x = x
+        self.y = y
+
+def test(num):
+    return [Reading(i, 0, 0) for i in range(num)]
+
+bench.run_mem(test)
@@ -0,0 +1,10 @@
+# Serialising a 10000 record payload to a str with ujson.dumps
+import bench
+import ujson
+
+def test(num):
+    data = [{"id": i, "name": "sensor", "ok": True} for i in range(10000)]
+    for i in iter(range(num // 1000000)):
+        ujson.dumps(data)
+
+bench.run(test)
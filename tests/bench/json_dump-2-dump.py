@@ -0,0 +1,11 @@
+# Serialising a 10000 record payload to a stream with ujson.dump
+import bench
+import uio
+import ujson
+
+def test(num):
+    data = [{"id": i, "name": "sensor", "ok": True} for i in range(10000)]
+    for i in iter(range(num // 1000000)):
+        ujson.dump(data, uio.BytesIO())
+
+bench.run(test)
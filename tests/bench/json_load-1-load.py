@@ -0,0 +1,12 @@
+# Parsing a large array of records in one go with ujson.load
+import bench
+import uio
+import ujson
+
+def test(num):
+    data = b"[" + b",".join(b'{"id":%d,"name":"sensor","value":12.5,"ok":true}' % i for i in range(1000)) + b"]"
+    for i in iter(range(num // 200000)):
+        for rec in ujson.load(uio.BytesIO(data)):
+            pass
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# Peak heap use of ujson.iterload on an array of 1000 records
+import bench
+import uio
+import ujson
+
+DATA = bytearray(b"[")
+for i in range(1000):
+    DATA.extend(b'{"id":%d,"name":"sensor","value":12.5,"ok":true},' % i)
+DATA[-1] = ord("]")
+
+def test(num):
+    return ujson.iterload(uio.BytesIO(DATA), (None,))
+
+bench.run_peak(test)
@@ -0,0 +1,42 @@
+# Line oriented data for the readline benchmarks: n lines of 64 bytes, in a
+# file, or sent by a thread over a loopback TCP connection.
+import uos
+import usocket as socket
+import _thread
+
+FILE = 'readline_data.tmp'
+LINE = b'%063d\n'
+
+def make_file(n):
+    with open(FILE, 'wb') as f:
+        for i in range(n):
+            f.write(LINE % i)
+
+def remove_file():
+    uos.unlink(FILE)
+
+def send(s, n):
+    chunk = b''.join(LINE % i for i in range(64))
+    for i in range(n // 64):
+        while True:
+            try:
+                s.write(chunk)
+                break
+            except OSError:
+                # interrupted by a garbage collection in the main thread
+                pass
+    s.close()
+
+# Returns the receiving socket of a connection over which n lines are sent
+def connect(n):
+    addr = socket.getaddrinfo('127.0.0.1', 8132)[0][-1]
+    s = socket.socket()
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(addr)
+    s.listen(1)
+    a = socket.socket()
+    a.connect(addr)
+    b = s.accept()[0]
+    s.close()
+    _thread.start_new_thread(send, (a, n))
+    return b
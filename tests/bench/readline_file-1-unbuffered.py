@@ -0,0 +1,13 @@
+# Reading lines from a file with the file's own readline
+import bench
+import readline_data
+
+def test(num):
+    n = num // 1000
+    readline_data.make_file(n)
+    with open(readline_data.FILE, 'rb') as f:
+        for l in f:
+            pass
+    readline_data.remove_file()
+
+bench.run(test)
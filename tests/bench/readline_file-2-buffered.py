@@ -0,0 +1,14 @@
+# Reading lines from a file through uio.BufferedReader
+import bench
+import uio
+import readline_data
+
+def test(num):
+    n = num // 1000
+    readline_data.make_file(n)
+    with open(readline_data.FILE, 'rb') as f:
+        for l in uio.BufferedReader(f, 4096):
+            pass
+    readline_data.remove_file()
+
+bench.run(test)
@@ -0,0 +1,11 @@
+# Reading lines from a loopback TCP connection with the socket's readline
+import bench
+import readline_data
+
+def test(num):
+    s = readline_data.connect(num // 1000)
+    while s.readline():
+        pass
+    s.close()
+
+bench.run(test)
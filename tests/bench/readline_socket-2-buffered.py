@@ -0,0 +1,12 @@
+# Reading lines from a loopback TCP connection through uio.BufferedReader
+import bench
+import uio
+import readline_data
+
+def test(num):
+    s = readline_data.connect(num // 1000)
+    for l in uio.BufferedReader(s, 4096):
+        pass
+    s.close()
+
+bench.run(test)
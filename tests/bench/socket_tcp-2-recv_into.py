@@ -0,0 +1,23 @@
+# Receiving 64 byte messages into a buffer over a loopback TCP connection
+import bench
+import usocket as socket
+
+def test(num):
+    addr = socket.getaddrinfo('127.0.0.1', 8128)[0][-1]
+    s = socket.socket()
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(addr)
+    s.listen(1)
+    a = socket.socket()
+    a.connect(addr)
+    b = s.accept()[0]
+    msg = b'x' * 64
+    buf = bytearray(64)
+    for i in iter(range(num // 200)):
+        a.send(msg)
+        b.recv_into(buf)
+    a.close()
+    b.close()
+    s.close()
+
+bench.run(test)
@@ -0,0 +1,22 @@
+# Sending and receiving 64 byte UDP datagrams over loopback in batches of
+# 16, with send_many and recv_many
+import bench
+import usocket as socket
+
+def test(num):
+    addr = socket.getaddrinfo('127.0.0.1', 8128)[0][-1]
+    a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    a.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    a.bind(addr)
+    b = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    b.connect(addr)
+    msgs = [b'x' * 64] * 16
+    bufs = [bytearray(64) for i in range(16)]
+    sizes = [0] * 16
+    for i in iter(range(num // 3200)):
+        b.send_many(msgs)
+        a.recv_many(bufs, sizes)
+    a.close()
+    b.close()
+
+bench.run(test)
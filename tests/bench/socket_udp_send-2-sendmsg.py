@@ -0,0 +1,22 @@
+# Sending UDP datagrams made of a header and a payload, with sendmsg
+import bench
+import usocket as socket
+
+def test(num):
+    addr = socket.getaddrinfo('127.0.0.1', 8128)[0][-1]
+    a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    a.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    a.bind(addr)
+    b = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    b.connect(addr)
+    msg = b'x' * 64
+    hdr = b'h' * 8
+    bufs = [hdr, msg]
+    buf = bytearray(64)
+    for i in iter(range(num // 200)):
+        b.sendmsg(bufs)
+        a.recv_into(buf)
+    a.close()
+    b.close()
+
+bench.run(test)
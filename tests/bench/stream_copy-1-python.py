@@ -0,0 +1,17 @@
+# Copying a file to a socket with a readinto/write loop
+import bench
+from stream_copy import run, BUFSIZE
+
+def send(f, s):
+    buf = bytearray(BUFSIZE)
+    mv = memoryview(buf)
+    while True:
+        n = f.readinto(buf)
+        if not n:
+            break
+        s.write(mv[:n])
+
+def test(num):
+    run(num // 200000, send)
+
+bench.run(test)
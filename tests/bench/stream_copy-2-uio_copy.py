@@ -0,0 +1,12 @@
+# Copying a file to a socket with uio.copy
+import bench
+import uio
+from stream_copy import run, BUFSIZE
+
+def send(f, s):
+    uio.copy(f, s, bufsize=BUFSIZE)
+
+def test(num):
+    run(num // 200000, send)
+
+bench.run(test)
@@ -0,0 +1,45 @@
+# Serving a 10MB file over a loopback TCP connection, for the stream_copy
+# benchmarks; send(f, s) copies the open file to the socket, and a thread
+# reads everything at the other end.
+import uos
+import usocket as socket
+import _thread
+
+FILE = 'stream_copy.tmp'
+SIZE = 10 * 1024 * 1024
+BUFSIZE = 4096
+
+def drain(s, n, lock):
+    buf = bytearray(65536)
+    while n > 0:
+        try:
+            n -= s.recv_into(buf)
+        except OSError:
+            # interrupted by a garbage collection in the main thread
+            pass
+    lock.release()
+
+def run(num, send):
+    with open(FILE, 'wb') as f:
+        chunk = b'x' * BUFSIZE
+        for i in range(SIZE // BUFSIZE):
+            f.write(chunk)
+    addr = socket.getaddrinfo('127.0.0.1', 8131)[0][-1]
+    s = socket.socket()
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(addr)
+    s.listen(1)
+    a = socket.socket()
+    a.connect(addr)
+    b = s.accept()[0]
+    lock = _thread.allocate_lock()
+    lock.acquire()
+    _thread.start_new_thread(drain, (b, num * SIZE, lock))
+    for i in range(num):
+        with open(FILE, 'rb') as f:
+            send(f, a)
+    lock.acquire()
+    a.close()
+    b.close()
+    s.close()
+    uos.unlink(FILE)
@@ -0,0 +1,11 @@
+# Unpacking a record using the module-level function, parsing the format each time
+import bench
+import ustruct
+
+def test(num):
+    buf = ustruct.pack("<HhIb3s", 1, 2, 3, 4, b"abc")
+    unpack = ustruct.unpack
+    for i in iter(range(num // 20)):
+        unpack("<HhIb3s", buf)
+
+bench.run(test)
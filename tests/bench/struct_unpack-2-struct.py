@@ -0,0 +1,12 @@
+# Unpacking a record using a precompiled Struct
+import bench
+import ustruct
+
+def test(num):
+    s = ustruct.Struct("<HhIb3s")
+    buf = s.pack(1, 2, 3, 4, b"abc")
+    unpack = s.unpack
+    for i in iter(range(num // 20)):
+        unpack(buf)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# Unpacking a buffer of records using Struct.iter_unpack
+import bench
+import ustruct
+
+def test(num):
+    s = ustruct.Struct("<HhIb3s")
+    buf = s.pack(1, 2, 3, 4, b"abc") * 1000
+    for i in iter(range(num // 20000)):
+        for v in s.iter_unpack(buf):
+            pass
+
+bench.run(test)
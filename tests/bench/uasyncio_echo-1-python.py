@@ -0,0 +1,45 @@
+# Echoing 1KB messages between two tasks over a loopback TCP connection
+import bench
+import usocket as socket
+from uasyncio_loops import PyLoop as Loop
+
+MSG = b'x' * 1024
+
+def echo(loop, s, n):
+    n *= len(MSG)
+    while n:
+        yield loop.wait_read(s)
+        data = s.recv(4096)
+        n -= len(data)
+        yield loop.wait_write(s)
+        s.send(data)
+
+def client(loop, s, n):
+    for i in range(n):
+        yield loop.wait_write(s)
+        s.send(MSG)
+        got = 0
+        while got < len(MSG):
+            yield loop.wait_read(s)
+            got += len(s.recv(4096))
+
+def test(num):
+    ls = socket.socket()
+    ls.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    ls.bind(socket.getaddrinfo('127.0.0.1', 8126)[0][-1])
+    ls.listen(1)
+    a = socket.socket()
+    a.connect(socket.getaddrinfo('127.0.0.1', 8126)[0][-1])
+    b = ls.accept()[0]
+    a.setblocking(False)
+    b.setblocking(False)
+    n = num // 1000
+    loop = Loop(16)
+    loop.call_soon(echo(loop, b, n))
+    loop.call_soon(client(loop, a, n))
+    loop.run()
+    a.close()
+    b.close()
+    ls.close()
+
+bench.run(test)
@@ -0,0 +1,70 @@
+# Event loops for the uasyncio benchmarks, with the same API: a pure Python
+# one built on utimeq and uselect.poll, and a thin layer over _uasyncio.
+# Tasks yield None to let others run, and the result of wait_read/wait_write
+# to wait for a stream.
+import utime
+import utimeq
+import uselect
+
+class PyLoop:
+
+    def __init__(self, n):
+        self.q = utimeq.utimeq(n)
+        self.poller = uselect.poll()
+        self.io = {}
+        self.cur = None
+
+    def call_soon(self, cb):
+        self.q.push(utime.ticks_ms(), cb, None)
+
+    def wait_read(self, s):
+        self.io[id(s)] = self.cur
+        self.poller.register(s, uselect.POLLIN)
+        return False
+
+    def wait_write(self, s):
+        self.io[id(s)] = self.cur
+        self.poller.register(s, uselect.POLLOUT)
+        return False
+
+    def run(self):
+        q = self.q
+        cur = [0, 0, 0]
+        while True:
+            while q and utime.ticks_diff(q.peektime(), utime.ticks_ms()) <= 0:
+                q.pop(cur)
+                cb = self.cur = cur[1]
+                try:
+                    ret = cb.send(cur[2])
+                except StopIteration:
+                    continue
+                if ret is None:
+                    q.push(utime.ticks_ms(), cb, None)
+                elif ret is not False:
+                    q.push(utime.ticks_add(utime.ticks_ms(), ret), cb, None)
+            if q:
+                delay = max(0, utime.ticks_diff(q.peektime(), utime.ticks_ms()))
+            elif self.io:
+                delay = -1
+            else:
+                return
+            if self.io:
+                for s, ev in self.poller.ipoll(delay, 1):
+                    q.push(utime.ticks_ms(), self.io.pop(id(s)), ev)
+            else:
+                utime.sleep_ms(delay)
+
+class CoreLoop:
+
+    def __init__(self, n):
+        import _uasyncio
+        core = _uasyncio.Loop(n, n)
+        self.call_soon = core.call_soon
+        self.run = core.run
+        self.wait_io = core.wait_io
+
+    def wait_read(self, s):
+        return self.wait_io(s, uselect.POLLIN)
+
+    def wait_write(self, s):
+        return self.wait_io(s, uselect.POLLOUT)
@@ -0,0 +1,15 @@
+# Switching between 10 tasks which only yield
+import bench
+from uasyncio_loops import PyLoop as Loop
+
+def task(n):
+    for i in range(n):
+        yield
+
+def test(num):
+    loop = Loop(16)
+    for i in iter(range(10)):
+        loop.call_soon(task(num // 200))
+    loop.run()
+
+bench.run(test)
@@ -0,0 +1,27 @@
+# Field access on a uctypes struct using a compiled descriptor
+import bench
+import uctypes
+
+desc = {
+    "s0": uctypes.UINT16 | 0,
+    "sub": (0, {
+        "b0": uctypes.UINT8 | 0,
+        "b1": uctypes.UINT8 | 1,
+    }),
+    "arr": (uctypes.ARRAY | 0, uctypes.UINT8 | 2),
+    "bitf0": uctypes.BFUINT16 | 0 | 0 << uctypes.BF_POS | 8 << uctypes.BF_LEN,
+    "bitf1": uctypes.BFUINT16 | 0 | 8 << uctypes.BF_POS | 8 << uctypes.BF_LEN,
+    "reg0": uctypes.UINT32 | 4,
+    "reg1": uctypes.UINT32 | 8,
+    "reg2": uctypes.UINT32 | 12,
+}
+
+def test(num):
+    data = bytearray(16)
+    S = uctypes.struct(uctypes.addressof(data), uctypes.compile(desc), uctypes.LITTLE_ENDIAN)
+    for i in iter(range(num // 20)):
+        S.reg0 = S.s0 + S.bitf1
+        S.sub.b0 = S.reg2 & 0xff
+        S.arr[1] = S.bitf0
+
+bench.run(test)
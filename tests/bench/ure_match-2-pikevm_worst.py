@@ -0,0 +1,11 @@
+# Worst case for a backtracking matcher, run by the Pike VM
+import bench
+import ure
+
+def test(num):
+    r = ure.compile("(a|aa)*c", ure.PIKEVM)
+    s = "a" * 20
+    for i in iter(range(num // 100000)):
+        r.match(s)
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# Typical log filter rule, run by the Pike VM
+import bench
+import ure
+
+def test(num):
+    r = ure.compile("ERROR: (\\w+) code=(\\d+)", ure.PIKEVM)
+    lines = [
+        "2017-11-02 12:00:01 INFO: sensor read ok value=%d" % i for i in range(8)
+    ] + ["2017-11-02 12:00:02 ERROR: sensor timeout code=17"]
+    for i in iter(range(num // 2000)):
+        for l in lines:
+            r.search(l)
+
+bench.run(test)
@@ -0,0 +1,16 @@
+# Tokenising a bytes buffer of key=value pairs by re-slicing the subject for each search
+import bench
+import ure
+
+def test(num):
+    r = ure.compile(b"[a-z]+=[0-9]+")
+    data = b" ".join(b"key%s=%d" % (chr(97 + i % 26), i) for i in range(200))
+    for i in iter(range(num // 20000)):
+        s = data
+        while True:
+            m = r.search(s)
+            if m is None:
+                break
+            s = s[len(m.group(0)) + s.find(m.group(0)):]
+
+bench.run(test)
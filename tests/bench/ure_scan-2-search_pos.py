@@ -0,0 +1,16 @@
+# Tokenising a bytes buffer of key=value pairs by searching from pos and using span, without slicing
+import bench
+import ure
+
+def test(num):
+    r = ure.compile(b"[a-z]+=[0-9]+")
+    data = b" ".join(b"key%s=%d" % (chr(97 + i % 26), i) for i in range(200))
+    for i in iter(range(num // 20000)):
+        pos = 0
+        while True:
+            m = r.search(data, pos)
+            if m is None:
+                break
+            pos = m.end()
+
+bench.run(test)
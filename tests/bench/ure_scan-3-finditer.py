@@ -0,0 +1,12 @@
+# Tokenising a bytes buffer of key=value pairs by finditer
+import bench
+import ure
+
+def test(num):
+    r = ure.compile(b"[a-z]+=[0-9]+")
+    data = b" ".join(b"key%s=%d" % (chr(97 + i % 26), i) for i in range(200))
+    for i in iter(range(num // 20000)):
+        for m in r.finditer(data):
+            pass
+
+bench.run(test)
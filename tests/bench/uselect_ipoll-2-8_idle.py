@@ -0,0 +1,38 @@
+# One active connection among 8 idle local ones, polled with uselect.ipoll
+import bench
+import usocket
+import uselect
+
+N_IDLE = 8
+
+def pair(s, addr):
+    a = usocket.socket()
+    a.connect(addr)
+    return a, s.accept()[0]
+
+def test(num):
+    addr = usocket.getaddrinfo('127.0.0.1', 8126)[0][-1]
+    s = usocket.socket()
+    s.setsockopt(usocket.SOL_SOCKET, usocket.SO_REUSEADDR, 1)
+    s.bind(addr)
+    s.listen(16)
+    p = uselect.poll()
+    idle = []
+    for i in range(N_IDLE):
+        c = pair(s, addr)
+        p.register(c[1], uselect.POLLIN)
+        idle.append(c)
+    a, b = pair(s, addr)
+    p.register(b, uselect.POLLIN)
+    for i in iter(range(num // 2000)):
+        a.send(b'x')
+        for obj, ev in p.ipoll(1000):
+            obj.recv(1)
+    for c in idle:
+        c[0].close()
+        c[1].close()
+    a.close()
+    b.close()
+    s.close()
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# CPU used while the generic uselect.poll waits on 500 idle streams (unix coverage build,
+# which provides stest_notify)
+import bench
+import _uselect_generic as uselect
+
+def test(num):
+    p = uselect.poll()
+    objs = [stest_notify() for i in range(500)]
+    for o in objs:
+        p.register(o, uselect.POLLIN)
+    for i in iter(range(num // 10000000)):
+        p.poll(1000)
+
+bench.run_cpu(test)
@@ -0,0 +1,37 @@
+# Round trips between two threads which wake each other up through streams
+# registered with the generic uselect.poll, among 500 idle ones (unix coverage build,
+# which provides stest_notify)
+import bench
+import _uselect_generic as uselect
+import _thread
+
+def poller(obj):
+    p = uselect.poll()
+    for i in range(500):
+        p.register(stest_notify(), uselect.POLLIN)
+    p.register(obj, uselect.POLLIN)
+    return p
+
+def echo(n, a, b, done):
+    p = poller(b)
+    for i in range(n):
+        p.poll()
+        b.set_ready(0)
+        a.set_ready(uselect.POLLIN)
+    done.release()
+
+def test(num):
+    n = num // 2000
+    a = stest_notify()
+    b = stest_notify()
+    p = poller(a)
+    done = _thread.allocate_lock()
+    done.acquire()
+    _thread.start_new_thread(echo, (n, a, b, done))
+    for i in iter(range(n)):
+        b.set_ready(uselect.POLLIN)
+        p.poll()
+        a.set_ready(0)
+    done.acquire()
+
+bench.run(test)
@@ -0,0 +1,14 @@
+# Downloading from a local TLS server with read(), which allocates a new
+# bytes object per call
+import bench
+import ussl_server
+
+def test(num):
+    ussl_server.start(2, www=True)
+    s = ussl_server.get(num // 2)
+    while s.read(4096):
+        pass
+    s.close()
+    ussl_server.remove_data()
+
+bench.run(test)
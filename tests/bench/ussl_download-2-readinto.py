@@ -0,0 +1,15 @@
+# Downloading from a local TLS server with readinto(), which decrypts into
+# one preallocated buffer
+import bench
+import ussl_server
+
+def test(num):
+    ussl_server.start(2, www=True)
+    s = ussl_server.get(num // 2)
+    buf = bytearray(4096)
+    while s.readinto(buf):
+        pass
+    s.close()
+    ussl_server.remove_data()
+
+bench.run(test)
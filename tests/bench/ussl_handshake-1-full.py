@@ -0,0 +1,13 @@
+# TLS connections to a local server, each with a full handshake
+import bench
+import ussl
+import ussl_server
+
+def test(num):
+    n = num // 200000
+    ussl_server.start(n + 1)
+    for i in range(n):
+        s = ussl.wrap_socket(ussl_server.connect(), server_hostname='localhost')
+        s.close()
+
+bench.run(test)
@@ -0,0 +1,19 @@
+# TLS connections to a local server, each resuming the session of the
+# previous one with an abbreviated handshake
+import bench
+import ussl
+import ussl_server
+
+def test(num):
+    n = num // 200000
+    ussl_server.start(n + 2)
+    s = ussl.wrap_socket(ussl_server.connect(), server_hostname='localhost')
+    session = s.session
+    s.close()
+    for i in range(n):
+        s = ussl.wrap_socket(ussl_server.connect(), server_hostname='localhost', session=session)
+        # the server may have issued a new ticket
+        session = s.session
+        s.close()
+
+bench.run(test)
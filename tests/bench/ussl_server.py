@@ -0,0 +1,52 @@
+# A local TLS server for the ussl benchmarks: openssl s_server on a loopback
+# port, with a throwaway EC key and self-signed certificate.  It supports
+# both session IDs and session tickets, and exits after n connections.
+# With www it serves files from the current directory to HTTP GET requests.
+import uos
+import usocket as socket
+import ussl
+import utime
+
+PORT = 8133
+KEY = 'ussl_server.key'
+CERT = 'ussl_server.crt'
+DATA = 'ussl_data.tmp'
+
+def start(n, www=False):
+    uos.system('openssl req -x509 -newkey ec -pkeyopt ec_paramgen_curve:prime256v1 '
+        '-nodes -subj /CN=localhost -days 1 -keyout %s -out %s 2>/dev/null' % (KEY, CERT))
+    uos.system('openssl s_server -accept %d -key %s -cert %s -naccept %d -quiet %s'
+        '</dev/null >/dev/null 2>&1 &' % (PORT, KEY, CERT, n, '-WWW ' if www else ''))
+    # wait until the server is listening, which uses up one connection
+    while True:
+        s = socket.socket()
+        try:
+            s.connect(addr())
+            break
+        except OSError:
+            utime.sleep_ms(10)
+        finally:
+            s.close()
+    uos.unlink(KEY)
+    uos.unlink(CERT)
+
+def addr():
+    return socket.getaddrinfo('127.0.0.1', PORT)[0][-1]
+
+def connect():
+    s = socket.socket()
+    s.connect(addr())
+    return s
+
+# Connects over TLS and requests a file of n bytes, created for the purpose
+def get(n):
+    with open(DATA, 'wb') as f:
+        chunk = bytes(4096)
+        for i in range(n // 4096):
+            f.write(chunk)
+    s = ussl.wrap_socket(connect(), server_hostname='localhost')
+    s.write(('GET /%s HTTP/1.0\r\n\r\n' % DATA).encode())
+    return s
+
+def remove_data():
+    uos.unlink(DATA)
@@ -0,0 +1,12 @@
+# Compressing 64KB of logs and telemetry with uzlib.compress at level 1
+import bench
+import corpus
+import uzlib
+
+DATA = corpus.text()
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        uzlib.compress(DATA, 1)
+
+bench.run(test)
@@ -0,0 +1,12 @@
+# Compressing 64KB of logs and telemetry with uzlib.compress at level 9
+import bench
+import corpus
+import uzlib
+
+DATA = corpus.text()
+
+def test(num):
+    for i in iter(range(num // 200000)):
+        uzlib.compress(DATA, 9)
+
+bench.run(test)
@@ -0,0 +1,17 @@
+# Compressing 64KB of logs and telemetry through uzlib.CompressIO with a 1KB
+# window, in 512 byte writes
+import bench
+import corpus
+import uio
+import uzlib
+
+DATA = corpus.text()
+
+def test(num):
+    for i in iter(range(num // 40000)):
+        z = uzlib.CompressIO(uio.BytesIO(), 10)
+        for j in range(0, len(DATA), 512):
+            z.write(DATA[j:j + 512])
+        z.close()
+
+bench.run(test)
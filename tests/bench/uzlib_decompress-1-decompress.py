@@ -0,0 +1,12 @@
+# Decompressing 64KB of logs and telemetry with uzlib.decompress
+import bench
+import corpus
+import uzlib
+
+DATA = uzlib.compress(corpus.text())
+
+def test(num):
+    for i in iter(range(num // 20000)):
+        uzlib.decompress(DATA)
+
+bench.run(test)
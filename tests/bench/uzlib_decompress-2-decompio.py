@@ -0,0 +1,17 @@
+# Decompressing 64KB of logs and telemetry compressed with a 1KB window,
+# through uzlib.DecompIO in 4KB reads
+import bench
+import corpus
+import uio
+import uzlib
+
+DATA = uzlib.compress(corpus.text(), 6, 10)
+
+def test(num):
+    buf = bytearray(4096)
+    for i in iter(range(num // 100000)):
+        z = uzlib.DecompIO(uio.BytesIO(DATA))
+        while z.readinto(buf):
+            pass
+
+bench.run(test)
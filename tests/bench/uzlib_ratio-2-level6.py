@@ -0,0 +1,10 @@
+# Compressed size of 64KB of logs and telemetry with uzlib.compress at level 6
+import bench
+import corpus
+import uzlib
+
+def test():
+    data = corpus.text()
+    return len(uzlib.compress(data, 6)), len(data)
+
+bench.run_ratio(test)
@@ -0,0 +1,17 @@
+# Compressed size of 64KB of logs and telemetry through uzlib.CompressIO with a
+# 1KB window, in 512 byte writes
+import bench
+import corpus
+import uio
+import uzlib
+
+def test():
+    data = corpus.text()
+    buf = uio.BytesIO()
+    z = uzlib.CompressIO(buf, 10)
+    for j in range(0, len(data), 512):
+        z.write(data[j:j + 512])
+    z.close()
+    return len(buf.getvalue()), len(data)
+
+bench.run_ratio(test)
@@ -0,0 +1,15 @@
+import bench
+
+class Foo:
+    __slots__ = ('num',)
+
+    def __init__(self):
+        self.num = 20000000
+
+def test(num):
+    o = Foo()
+    i = 0
+    while i < o.num:
+        i += 1
+
+bench.run(test)
@@ -0,0 +1,108 @@
+# test the event loop core of uasyncio
+
+try:
+    import _uasyncio
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+loop = _uasyncio.Loop(8, 8)
+
+def task(name, n):
+    for i in range(n):
+        print(name, i, loop.cur_task() is t[name])
+        yield
+
+t = {}
+for name in ("a", "b"):
+    t[name] = task(name, 3)
+    loop.call_soon(t[name])
+loop.call_soon(print, "callback")
+loop.call_soon(print)
+print(loop.run())
+print(loop.cur_task())
+
+# sleeping, in order of wake up time
+def sleeper(ms):
+    yield ms
+    print("slept", ms)
+
+for ms in (30, 10, 20, 0):
+    loop.call_soon(sleeper(ms))
+loop.call_later_ms(15, print, "later")
+loop.run()
+
+# values sent to a task, and parking it
+def parked():
+    print("got", (yield False))
+    print("got", (yield False))
+
+p = parked()
+loop.call_soon(p)
+loop.run()
+loop.call_soon(p, 1)
+loop.run()
+loop.call_later_ms(1, p, 2)
+loop.run()
+
+# stop
+def stopper():
+    yield
+    print("stop")
+    loop.stop()
+    yield
+    print("resumed")
+
+loop.call_soon(stopper())
+loop.run()
+print("stopped")
+loop.run()
+
+# errors
+def raiser():
+    yield
+    raise ValueError("task")
+
+loop.call_soon(raiser())
+try:
+    loop.run()
+except ValueError as e:
+    print("ValueError", e)
+
+def bad():
+    yield "x"
+
+loop.call_soon(bad())
+try:
+    loop.run()
+except TypeError:
+    print("TypeError")
+
+try:
+    loop.wait_io(None, 1)
+except RuntimeError:
+    print("RuntimeError")
+
+for args in ((0, 1), (-1, 1), (1, 0), (1, -1)):
+    try:
+        _uasyncio.Loop(*args)
+    except ValueError:
+        print("ValueError")
+
+l = _uasyncio.Loop(1, 1)
+l.call_soon(print)
+try:
+    l.call_soon(print)
+except IndexError:
+    print("IndexError")
+
+# a raising callback is no longer the current task
+def cb_raiser():
+    raise ValueError("cb")
+
+loop.call_soon(cb_raiser)
+try:
+    loop.run()
+except ValueError as e:
+    print("ValueError", e)
+print(loop.cur_task())
@@ -0,0 +1,60 @@
+# test waiting for streams with the event loop core of uasyncio
+
+try:
+    import _uasyncio
+    import usocket as socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+POLLIN = 1
+POLLOUT = 4
+
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(socket.getaddrinfo('127.0.0.1', 8125)[0][-1])
+s.listen(1)
+a = socket.socket()
+a.connect(socket.getaddrinfo('127.0.0.1', 8125)[0][-1])
+b = s.accept()[0]
+a.setblocking(False)
+b.setblocking(False)
+
+loop = _uasyncio.Loop(8, 8)
+
+def reader(sock, n):
+    for i in range(n):
+        ev = yield loop.wait_io(sock, POLLIN)
+        print("read", ev & POLLIN, sock.recv(10))
+
+def writer(sock, n):
+    for i in range(n):
+        yield 10
+        ev = yield loop.wait_io(sock, POLLOUT)
+        print("write", ev & POLLOUT)
+        sock.send(b"x%d" % i)
+
+loop.call_soon(reader(b, 3))
+loop.call_soon(writer(a, 3))
+loop.run()
+
+# a reader and a writer on the same stream
+loop.call_soon(reader(a, 1))
+loop.call_soon(writer(a, 1))
+loop.call_soon(reader(b, 1))
+loop.call_later_ms(50, b.send, b"y")
+loop.run()
+
+# a callback instead of a task
+loop.wait_io(a, POLLOUT, lambda ev: print("callback", ev & POLLOUT))
+loop.run()
+
+# removed streams are no longer waited for
+loop.call_soon(reader(a, 1))
+loop.call_later_ms(10, loop.remove_io, a)
+loop.run()
+print("done")
+
+a.close()
+b.close()
+s.close()
@@ -44,3 +44,14 @@ try:
     print(binascii.a2b_base64(b'ab=cdef='))
 except ValueError:
     print("ValueError")
+try:
+    print(binascii.a2b_base64(b'abcdefg'))
+except ValueError:
+    print("ValueError")
+
+# Line breaks and invalid characters in and between groups of 4
+data = bytes(range(256))
+enc = binascii.b2a_base64(data)
+print(binascii.a2b_base64(b'\n'.join([enc[i:i + 76] for i in range(0, len(enc), 76)])) == data)
+print(binascii.a2b_base64(b'\n'.join([enc[i:i + 7] for i in range(0, len(enc), 7)])) == data)
+print(binascii.a2b_base64(b'Zm9v*YmFy\x80Zm9vYmE='))
@@ -22,3 +22,9 @@ print(hex(binascii.crc32(b' over the lazy dog', binascii.crc32(b'The quick brown
 print(hex(binascii.crc32(b'\x00' * 16, binascii.crc32(b'\x00' * 16))))
 print(hex(binascii.crc32(b'\xff' * 16, binascii.crc32(b'\xff' * 16))))
 print(hex(binascii.crc32(bytes(range(16, 32)), binascii.crc32(bytes(range(16))))))
+
+# lengths and alignments around the sizes computed at a time
+data = bytes([(i * 7 + 3) & 0xff for i in range(80)])
+for n in (0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 33, 71):
+    print(n, [hex(binascii.crc32(memoryview(data)[i:i + n])) for i in range(4)])
+print(hex(binascii.crc32(b'\xff' * 1000)))
@@ -0,0 +1,45 @@
+try:
+    import ubinascii as binascii
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+if not hasattr(binascii, "b2a_base64_into"):
+    print("SKIP")
+    raise SystemExit
+
+buf = bytearray(16)
+
+for data in (b'', b'f', b'fo', b'foo', b'foob', b'\x00\xff\x10'):
+    n = binascii.b2a_base64_into(data, buf)
+    print(n, buf[:n])
+    m = binascii.a2b_base64_into(buf[:n], memoryview(buf)[8:])
+    print(m, buf[8:8 + m])
+    n = binascii.hexlify_into(data, buf)
+    print(n, buf[:n])
+    print(binascii.unhexlify_into(buf[:n], memoryview(buf)[12:]), buf[12:12 + len(data)])
+
+# separator, as hexlify
+print(binascii.hexlify_into(b'\x01\x02\x03', buf, ':'), buf[:8])
+
+# decoding can be done in place
+buf = bytearray(b'Zm9vYmFy\n')
+n = binascii.a2b_base64_into(buf, buf)
+print(buf[:n])
+buf = bytearray(b'0a0B0c')
+n = binascii.unhexlify_into(buf, buf)
+print(buf[:n])
+
+# the output has to fit
+for f, data in ((binascii.b2a_base64_into, b'abcd'), (binascii.a2b_base64_into, b'Zm9vYmFy'),
+        (binascii.hexlify_into, b'abcd'), (binascii.unhexlify_into, b'0011223344')):
+    try:
+        f(data, bytearray(4))
+    except ValueError as e:
+        print(e)
+
+# and the output has to be writable
+try:
+    binascii.b2a_base64_into(b'abc', b'1234')
+except TypeError:
+    print("TypeError")
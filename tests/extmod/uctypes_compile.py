@@ -0,0 +1,70 @@
+# test uctypes.compile, accessing fields through a compiled descriptor
+try:
+    import uctypes
+    uctypes.compile
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+desc = {
+    "s0": uctypes.UINT16 | 0,
+    "sub": (0, {
+        "b0": uctypes.UINT8 | 0,
+        "b1": uctypes.UINT8 | 1,
+    }),
+    "arr": (uctypes.ARRAY | 0, uctypes.UINT8 | 2),
+    "arr2": (uctypes.ARRAY | 0, 2, {"b": uctypes.UINT8 | 0}),
+    "arr3": (uctypes.ARRAY | 0, uctypes.UINT16 | 1),
+    "bitf0": uctypes.BFUINT16 | 0 | 0 << uctypes.BF_POS | 8 << uctypes.BF_LEN,
+    "bitf1": uctypes.BFUINT16 | 0 | 8 << uctypes.BF_POS | 8 << uctypes.BF_LEN,
+    "bf3": uctypes.BFUINT16 | 0 | 12 << uctypes.BF_POS | 4 << uctypes.BF_LEN,
+    "ptr": (uctypes.PTR | 0, uctypes.UINT8),
+}
+
+cdesc = uctypes.compile(desc)
+print(uctypes.compile(cdesc) is cdesc)
+print(uctypes.sizeof(cdesc) == uctypes.sizeof(desc))
+
+data = bytearray(b"01")
+for layout in (uctypes.LITTLE_ENDIAN, uctypes.BIG_ENDIAN, uctypes.NATIVE):
+    S = uctypes.struct(uctypes.addressof(data), desc, layout)
+    C = uctypes.struct(uctypes.addressof(data), cdesc, layout)
+    print(uctypes.sizeof(C) == uctypes.sizeof(S))
+    print(C.s0 == S.s0, C.bitf0 == S.bitf0, C.bitf1 == S.bitf1, C.bf3 == S.bf3)
+    print(C.sub.b0, C.sub.b1)
+    print(C.arr, C.arr[0], C.arr[1])
+    print(C.arr2[0].b, C.arr2[1].b)
+    print(C.arr3[0] == S.arr3[0])
+
+# nested aggregates are created once per struct object
+C = uctypes.struct(uctypes.addressof(data), cdesc, uctypes.LITTLE_ENDIAN)
+print(C.sub is C.sub, C.arr is C.arr)
+
+# write access
+C.sub.b0 = ord("2")
+print(data)
+C.bf3 = 5
+print(data)
+C.s0 = 0x3433
+print(data)
+C.arr[0] = ord("x")
+print(data)
+
+# unknown field
+try:
+    C.foo
+except KeyError:
+    print("KeyError")
+
+# aggregate can't be assigned
+try:
+    C.sub = 1
+except TypeError:
+    print("TypeError")
+
+# bad descriptors
+for d in (1, {"a": "b"}, {"a": (0, 1)}):
+    try:
+        uctypes.compile(d)
+    except TypeError:
+        print("TypeError")
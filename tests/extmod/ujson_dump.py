@@ -0,0 +1,41 @@
+try:
+    from uio import StringIO
+    import ujson as json
+except:
+    try:
+        from io import StringIO
+        import json
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+s = StringIO()
+json.dump(False, s)
+print(s.getvalue())
+
+s = StringIO()
+json.dump({"a": (2, [3, None])}, s)
+print(s.getvalue())
+
+# integers and strings that need escaping
+s = StringIO()
+json.dump([-1, 0, 12345, 'a"b\\c\nd\x01e', [], {}], s)
+print(s.getvalue())
+
+# output larger than the internal write buffer
+s = StringIO()
+obj = [{"id": i, "name": "x" * (i % 40)} for i in range(50)]
+json.dump(obj, s)
+print(s.getvalue() == json.dumps(obj), len(s.getvalue()))
+
+# long strings, with and without characters that need escaping
+s = StringIO()
+obj = ["y" * 1000, "z\t" * 500]
+json.dump(obj, s)
+print(s.getvalue() == json.dumps(obj), len(s.getvalue()))
+
+# dump to something that isn't a stream
+try:
+    json.dump(1, 2)
+except (AttributeError, OSError):
+    print('Exception')
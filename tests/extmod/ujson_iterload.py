@@ -0,0 +1,68 @@
+# test ujson.iterload, which has no CPython equivalent
+try:
+    from uio import StringIO, BytesIO
+    import ujson
+    ujson.iterload
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+doc = '{"meta": {"a": 1, "b": [true, null]}, "results": [{"id": 1, "v": [1, 2]}, {"id": 2, "v": []}], "count": 2}'
+
+# dicts are printed as sorted lists of items, so the output doesn't depend on
+# their order
+def norm(o):
+    if isinstance(o, dict):
+        return sorted([(k, norm(v)) for k, v in o.items()])
+    if isinstance(o, (list, tuple)):
+        return type(o)([norm(v) for v in o])
+    return o
+
+def test(path):
+    print(path, norm(list(ujson.iterload(StringIO(doc), path))))
+
+# whole document
+print(norm(list(ujson.iterload(StringIO(doc)))))
+test(())
+
+# members of the top level object, as (key, value) pairs
+test((None,))
+test(1)
+
+# selection by key and index
+test(("results",))
+test(("results", None))
+test(("results", 1))
+test(("results", None, "id"))
+test(("results", None, "v", None))
+test(("meta", None))
+test(("missing", None))
+test(("count", None))
+
+# top-level array and primitive, bytes stream
+print(norm(list(ujson.iterload(BytesIO(b' [1, "two", [3], {"four": 4}] '), 1))))
+print(list(ujson.iterload(BytesIO(b'5'), 1)))
+print(list(ujson.iterload(BytesIO(b'5'))))
+
+# a stream that spans many reads of the internal buffer
+s = '[' + ','.join(['{"k": "%s", "n": %d}' % ("x" * (i % 50), i) for i in range(100)]) + ']'
+print(sum([d["n"] for d in ujson.iterload(StringIO(s), 1)]))
+print(sum([n for n in ujson.iterload(StringIO(s), (None, "n"))]))
+
+# the iterator can be abandoned early
+it = ujson.iterload(StringIO(s), 1)
+print(norm(next(it)), norm(next(it)))
+
+# malformed documents
+for d in ('[1, 2', '[1] 2', '{1: 2}', '{"a"}', '', '[nul]', ']'):
+    try:
+        print(list(ujson.iterload(StringIO(d), 1)))
+    except ValueError:
+        print('ValueError')
+
+# bad paths
+for p in ((1.5,), (b'a',), -1):
+    try:
+        ujson.iterload(StringIO(doc), p)
+    except (TypeError, ValueError) as e:
+        print(type(e).__name__)
@@ -13,3 +13,9 @@ print(json.load(StringIO('null')))
 print(json.load(StringIO('"abc\\u0064e"')))
 print(json.load(StringIO('[false, true, 1, -2]')))
 print(json.load(StringIO('{"a":true}')))
+
+# a str is not a stream
+try:
+    json.load('[1]')
+except (AttributeError, OSError):
+    print('error')
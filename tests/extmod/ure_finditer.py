@@ -0,0 +1,38 @@
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print('SKIP')
+        raise SystemExit
+
+try:
+    re.finditer
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+print([m.group(0) for m in re.finditer('[0-9]+', 'ab12cd345e')])
+print([m.group(1) for m in re.compile('([a-z])[0-9]').finditer('a1b2cc3')])
+
+# empty matches
+print([m.group(0) for m in re.finditer('x*', 'axb')])
+print([m.group(0) for m in re.finditer('x*', '')])
+
+# no match
+print([m.group(0) for m in re.finditer('z', 'abc')])
+
+# matches are independent of each other
+ms = list(re.finditer('b(.)', 'abcbdb'))
+print([m.group(1) for m in ms])
+
+# pos and endpos
+r = re.compile('b')
+print([m.group(0) for m in r.finditer('abcbdb', 2)])
+print([m.group(0) for m in r.finditer('abcbdb', 0, 4)])
+print([m.group(0) for m in r.finditer('abcbdb', 4, 2)])
+
+# bytes and other buffers
+print([m.group(0) for m in re.finditer(b'[a-c]+', b'abxcd')])
+print([m.group(0) for m in re.finditer(b'[a-c]+', memoryview(b'abxcd'))])
@@ -0,0 +1,63 @@
+# test the non-backtracking matchers selected by ure.PIKEVM and ure.DFA
+try:
+    import ure
+    ure.PIKEVM
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+def groups(m):
+    if m is None:
+        return None
+    g = []
+    try:
+        while True:
+            g.append(m.group(len(g)))
+    except IndexError:
+        pass
+    return g
+
+tests = (
+    ('a|b', ('a', 'b', 'c')),
+    ('(a|ab)(c|bcd)(d*)', ('abcd', 'abcde')),
+    ('a(b+?)(b*)', ('abbb',)),
+    ('(a*)(a+)', ('aaaa',)),
+    ('([a-c]+)x|\\d\\d', ('bbx', 'b12', 'x12y')),
+    ('^ab$', ('ab', 'abc', 'cab')),
+    ('[^x]+', ('xxabx',)),
+    ('(?:ab)+', ('ababa',)),
+    ('', ('', 'a')),
+    ('^$', ('', 'a')),
+    ('\\w+\\s\\S', ('foo bar', '  ')),
+)
+for pat, subjects in tests:
+    r0 = ure.compile(pat)
+    r1 = ure.compile(pat, ure.PIKEVM)
+    r2 = ure.compile(pat, ure.DFA)
+    for s in subjects:
+        for fn in ('match', 'search'):
+            res = [groups(getattr(r, fn)(s)) for r in (r0, r1, r2)]
+            print(pat, repr(s), fn, res[0], res[0] == res[1] == res[2])
+
+# split uses the selected matcher too
+print(ure.compile('[,;]', ure.DFA).split('a,b;c'))
+
+# patterns that overflow the backtracking matcher, or take exponential time
+print(groups(ure.compile('(a*)*', ure.PIKEVM).match('aaa')))
+print(groups(ure.compile('(b?)*c$', ure.DFA).search('abbc')))
+print(groups(ure.compile('(a|aa)*c', ure.PIKEVM).match('a' * 40)))
+print(groups(ure.compile('(a|aa)*c', ure.DFA).search('a' * 40 + 'c')))
+print(len(ure.compile('(ab)*', ure.PIKEVM).match('ab' * 2000).group(0)))
+
+# the DFA is reused across subjects, including ones that need new states
+r = ure.compile('(a|b)*a(a|b)(a|b)(a|b)(a|b)c', ure.DFA)
+for s in ('abababc', 'aaaaac', 'babbbbc', 'ab' * 20 + 'c', 'b' * 10):
+    print(s, groups(r.search(s)))
+
+# a cache filled by some subjects is flushed for others, which still match
+words = 'abcd efgh ijkl mnop qrst uvwx yzAB CDEF GHIJ KLMN'.split()
+r = ure.compile('X(' + '|'.join(words) + ')Y', ure.DFA)
+for w in words[:7]:
+    r.search('..X' + w + 'Y..')
+res = [r.search('some text X' + words[7 + i % 3] + ('Y' if i % 2 else 'Z')) for i in range(60)]
+print([m and m.group(1) for m in res[:6]], sum([m is not None for m in res]))
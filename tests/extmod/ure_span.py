@@ -0,0 +1,48 @@
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print('SKIP')
+        raise SystemExit
+
+try:
+    m = re.match('.', 'a')
+    m.span
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+m = re.search('(a)|(b)', 'xxb')
+print(m.span(), m.start(), m.end())
+print(m.span(1), m.start(1), m.end(1))
+print(m.span(2), m.start(2), m.end(2))
+try:
+    m.span(3)
+except IndexError:
+    print('IndexError')
+
+# positions count chars in a str
+m = re.search('é(.)', 'aaéxé')
+print(m.span(), m.span(1), m.group(1))
+
+# pos and endpos
+r = re.compile('b+')
+print(r.search('abbbcbb', 2).span())
+print(r.search('abbbcbb', 4).span())
+print(r.search('abbbcbb', 2, 3).span())
+print(r.search('abbbcbb', -5, 100).span())
+print(r.search('abbbcbb', 5, 3))
+print(r.match('abbbcbb', 1).group(0))
+print(r.match('abbbcbb', 0))
+
+# ^ only matches at the real start, $ matches at endpos
+print(re.compile('^a').search('aaa', 1))
+print(re.compile('a$').search('aaab', 0, 3).span())
+
+# bytes and other buffers
+m = re.search(b'c+', memoryview(b'abccd'))
+print(m.span(), m.group(0))
+m = re.compile(b'c+').search(bytearray(b'abccd'), 3)
+print(m.span(), m.group(0))
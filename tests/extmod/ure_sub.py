@@ -0,0 +1,47 @@
+try:
+    import ure as re
+except ImportError:
+    try:
+        import re
+    except ImportError:
+        print('SKIP')
+        raise SystemExit
+
+try:
+    re.sub
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+# group references in the replacement
+r = re.compile('(a)(b)?')
+print(r.sub('[\\1|\\2|\\g<0>]', 'xaabyab'))
+print(r.sub('\\g<2>\\g<1>', 'ab'))
+
+# callable replacement
+print(re.sub('[0-9]+', lambda m: str(int(m.group(0)) * 2), 'a1b22c333'))
+
+# count
+print(re.sub('b', 'B', 'abcbdb', 2))
+print(re.sub('b', 'B', 'abcbdb', 0))
+
+# empty matches
+print(re.sub('x*', '-', 'axbxx'))
+print(re.sub('a*', '-', 'baac'))
+print(re.sub('x*', '-', 'ax'))
+print(re.sub('x*', '-', ''))
+
+# no match
+print(re.sub('z', '-', 'abc'))
+
+# bytes and other buffers
+print(re.sub(b'b+', b'-', b'abbcb'))
+print(re.sub(b'b', b'x', bytearray(b'abc')))
+print(re.sub(b'b', b'x', memoryview(b'abc')))
+
+# bad group references
+for repl in ('\\3', '\\g<x>', '\\g<1'):
+    try:
+        re.sub('(a)', repl, 'a')
+    except:
+        print('Exception')
@@ -0,0 +1,63 @@
+# test uselect.poll.ipoll, and its one-shot flag
+try:
+    import usocket as socket, uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+def pair():
+    s = socket.socket()
+    s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    s.bind(socket.getaddrinfo('127.0.0.1', 8125)[0][-1])
+    s.listen(1)
+    a = socket.socket()
+    a.connect(socket.getaddrinfo('127.0.0.1', 8125)[0][-1])
+    b = s.accept()[0]
+    s.close()
+    return a, b
+
+a, b = pair()
+p = select.poll()
+p.register(b, select.POLLIN)
+a.send(b'x')
+
+# the same tuple is returned for each ready object
+for i in range(2):
+    for obj, ev in p.ipoll(1000):
+        print(obj is b, ev)
+
+# one-shot: polling for the object stops until it's modified
+for obj, ev in p.ipoll(1000, 1):
+    print(obj is b, ev)
+print(list(p.ipoll(0)))
+p.modify(b, select.POLLIN)
+print(len(list(p.ipoll(0))))
+b.recv(1)
+
+# an fd that was closed without being unregistered, and reused
+fd = b.fileno()
+b.close()
+a.close()
+a, b = pair()
+if b.fileno() != fd:
+    b, a = a, b
+print(b.fileno() == fd)
+print(p.register(b, select.POLLIN))
+a.send(b'y')
+print([ev for obj, ev in p.ipoll(1000)])
+a.close()
+b.close()
+
+# one-shot results for an fd that is closed while iterating over them
+a, b = pair()
+p = select.poll()
+p.register(a, select.POLLOUT)
+p.register(b, select.POLLOUT)
+n = 0
+for obj, ev in p.ipoll(1000, 1):
+    if n == 0:
+        (b if obj is a else a).close()
+    n += 1
+print(n)
+a.close()
+b.close()
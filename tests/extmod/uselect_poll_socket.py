@@ -0,0 +1,66 @@
+# test uselect.poll on connected sockets and a regular file
+try:
+    import usocket as socket, uselect as select, uos as os
+except ImportError:
+    try:
+        import socket, select, os
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+def fd(obj):
+    return obj if isinstance(obj, int) else obj.fileno()
+
+def show(res):
+    names = {fd(a): 'a', fd(b): 'b', fd(f): 'f'}
+    print(sorted([(names[fd(o)], ev) for o, ev in res]))
+
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(socket.getaddrinfo('127.0.0.1', 8124)[0][-1])
+s.listen(1)
+a = socket.socket()
+a.connect(socket.getaddrinfo('127.0.0.1', 8124)[0][-1])
+b = s.accept()[0]
+f = open('extmod/uselect_poll_socket.py', 'rb')
+
+p = select.poll()
+p.register(a, select.POLLIN)
+p.register(b, select.POLLIN)
+show(p.poll(0))
+
+# registering again changes the events
+p.register(a, select.POLLIN | select.POLLOUT)
+show(p.poll(0))
+
+b.send(b'x')
+show(p.poll(1000))
+a.recv(1)
+p.modify(a, select.POLLIN)
+show(p.poll(0))
+
+# a regular file is always ready
+p.register(f, select.POLLIN)
+show(p.poll())
+p.modify(f, 0)
+show(p.poll(0))
+p.unregister(f)
+
+a.send(b'y')
+show(p.poll(1000))
+p.unregister(b)
+show(p.poll(0))
+b.recv(1)
+
+# registered by fd, and the connection closed
+p.register(b.fileno(), select.POLLIN)
+p.unregister(a)
+a.close()
+res = p.poll(1000)
+print(len(res), type(res[0][0]), res[0][1] & select.POLLIN)
+
+p.unregister(b)
+print(len(p.poll(0)))
+b.close()
+s.close()
+f.close()
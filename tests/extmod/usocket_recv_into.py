@@ -0,0 +1,56 @@
+# test socket recv_into, recvfrom_into and sendmsg over loopback
+try:
+    import usocket as socket
+except ImportError:
+    try:
+        import socket
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+if not hasattr(socket.socket, 'recv_into'):
+    print("SKIP")
+    raise SystemExit
+
+addr = socket.getaddrinfo('127.0.0.1', 8127)[0][-1]
+
+# TCP
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(addr)
+s.listen(1)
+a = socket.socket()
+a.connect(addr)
+b = s.accept()[0]
+
+buf = bytearray(8)
+print(a.sendmsg([b'ab', b'', memoryview(b'xcdx')[1:3]]))
+print(b.recv_into(buf), buf)
+a.send(b'efghij')
+print(b.recv_into(buf, 2), buf)
+print(b.recv_into(memoryview(buf)[4:]), buf)
+try:
+    b.recv_into(buf, 9)
+except ValueError:
+    print('ValueError')
+a.close()
+b.close()
+s.close()
+
+# UDP, where the buffers make up one datagram
+a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+a.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+a.bind(addr)
+b = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+print(b.sendmsg([b'123', bytearray(b'45')], [], 0, addr))
+buf = bytearray(8)
+n, peer = a.recvfrom_into(buf)
+print(n, buf)
+b.sendto(b'6789', addr)
+n, peer = a.recvfrom_into(buf, 3)
+print(n, buf)
+b.connect(addr)
+print(b.sendmsg([b'x'] * 20))
+print(a.recv_into(buf), buf)
+a.close()
+b.close()
@@ -0,0 +1,35 @@
+# the checksums in the trailers of zlib and gzip streams
+try:
+    import zlib
+except ImportError:
+    try:
+        import uzlib as zlib
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+if not hasattr(zlib, "compress"):
+    print("SKIP")
+    raise SystemExit
+
+data = bytes([(i * 7 + 3) & 0xff for i in range(6000)])
+for n in (0, 1, 3, 4, 5, 63, 64, 65, 127, 128, 200, 5552, 5553, 6000):
+    print(n, zlib.compress(data[:n])[-4:], zlib.compress(data[:n], 6, 31)[-8:-4])
+
+# data not aligned to a word
+for i in range(1, 4):
+    print(i, zlib.compress(memoryview(data)[i:i + 200])[-4:])
+
+# the largest sums
+for n in (64, 5552, 5553, 20000):
+    print(n, zlib.compress(b'\xff' * n)[-4:], zlib.compress(b'\xff' * n, 6, 31)[-8:-4])
+
+# checksums are verified on decompression
+for wbits in (15, 31):
+    c = bytearray(zlib.compress(data, 6, wbits))
+    print(zlib.decompress(c, wbits) == data)
+    c[-1 if wbits == 15 else -8] ^= 1
+    try:
+        zlib.decompress(c, wbits)
+    except Exception:
+        print("error")
@@ -0,0 +1,37 @@
+try:
+    import zlib
+except ImportError:
+    try:
+        import uzlib as zlib
+    except ImportError:
+        print("SKIP")
+        raise SystemExit
+
+if not hasattr(zlib, "compress"):
+    print("SKIP")
+    raise SystemExit
+
+DATA = [
+    b'',
+    b'a',
+    b'hello',
+    b'0' * 100,
+    bytes(range(256)),
+    b'abc' * 2000,
+    b''.join([b'%d fox %d ' % (i % 13, i % 101) for i in range(1000)]),
+]
+
+for data in DATA:
+    for level in (0, 1, 6, 9):
+        c = zlib.compress(data, level)
+        print(len(data), level, zlib.decompress(c) == data)
+    for wbits in (9, 15, -9, -15, 25, 31):
+        c = zlib.compress(data, 6, wbits)
+        print(len(data), wbits, zlib.decompress(c, wbits) == data)
+
+# data longer than the window, repeating beyond it
+data = bytes([(i * 7) & 0xff for i in range(700)]) * 10
+print(zlib.decompress(zlib.compress(data, 9, 9)) == data)
+
+# compressed size for repetitive data
+print(len(zlib.compress(b'a' * 10000)) < 100)
@@ -0,0 +1,85 @@
+try:
+    import uzlib as zlib
+    import uio as io
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+if not hasattr(zlib, "CompressIO"):
+    print("SKIP")
+    raise SystemExit
+
+DATA = b''.join([b'%d fox %d ' % (i % 13, i % 101) for i in range(1000)])
+
+
+def compress(wbits, chunk, flush_every=0):
+    buf = io.BytesIO()
+    z = zlib.CompressIO(buf, wbits)
+    n = 0
+    for i in range(0, len(DATA), chunk):
+        z.write(DATA[i:i + chunk])
+        n += 1
+        if flush_every and n % flush_every == 0:
+            z.flush()
+    z.close()
+    return buf.getvalue()
+
+
+# zlib, gzip and raw framing, in small and large writes
+for wbits in (9, 10, 15, 25, -9):
+    for chunk in (1, 100, 10000):
+        c = compress(wbits, chunk)
+        print(wbits, chunk, zlib.decompress(c, wbits) == DATA)
+        print(zlib.DecompIO(io.BytesIO(c), wbits).read() == DATA)
+
+# flush makes everything written so far decompressable
+buf = io.BytesIO()
+z = zlib.CompressIO(buf)
+z.write(b'hello ')
+z.flush()
+inp = zlib.DecompIO(io.BytesIO(buf.getvalue()))
+print(inp.read(6))
+z.write(b'world')
+z.close()
+print(zlib.decompress(buf.getvalue()))
+
+# flushes in between and at the end
+c = compress(10, 50, 3)
+print(zlib.decompress(c) == DATA)
+z = zlib.CompressIO(io.BytesIO())
+z.flush()
+z.flush()
+z.close()
+
+# context manager closes the stream
+buf = io.BytesIO()
+with zlib.CompressIO(buf, 26) as z:
+    z.write(b'abc' * 100)
+print(zlib.decompress(buf.getvalue(), 26))
+
+# writing after close
+try:
+    z.write(b'x')
+except OSError:
+    print('OSError')
+z.close()
+
+# bad args
+for wbits in (8, 16, 24, 32, -8, -16):
+    try:
+        zlib.CompressIO(io.BytesIO(), wbits)
+    except ValueError:
+        print('ValueError')
+try:
+    zlib.compress(b'', 6, 8)
+except ValueError:
+    print('ValueError')
+for level in (-2, 10, 42):
+    try:
+        zlib.CompressIO(io.BytesIO(), 10, level)
+    except ValueError:
+        print('ValueError')
+    try:
+        zlib.compress(b'', level)
+    except ValueError:
+        print('ValueError')
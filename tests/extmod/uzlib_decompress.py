@@ -36,6 +36,23 @@ v = b'\xcbH\xcd\xc9\xc9\x07\x00\x86\xa6\x106\x05\x00\x00\x00'
 out = zlib.decompress(v, -15)
 assert(out == exp)
 
+# dynamic Huffman codes longer than 9 bits
+v = b'x\x01\x05\xc1\x89\x81$D\x10\x041\xdb\x14Y=\xb3\x87\x17\xfc\xf8o\x01\x12\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00@UUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUUU\xd5\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xb6m\xdb\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd\xdd{\xef\xbd\xf7\xde{\xef\xbd\xf7\xde{\xef\xbd\xf7\xde{\xef\xbd\xf7\xde\xe7\xf3\xf9|>\x9f\xcf\xe7\xf3\xf9|>\x9f\xcf\xf7\xfb\xfd~\xbf\xdf\xef\xcf\xcf\xcf\xcf\xaf_\xbf\xfd\xfe\xc7\x9f\x7f\xfd\xfd\xcf\xbf\xff\xfd\x0f\x95X\n\xe8'
+exp = b''.join([bytes([65 + k]) * (1 << (9 - k)) for k in range(10)]) + bytes(range(97, 105))
+print(zlib.decompress(v) == exp)
+
+# a fixed block after a dynamic one with distance codes of 6 bits
+v = b'x\x9c\x04\xfd\x01\t\x00!\x10\x000\xd4^\xfc\xdd\xdd\xdd\xdd\xdd\xa9\xfe\xff\xff\xff\xff\xff\xff\xff\xbb\n \xa8\x04\x00\t\xdf\x02\xd2'
+print(zlib.decompress(v) == b'xxxxxy')
+
+# truncated streams
+v = zlib.compress(b'hello world, hello world')
+for n in (1, 5, len(v) - 6, len(v) - 1):
+    try:
+        zlib.decompress(v[:n])
+    except Exception:
+        print("Exception")
+
 # this should error
 try:
     zlib.decompress(b'abc')
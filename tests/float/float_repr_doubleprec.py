@@ -0,0 +1,44 @@
+# test that repr of a float is the shortest string that reads back as the
+# same value, and that parsing rounds correctly; requires double precision
+
+try:
+    import ustruct as struct
+except ImportError:
+    import struct
+
+if repr(0.1 + 0.2) != '0.30000000000000004':
+    print('SKIP')
+    raise SystemExit
+
+# values needing 17 digits, exact halves, powers of 2 and the extremes
+for x in (0.1, 0.1 + 0.2, 1 / 3, 2 / 3, 5e-324, 2.2250738585072014e-308,
+    2.225073858507201e-308, 1.7976931348623157e308, 2 ** 53, 2 ** 53 + 2, 2 ** -1074,
+    9007199254740993.0, 1e15, 1e16, 1e22, 1e23, 0.0001, 0.00001, 123456.789,
+    -0.0, 5e-324 * 3, 1.5e300 * 1.5e-300, 100.0, 0.3, 4.35, 2.675):
+    print(repr(x), repr(-x))
+
+# strings that need more than 64 bits to round correctly
+for s in ('9007199254740993', '9007199254740992.9999999999999999999999',
+    '2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125e-324',
+    '2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125001e-324',
+    '1.7976931348623158e308', '1.7976931348623159e308', '8.98846567431158e307',
+    '4.9406564584124654e-324', '7.2057594037927933e16', '1e-400', '1e400',
+    '0.' + '0' * 300 + '1', '1' + '0' * 350, '123456789012345678901234567890e-40'):
+    print(repr(float(s)))
+
+# random bit patterns, including subnormals, should round-trip through repr
+seed = 1
+bad = 0
+for i in range(2000):
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff
+    hi = seed
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff
+    lo = seed
+    if i % 4 == 1:
+        hi &= 0x400fffff
+    b = struct.pack('<II', lo << 1 | hi & 1, hi << 1 & 0xffffffff | lo & 1)
+    x = struct.unpack('<d', b)[0]
+    if x == x and x - x == 0 and struct.pack('<d', float(repr(x))) != b:
+        print('failed to round-trip', b)
+        bad += 1
+print('bad', bad)
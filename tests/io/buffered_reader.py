@@ -0,0 +1,47 @@
+import uio as io
+
+try:
+    io.BytesIO
+    io.BufferedReader
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+data = b"line1\nline two\n\nlast line without newline"
+
+buf = io.BufferedReader(io.BytesIO(data), 8)
+print(buf.readline())
+print(buf.readline())
+print(buf.readline())
+print(buf.readline())
+print(buf.readline())
+
+# line size limit
+buf = io.BufferedReader(io.BytesIO(data), 4)
+print(buf.readline(3), buf.readline(3), buf.readline(0), buf.readline(-1))
+
+# iteration and readlines
+for l in io.BufferedReader(io.BytesIO(data), 5):
+    print(l)
+print(io.BufferedReader(io.BytesIO(data)).readlines())
+
+# reading mixed with lines
+buf = io.BufferedReader(io.BytesIO(data), 4)
+print(buf.read(2), buf.readline(), buf.read(3))
+b = bytearray(10)
+print(buf.readinto(b), b)
+print(buf.read())
+print(buf.read(1))
+
+# reads bigger than the buffer go straight to the stream
+buf = io.BufferedReader(io.BytesIO(data), 4)
+print(buf.read(1), buf.read(20))
+
+# peek doesn't consume data
+buf = io.BufferedReader(io.BytesIO(data), 4)
+print(buf.peek(), buf.peek(1), buf.read(2), buf.peek(), buf.read(3), buf.peek())
+
+try:
+    io.BufferedReader(io.BytesIO(), 0)
+except ValueError:
+    print("ValueError")
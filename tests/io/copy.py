@@ -0,0 +1,51 @@
+import uio as io
+
+try:
+    io.copy
+except AttributeError:
+    print('SKIP')
+    raise SystemExit
+
+src = io.BytesIO(b"0123456789" * 10)
+dst = io.BytesIO()
+print(io.copy(src, dst), dst.getvalue() == b"0123456789" * 10)
+print(io.copy(src, dst))
+
+# limited number of bytes, and a small buffer
+src = io.BytesIO(b"abcdefghij")
+dst = io.BytesIO()
+print(io.copy(src, dst, 4), dst.getvalue())
+print(io.copy(src, dst, bufsize=3), dst.getvalue())
+
+src.seek(0)
+print(io.copy(src, dst, 0), io.copy(src, dst, n=20, bufsize=1), dst.getvalue())
+
+# files, which may be copied by the OS
+try:
+    import uos as os
+except ImportError:
+    import os
+
+if hasattr(os, "unlink"):
+    with open("io/data/bigfile1", "rb") as f:
+        data = f.read()
+        f.seek(100)
+        with open("testfile", "wb") as g:
+            print(io.copy(f, g, 1000))
+            print(io.copy(f, g) == len(data) - 1100)
+    with open("testfile", "rb") as g:
+        print(g.read() == data[100:])
+    with open("testfile", "rb") as g:
+        dst = io.BytesIO()
+        print(io.copy(g, dst, 5), dst.getvalue() == data[100:105])
+    os.unlink("testfile")
+
+# errors
+try:
+    io.copy(1, dst)
+except OSError:
+    print("OSError")
+try:
+    io.copy(src, dst, bufsize=0)
+except ValueError:
+    print("ValueError")
@@ -0,0 +1,37 @@
+# test a non-blocking TLS handshake and resuming its session (mbedtls only)
+try:
+    import usocket as socket, ussl as ssl, uselect as select
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+HOST = "www.google.com"
+
+
+def connect(session=None):
+    s = socket.socket()
+    s.connect(socket.getaddrinfo(HOST, 443)[0][-1])
+    s.setblocking(False)
+    s = ssl.wrap_socket(s, server_hostname=HOST, session=session, do_handshake=False)
+    poller = select.poll()
+    poller.register(s, select.POLLIN | select.POLLOUT)
+    while not s.do_handshake():
+        poller.poll(5000)
+    return s
+
+
+try:
+    s = connect()
+except TypeError:
+    # wrap_socket() doesn't take do_handshake
+    print("SKIP")
+    raise SystemExit
+print(s.do_handshake())
+session = s.session
+print(type(session).__name__, s.session is session)
+s.close()
+
+# the session stays usable after its socket is closed
+s = connect(session)
+print(s.do_handshake(), s.session is not None)
+s.close()
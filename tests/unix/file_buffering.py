@@ -0,0 +1,104 @@
+# test buffering of files opened with open()
+try:
+    import uos as os
+except ImportError:
+    import os
+
+def size():
+    return os.stat("testfile")[6]
+
+# fully buffered by default
+f = open("testfile", "w")
+f.write("abc\n")
+print(size())
+f.flush()
+print(size())
+f.write("def")
+f.close()
+print(size())
+
+# unbuffered and line buffered
+f = open("testfile", "wb", buffering=0)
+f.write(b"ab")
+print(size())
+f.close()
+try:
+    open("testfile", "w", buffering=0)
+except ValueError:
+    print("ValueError")
+f = open("testfile", "w", buffering=1)
+f.write("ab")
+print(size())
+f.write("c\nd")
+print(size())
+f.close()
+
+# a small buffer
+f = open("testfile", "wb", buffering=4)
+f.write(b"12")
+f.write(b"345")
+print(size())
+f.write(b"123456")
+print(size())
+f.close()
+
+# reading, writing and seeking
+with open("testfile", "wb") as f:
+    f.write(b"0123456789" * 1000)
+f = open("testfile", "r+b", buffering=16)
+print(f.read(3), f.tell())
+f.write(b"abc")
+print(f.tell(), f.read(4))
+f.seek(-2, 1)
+print(f.read(3), f.tell())
+f.seek(0)
+print(f.read(10))
+f.seek(9990)
+f.write(b"xy")
+f.seek(9985)
+print(f.read())
+print(f.readline(), f.tell())
+f.close()
+
+# uio.copy sees buffered data
+try:
+    import uio
+    uio.copy
+except (ImportError, AttributeError):
+    uio = None
+if uio:
+    f = open("testfile", "rb")
+    print(f.read(2))
+    g = uio.BytesIO()
+    print(uio.copy(f, g, 5), g.getvalue())
+    f.close()
+    f = open("testfile", "r+b")
+    f.write(b"ABCD")
+    g = uio.BytesIO(b"EFG")
+    print(uio.copy(g, f))
+    f.seek(0)
+    print(f.read(10))
+    f.close()
+
+# a write after reading everything buffered
+with open("testfile", "wb") as f:
+    f.write(bytes(range(256)) * 40)
+f = open("testfile", "r+b")
+f.read(1)
+f.read(8191)
+f.write(b"XY")
+f.close()
+print(size())
+f = open("testfile", "rb")
+f.seek(8190)
+print(f.read(4))
+f.close()
+f = open("testfile", "r+b", buffering=16)
+print(f.read(16))
+f.write(b"XY")
+f.close()
+f = open("testfile", "rb")
+print(f.read(20), size())
+f.close()
+
+os.unlink("testfile")
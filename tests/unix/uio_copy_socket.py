@@ -0,0 +1,48 @@
+# test uio.copy between files and sockets
+try:
+    import uio as io
+    import uos as os
+    import usocket as socket
+    io.copy
+except (ImportError, AttributeError):
+    print("SKIP")
+    raise SystemExit
+
+addr = socket.getaddrinfo("127.0.0.1", 8130)[0][-1]
+s = socket.socket()
+s.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+s.bind(addr)
+s.listen(1)
+a = socket.socket()
+a.connect(addr)
+b = s.accept()[0]
+
+with open("io/data/bigfile1", "rb") as f:
+    data = f.read()
+
+# file to socket
+with open("io/data/bigfile1", "rb") as f:
+    print(io.copy(f, a, 3000))
+# socket to file
+with open("testfile", "wb") as g:
+    print(io.copy(b, g, 3000))
+with open("testfile", "rb") as g:
+    print(g.read() == data[:3000])
+os.unlink("testfile")
+
+# socket to socket, up to EOF
+a.write(b"abc")
+a.close()
+c = io.BytesIO()
+print(io.copy(b, c, bufsize=2), c.getvalue())
+b.close()
+s.close()
+
+# a non-blocking source that has no data
+
+a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+a.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+a.bind(addr)
+a.setblocking(False)
+print(io.copy(a, c))
+a.close()
@@ -0,0 +1,76 @@
+# test the generic uselect.poll with streams that notify it of readiness changes
+try:
+    stest_notify
+    import _uselect_generic as select
+except (NameError, ImportError):
+    print("SKIP")
+    raise SystemExit
+
+objs = [stest_notify() for i in range(100)]
+p = select.poll()
+for o in objs:
+    p.register(o, select.POLLIN)
+print(p.poll(0))
+
+def show(res):
+    print(sorted([(objs.index(o), ev) for o, ev in res]))
+
+# ready objects stay ready until they say otherwise
+objs[7].set_ready(select.POLLIN | select.POLLOUT)
+objs[42].set_ready(select.POLLIN)
+show(p.poll(0))
+show(p.poll(0))
+objs[7].set_ready(0)
+show(p.poll(0))
+
+# modify and register again
+objs[42].set_ready(select.POLLOUT)
+show(p.poll(0))
+p.modify(objs[42], select.POLLOUT)
+show(p.poll(0))
+p.register(objs[42], select.POLLIN)
+show(p.poll(0))
+objs[42].set_ready(0)
+
+# one-shot
+objs[3].set_ready(select.POLLIN)
+show(p.ipoll(0, 1))
+show(p.ipoll(0, 1))
+p.modify(objs[3], select.POLLIN)
+show(p.ipoll(0, 1))
+
+# unregistering an object that is yet to be returned by ipoll
+objs[3].set_ready(select.POLLIN)
+objs[4].set_ready(select.POLLIN)
+res = []
+for o, ev in p.ipoll(0):
+    res.append((o, ev))
+    p.unregister(objs[4] if o is objs[3] else objs[3])
+print(len(res))
+objs[3].set_ready(0)
+objs[4].set_ready(0)
+print(p.poll(0))
+
+# a second poller takes over the notifier, and the first polls the stream again
+p2 = select.poll()
+p2.register(objs[5], select.POLLIN)
+objs[5].set_ready(select.POLLIN)
+show(p.poll(0))
+show(p2.poll(0))
+objs[5].set_ready(0)
+show(p.poll(0))
+objs[5].set_ready(select.POLLIN)
+show(p.poll(0))
+objs[5].set_ready(0)
+
+# woken up by another thread
+try:
+    import _thread, utime
+except ImportError:
+    print([(9, 1)])
+else:
+    def wake():
+        utime.sleep_ms(20)
+        objs[9].set_ready(select.POLLIN)
+    _thread.start_new_thread(wake, ())
+    show(p.poll(5000))
@@ -0,0 +1,56 @@
+# test socket recv_many and send_many
+try:
+    import usocket as socket
+except ImportError:
+    print("SKIP")
+    raise SystemExit
+
+if not hasattr(socket.socket, 'recv_many'):
+    print("SKIP")
+    raise SystemExit
+
+addr = socket.getaddrinfo('127.0.0.1', 8129)[0][-1]
+a = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+a.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+a.bind(addr)
+b = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+
+# to given addresses, and more than one batch of the syscalls
+msgs = [b'%d' % i * (i % 4) for i in range(20)]
+print(b.send_many(msgs, [addr] * 20))
+bufs = [bytearray(4) for i in range(25)]
+sizes = [None] * 25
+addrs = [bytearray(16) for i in range(25)]
+print(a.recv_many(bufs, sizes, addrs))
+print(bufs[:5])
+print(sizes)
+print(socket.sockaddr(addrs[0])[0] == socket.AF_INET, addrs[19] == addrs[0])
+
+# address lengths, with a truncated address
+print(b.send_many([b'a', b'b'], [addr] * 2))
+addrs = [bytearray(16), bytearray(4)]
+addr_sizes = [None] * 2
+print(a.recv_many([bytearray(1), bytearray(1)], None, addrs, addr_sizes))
+print(addr_sizes, addrs[1] == addrs[0][:4])
+
+# to the connected address, with only buffers given
+b.connect(addr)
+print(b.send_many([b'abc', memoryview(b'xdefx')[1:4]]))
+bufs = [bytearray(2), bytearray(8), bytearray(8)]
+a.setblocking(False)
+print(a.recv_many(bufs))
+print(bufs)
+try:
+    a.recv_many(bufs)
+except OSError as e:
+    print('OSError')
+
+# bad arguments
+for args in ((bufs, [0]), (bufs, (0, 0, 0)), ([1], None)):
+    try:
+        a.recv_many(*args)
+    except (TypeError, ValueError) as e:
+        print(type(e).__name__)
+
+a.close()
+b.close()